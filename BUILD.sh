@@ -15,19 +15,67 @@ memcheck=''
 # memcheck='valgrind'
 # memcheck='valgrind --leak-check=full'
 
+# thresholds measured by `./BUILD.sh tune` on this machine, which replace the portable defaults until deleted
+if [ -f build/tune/tuned_thresholds.h ]; then
+  flags_include="$flags_include -I build/tune -DBL_TUNED"
+fi
+
+# instrumentation counters (see `src/stats.h`), which cost time in every entry point, so are only kept on request
+if [ -n "$BL_STATS" ]; then
+  flags_include="$flags_include -DBL_STATS"
+fi
+
 difftool='diff'
 if command -v icdiff 2>&1 >/dev/null; then difftool=icdiff; fi
 
+# common translation units
+mkdir -p build
+$mkObj $flags_language $flags_optimize $flags_include \
+  -o build/stats.o \
+  src/stats.c $flags_link
+
 # core translation units
 mkdir -p build/core
 $mkObj $flags_language $flags_optimize $flags_include \
   -o build/core/bn.o \
   src/core/bn.c $flags_link
 
+$mkObj $flags_language $flags_optimize $flags_include \
+  -o build/core/kernels.o \
+  src/core/kernels.c $flags_link
+
 $mkObj $flags_language $flags_optimize $flags_include \
   -o build/core/bz.o \
   src/core/bz.c $flags_link
 
+$mkObj $flags_language $flags_optimize $flags_include \
+  -o build/core/bq.o \
+  src/core/bq.c $flags_link
+
+$mkObj $flags_language $flags_optimize $flags_include \
+  -o build/core/pool.o \
+  src/core/pool.c $flags_link
+
+$mkObj $flags_language $flags_optimize $flags_include \
+  -o build/core/br.o \
+  src/core/br.c $flags_link
+
+$mkObj $flags_language $flags_optimize $flags_include \
+  -o build/core/bd.o \
+  src/core/bd.c $flags_link
+
+$mkObj $flags_language $flags_optimize $flags_include \
+  -o build/core/batch.o \
+  src/core/batch.c $flags_link
+
+$mkObj $flags_language $flags_optimize $flags_include \
+  -o build/core/compact.o \
+  src/core/compact.c $flags_link
+
+$mkObj $flags_language $flags_optimize $flags_include \
+  -o build/core/expr.o \
+  src/core/expr.c $flags_link
+
 # basic translation units
 mkdir -p build/basic
 $mkObj $flags_language $flags_optimize $flags_include \
@@ -39,10 +87,42 @@ $mkObj $flags_language $flags_optimize $flags_include \
   -o build/basic/bz.o \
   src/basic/bz.c $flags_link
 
+$mkObj $flags_language $flags_optimize $flags_include \
+  -o build/basic/bq.o \
+  src/basic/bq.c $flags_link
+
+$mkObj $flags_language $flags_optimize $flags_include \
+  -o build/basic/pool.o \
+  src/basic/pool.c $flags_link
+
+$mkObj $flags_language $flags_optimize $flags_include \
+  -o build/basic/br.o \
+  src/basic/br.c $flags_link
+
+$mkObj $flags_language $flags_optimize $flags_include \
+  -o build/basic/bd.o \
+  src/basic/bd.c $flags_link
+
+$mkObj $flags_language $flags_optimize $flags_include \
+  -o build/basic/batch.o \
+  src/basic/batch.c $flags_link
+
+$mkObj $flags_language $flags_optimize $flags_include \
+  -o build/basic/workers.o \
+  src/basic/workers.c $flags_link
+
+$mkObj $flags_language $flags_optimize $flags_include \
+  -o build/basic/compact.o \
+  src/basic/compact.c $flags_link
+
+$mkObj $flags_language $flags_optimize $flags_include \
+  -o build/basic/expr.o \
+  src/basic/expr.c $flags_link
+
 # tests
 $mkExe $flags_language $flags_include \
   -o test/run_bn_ \
-  test/test_bn_.c build/core/bn.o
+  test/test_bn_.c build/stats.o build/core/bn.o build/core/kernels.o
 $memcheck ./test/run_bn_ > test/actual_bn_.txt
 if ! diff -q test/expected_bn_.txt test/actual_bn_.txt; then
   $difftool test/expected_bn_.txt test/actual_bn_.txt
@@ -51,16 +131,133 @@ fi
 
 $mkExe $flags_language $flags_include \
   -o test/run_bz \
-  test/test_bz.c build/core/bn.o build/basic/bn.o build/basic/bz.o
+  test/test_bz.c build/stats.o build/core/bn.o build/core/kernels.o build/core/bz.o build/basic/bn.o build/basic/bz.o -pthread
 $memcheck ./test/run_bz > test/actual_bz.txt
 if ! diff -q test/expected_bz.txt test/actual_bz.txt; then
   $difftool test/expected_bz.txt test/actual_bz.txt
   exit 1
 fi
 
+$mkExe $flags_language $flags_include \
+  -o test/run_bq \
+  test/test_bq.c build/stats.o build/core/bn.o build/core/kernels.o build/core/bz.o build/core/bq.o build/basic/bn.o build/basic/bz.o build/basic/bq.o -pthread
+$memcheck ./test/run_bq > test/actual_bq.txt
+if ! diff -q test/expected_bq.txt test/actual_bq.txt; then
+  $difftool test/expected_bq.txt test/actual_bq.txt
+  exit 1
+fi
+
+$mkExe $flags_language $flags_include \
+  -o test/run_pool \
+  test/test_pool.c build/stats.o build/core/bn.o build/core/kernels.o build/core/bz.o build/core/pool.o build/basic/bn.o build/basic/bz.o build/basic/pool.o -pthread
+$memcheck ./test/run_pool > test/actual_pool.txt
+if ! diff -q test/expected_pool.txt test/actual_pool.txt; then
+  $difftool test/expected_pool.txt test/actual_pool.txt
+  exit 1
+fi
+
+$mkExe $flags_language $flags_include \
+  -o test/run_br \
+  test/test_br.c build/stats.o build/core/bn.o build/core/kernels.o build/core/bz.o build/core/br.o build/basic/bn.o build/basic/bz.o build/basic/br.o -pthread
+$memcheck ./test/run_br > test/actual_br.txt
+if ! diff -q test/expected_br.txt test/actual_br.txt; then
+  $difftool test/expected_br.txt test/actual_br.txt
+  exit 1
+fi
+
+$mkExe $flags_language $flags_include \
+  -o test/run_bd \
+  test/test_bd.c build/stats.o build/core/bn.o build/core/kernels.o build/core/bd.o build/basic/bn.o build/basic/bd.o -pthread
+$memcheck ./test/run_bd > test/actual_bd.txt
+if ! diff -q test/expected_bd.txt test/actual_bd.txt; then
+  $difftool test/expected_bd.txt test/actual_bd.txt
+  exit 1
+fi
+
+$mkExe $flags_language $flags_include \
+  -o test/run_batch \
+  test/test_batch.c build/stats.o build/core/bn.o build/core/kernels.o build/core/bz.o build/core/batch.o build/basic/bn.o build/basic/bz.o build/basic/batch.o -pthread
+$memcheck ./test/run_batch > test/actual_batch.txt
+if ! diff -q test/expected_batch.txt test/actual_batch.txt; then
+  $difftool test/expected_batch.txt test/actual_batch.txt
+  exit 1
+fi
+
+$mkExe $flags_language $flags_include \
+  -o test/run_workers \
+  test/test_workers.c build/stats.o build/core/bn.o build/core/kernels.o build/basic/bn.o build/basic/workers.o -pthread
+$memcheck ./test/run_workers > test/actual_workers.txt
+if ! diff -q test/expected_workers.txt test/actual_workers.txt; then
+  $difftool test/expected_workers.txt test/actual_workers.txt
+  exit 1
+fi
+
+$mkExe $flags_language $flags_include \
+  -o test/run_compact \
+  test/test_compact.c build/stats.o build/core/bn.o build/core/kernels.o build/core/bz.o build/core/compact.o build/basic/bn.o build/basic/bz.o build/basic/compact.o -pthread
+$memcheck ./test/run_compact > test/actual_compact.txt
+if ! diff -q test/expected_compact.txt test/actual_compact.txt; then
+  $difftool test/expected_compact.txt test/actual_compact.txt
+  exit 1
+fi
+
+$mkExe $flags_language $flags_include \
+  -o test/run_expr \
+  test/test_expr.c build/stats.o build/core/bn.o build/core/kernels.o build/core/bz.o build/core/expr.o build/basic/bn.o build/basic/bz.o build/basic/expr.o -pthread
+$memcheck ./test/run_expr > test/actual_expr.txt
+if ! diff -q test/expected_expr.txt test/actual_expr.txt; then
+  $difftool test/expected_expr.txt test/actual_expr.txt
+  exit 1
+fi
+
+if [ -n "$BL_STATS" ]; then
+  $mkExe $flags_language $flags_include \
+    -o test/run_stats \
+    test/test_stats.c build/stats.o build/core/bn.o build/core/kernels.o build/core/bz.o build/core/batch.o build/basic/bn.o build/basic/bz.o build/basic/batch.o -pthread
+  $memcheck ./test/run_stats > test/actual_stats.txt
+  if ! diff -q test/expected_stats.txt test/actual_stats.txt; then
+    $difftool test/expected_stats.txt test/actual_stats.txt
+    exit 1
+  fi
+fi
+
+# benchmarks
+$mkExe $flags_language $flags_optimize $flags_include \
+  -o bench/run_bench \
+  bench/bench.c build/*.o build/core/*.o build/basic/*.o -pthread
+$mkExe $flags_language $flags_optimize $flags_include \
+  -o bench/run_replay \
+  bench/replay.c build/*.o build/core/*.o build/basic/*.o -pthread
+$mkExe $flags_language $flags_optimize $flags_include \
+  -o bench/run_tune \
+  bench/tune.c build/stats.o build/core/bn.o build/core/kernels.o
+if [ "$1" = bench ]; then
+  shift
+  ./bench/run_bench "$@" | tee bench/results.csv
+  mkdir -p build/bench
+  ./bench/run_replay generate 100000 > build/bench/literals.trace
+  ./bench/run_replay build/bench/literals.trace | tee bench/results-replay.csv
+fi
+
 mkdir -p 'build/doc'
 pandoc -o 'build/doc/index.html' \
   'doc/index.rst' \
   'doc/basic/bn.rst' \
   'doc/basic/bz.rst' \
+  'doc/basic/bq.rst' \
+  'doc/basic/pool.rst' \
+  'doc/basic/batch.rst' \
+  'doc/basic/workers.rst' \
+  'doc/basic/compact.rst' \
+  'doc/basic/expr.rst' \
+  'doc/basic/br.rst' \
+  'doc/basic/bd.rst' \
+  'doc/basic/stats.rst' \
   'doc/basic/meta.rst'
+
+# tuning sets the thresholds at runtime, so it does not matter which the library was built with
+if [ "$1" = tune ]; then
+  mkdir -p build/tune
+  ./bench/run_tune build/tune/tuned_thresholds.h
+  exec "$0"
+fi
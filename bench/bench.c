@@ -0,0 +1,316 @@
+// Benchmarks for the core and basic operations.
+//
+// Usage: run_bench [filter [maxBytes]]
+//
+// Every operation whose name contains `filter` is timed over operands of 1 byte up to `maxBytes` (default 1 MiB),
+// quadrupling the size each time, and the results are written to standard output as CSV:
+//
+//   op,bytes,iters,ns_per_op,bytes_per_op
+//
+// `bytes` is the length of each operand (dividends are twice as long, so that quotients are as long as divisors).
+// `bytes_per_op` is the memory taken by the results and scratch space of one operation:
+// the core needs the caller to provide it, and the basic layer allocates it afresh every time.
+// Each measurement repeats the operation until it has run for at least `MIN_NS`;
+// once an operation takes longer than `MAX_NS`, its larger sizes are skipped (quadratic algorithms would take hours).
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "basic/bz.h"
+#include "core/bn.h"
+
+#define MIN_NS 2e7
+#define MAX_NS 2e8
+
+// The multiplier of the multiply-accumulate benchmarks: the largest power of ten in a word, as a decimal parser folds in.
+#define SCALE UINT64_C(10000000000000000000)
+
+// Return the time in nanoseconds.
+// This is an integer because a double only has a resolution of some hundreds of nanoseconds at the present epoch.
+static uint64_t now(void) {
+  struct timespec t;
+  timespec_get(&t, TIME_UTC);
+  return (uint64_t)t.tv_sec * 1000000000 + t.tv_nsec;
+}
+
+static bn_* alloc(size_t nDigits) {
+  bn_* out = aligned_alloc(sizeof(bn_), (sizeof(bn_) + nDigits + sizeof(bn_) - 1) / sizeof(bn_) * sizeof(bn_));
+  assert(out != NULL);
+  out->len = nDigits;
+  return out;
+}
+
+// Return a number of exactly `len` digits, whose top bit is `top`.
+static bn_* randomBn(size_t len, bool top, uint64_t* seed) {
+  bn_* out = alloc(len);
+  for (size_t i = 0; i < len; ++i) {
+    *seed = *seed * UINT64_C(6364136223846793005) + UINT64_C(1442695040888963407);
+    out->base256le[i] = *seed >> 56;
+  }
+  out->base256le[len - 1] = top ? out->base256le[len - 1] | 0x80 : (out->base256le[len - 1] & 0x7F) | 0x40;
+  return out;
+}
+
+// The operands for every benchmark of one size, and space for their results.
+typedef struct fixture {
+  bn_* a; // `len` digits, greater than `b`
+  bn_* b; // `len` digits
+  bn_* aCopy; // equal to `a`, so comparisons scan every digit
+  bn_* n; // `2len` digits, the dividend
+  bn_* dst; // `2len + 8` digits, for any single result
+  bn_* dst2;
+  bn_* scratch;
+  bz za[2]; // `n` and `-n`
+  bz zb[2]; // `b` and `-b`
+  size_t len;
+  size_t dstLen;
+  volatile int sink;
+} fixture;
+
+static void setup(fixture* f, size_t len) {
+  uint64_t seed = len;
+  f->len = len;
+  f->a = randomBn(len, true, &seed);
+  f->b = randomBn(len, false, &seed);
+  f->aCopy = alloc(len);
+  bn__copy(f->aCopy, f->a);
+  f->n = randomBn(2 * len, true, &seed);
+  f->dstLen = 2 * len + 8;
+  f->dst = alloc(f->dstLen);
+  f->dst2 = alloc(f->dstLen);
+  bn__blank(f->dst);
+  f->scratch = alloc(bn__sizeof_karatsuba_scratch(f->a, f->b, NULL));
+  f->za[0] = bz_positive(f->n);
+  f->za[1] = bz_negative(f->n);
+  f->zb[0] = bz_positive(f->b);
+  f->zb[1] = bz_negative(f->b);
+}
+
+static void teardown(fixture* f) {
+  free(f->a);
+  free(f->b);
+  free(f->aCopy);
+  free(f->n);
+  free(f->dst);
+  free(f->dst2);
+  free(f->scratch);
+  for (int i = 0; i < 2; ++i) {
+    bz_free(f->za[i]);
+    bz_free(f->zb[i]);
+  }
+}
+
+// Reset a destination to its full length and blank it, as the core multiplication and division require.
+static bn_* blank(bn_* dst, size_t len) {
+  dst->len = len;
+  bn__blank(dst);
+  return dst;
+}
+
+////// Core //////
+
+// Each benchmark performs one operation, and returns the bytes of results and scratch space it used.
+
+static size_t core_add(fixture* f) {
+  f->dst->len = bn__sizeof_add(f->a, f->b);
+  bn__add(f->dst, f->a, f->b);
+  return f->dst->len;
+}
+
+static size_t core_sub(fixture* f) {
+  f->dst->len = bn__sizeof_sub(f->a, f->b);
+  bn__sub(f->dst, f->a, f->b);
+  return f->dst->len;
+}
+
+static size_t core_mul(fixture* f) {
+  bn__mul(blank(f->dst, bn__sizeof_mul(f->a, f->b)), f->a, f->b);
+  return f->dst->len;
+}
+
+static size_t core_addmul_1(fixture* f) {
+  f->dst->len = bn__sizeof_addmul_1(f->b, f->a, SCALE);
+  bn__copy(f->dst, f->b);
+  bn__addmul_1(f->dst, f->a, SCALE);
+  return f->dst->len;
+}
+
+static size_t core_fma(fixture* f) {
+  f->dst->len = bn__sizeof_fma(f->a, f->b, f->b);
+  bn__fma(f->dst, f->a, f->b, f->b);
+  return f->dst->len;
+}
+
+static size_t core_karatsuba(fixture* f) {
+  f->dst->len = bn__sizeof_mul(f->a, f->b);
+  bn__karatsuba(f->dst, f->a, f->b, f->scratch, NULL);
+  return f->dst->len + bn__sizeof_karatsuba_scratch(f->a, f->b, NULL);
+}
+
+static size_t core_divmod(fixture* f) {
+  bn_* q = blank(f->dst, bn__sizeof_div(f->n, f->b));
+  bn_* r = blank(f->dst2, bn__sizeof_mod(f->n, f->b));
+  bn__divmod(q, r, f->n, f->b);
+  return q->len + r->len;
+}
+
+static size_t core_shl(fixture* f) {
+  // shifting in place, so only the length need be reset
+  f->dst->len = f->len + 2;
+  bn__shl(f->dst, 13);
+  return 0;
+}
+
+static size_t core_shr(fixture* f) {
+  f->dst->len = f->len + 2;
+  bn__shr(f->dst, 13);
+  return 0;
+}
+
+static size_t core_cmp(fixture* f) {
+  f->sink += bn__cmp(f->a, f->aCopy);
+  return 0;
+}
+
+////// Basic //////
+
+static size_t basic_add(fixture* f) {
+  bn* c = bn_add(f->a, f->b);
+  size_t out = bn__sizeof_add(f->a, f->b);
+  bn_free(c);
+  return out;
+}
+
+static size_t basic_sub(fixture* f) {
+  bn* c = bn_sub(f->a, f->b);
+  size_t out = bn__sizeof_sub(f->a, f->b);
+  bn_free(c);
+  return out;
+}
+
+static size_t basic_mul(fixture* f) {
+  bn* c = bn_mul(f->a, f->b);
+  size_t out = bn__sizeof_mul(f->a, f->b) + bn__sizeof_karatsuba_scratch(f->a, f->b, NULL);
+  bn_free(c);
+  return out;
+}
+
+static size_t basic_addMul1(fixture* f) {
+  bn* c = bn_addMul1(f->b, f->a, SCALE);
+  size_t out = bn__sizeof_addmul_1(f->b, f->a, SCALE);
+  bn_free(c);
+  return out;
+}
+
+static size_t basic_fma(fixture* f) {
+  bn* c = bn_fma(f->a, f->b, f->b);
+  size_t out = bn__sizeof_fma(f->a, f->b, f->b);
+  bn_free(c);
+  return out;
+}
+
+static size_t basic_divmod(fixture* f) {
+  struct bn_divmod c = bn_divmod(f->n, f->b);
+  size_t out = bn__sizeof_div(f->n, f->b) + bn__sizeof_mod(f->n, f->b);
+  bn_free(c.div);
+  bn_free(c.mod);
+  return out;
+}
+
+static size_t basic_shl(fixture* f) {
+  bn* c = bn_shl(f->a, 13);
+  bn_free(c);
+  return f->len + 2;
+}
+
+static size_t basic_shr(fixture* f) {
+  bn* c = bn_shr(f->a, 13);
+  bn_free(c);
+  return f->len;
+}
+
+static size_t basic_cmp(fixture* f) {
+  f->sink += bn_cmp(f->a, f->aCopy);
+  return 0;
+}
+
+// Divide with the signs given by the bits of `signs`: bit 1 for the dividend, and bit 0 for the divisor.
+static size_t bzDivmod(fixture* f, int signs) {
+  struct bz_divmod c = bz_divmod(f->za[signs >> 1], f->zb[signs & 1]);
+  size_t out = c.div.magnitude->len + c.mod.magnitude->len;
+  bz_free(c.div);
+  bz_free(c.mod);
+  return out;
+}
+
+static size_t basic_bz_divmod_pp(fixture* f) { return bzDivmod(f, 0); }
+static size_t basic_bz_divmod_pn(fixture* f) { return bzDivmod(f, 1); }
+static size_t basic_bz_divmod_np(fixture* f) { return bzDivmod(f, 2); }
+static size_t basic_bz_divmod_nn(fixture* f) { return bzDivmod(f, 3); }
+
+typedef struct benchmark {
+  const char* name;
+  size_t (*run)(fixture* f);
+} benchmark;
+
+static const benchmark benchmarks[] = {
+  { "bn__add", core_add },
+  { "bn__sub", core_sub },
+  { "bn__mul", core_mul },
+  { "bn__addmul_1", core_addmul_1 },
+  { "bn__fma", core_fma },
+  { "bn__karatsuba", core_karatsuba },
+  { "bn__divmod", core_divmod },
+  { "bn__shl", core_shl },
+  { "bn__shr", core_shr },
+  { "bn__cmp", core_cmp },
+  { "bn_add", basic_add },
+  { "bn_sub", basic_sub },
+  { "bn_mul", basic_mul },
+  { "bn_addMul1", basic_addMul1 },
+  { "bn_fma", basic_fma },
+  { "bn_divmod", basic_divmod },
+  { "bn_shl", basic_shl },
+  { "bn_shr", basic_shr },
+  { "bn_cmp", basic_cmp },
+  { "bz_divmod(+,+)", basic_bz_divmod_pp },
+  { "bz_divmod(+,-)", basic_bz_divmod_pn },
+  { "bz_divmod(-,+)", basic_bz_divmod_np },
+  { "bz_divmod(-,-)", basic_bz_divmod_nn },
+};
+
+#define N_BENCHMARKS (sizeof(benchmarks) / sizeof(benchmarks[0]))
+
+int main(int argc, char** argv) {
+  const char* filter = argc > 1 ? argv[1] : "";
+  size_t maxBytes = argc > 2 ? strtoull(argv[2], NULL, 10) : (size_t)1 << 20;
+  bool done[N_BENCHMARKS] = { false };
+  printf("op,bytes,iters,ns_per_op,bytes_per_op\n");
+  for (size_t len = 1; len <= maxBytes; len *= 4) {
+    fixture f;
+    setup(&f, len);
+    for (size_t i = 0; i < N_BENCHMARKS; ++i) {
+      const benchmark* b = &benchmarks[i];
+      if (done[i] || strstr(b->name, filter) == NULL) { continue; }
+      // the first run warms the caches, and tells how long a run takes
+      uint64_t t0 = now();
+      size_t bytes = b->run(&f);
+      uint64_t t = now() - t0;
+      size_t iters = 1;
+      if (t < MIN_NS) {
+        iters = t == 0 ? 1000000 : (size_t)(MIN_NS / t) + 1;
+        t0 = now();
+        for (size_t j = 0; j < iters; ++j) { b->run(&f); }
+        t = now() - t0;
+      }
+      printf("%s,%zu,%zu,%.1f,%zu\n", b->name, len, iters, (double)t / iters, bytes);
+      fflush(stdout);
+      done[i] = (double)t / iters > MAX_NS;
+    }
+    teardown(&f);
+  }
+  return 0;
+}
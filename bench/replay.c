@@ -0,0 +1,732 @@
+// Replay a trace of the literal operations a compiler performs, against each user-level interface.
+//
+// Usage: run_replay generate nOps [seed]
+//        run_replay trace [interface]
+//
+// A trace is a text file of one operation per line; blank lines and lines starting with `#` are ignored.
+// Operations read and write numbered registers, which all start out as zero.
+//
+//   lit r radix digits    parse the literal `digits` (with an optional leading `-`) in `radix` into register `r`
+//   add r a b             and likewise sub, mul, div, mod, and, or, xor: fold `a op b` into `r`
+//   shl r a amt           and likewise shr: fold `a` shifted by `amt` bits into `r`
+//   neg r a               fold `-a` into `r`
+//   fits a width          check whether `a` fits a two's-complement type of `width` (at most 16) bytes
+//   print a radix         write `a` out in `radix`
+//
+// Division by zero is checked before folding, as a compiler would, and leaves the destination unchanged.
+//
+// `generate` writes a synthetic trace to standard output:
+// mostly literals of a few digits, with a long tail of huge ones, folded together in short expressions.
+//
+// Replaying writes one CSV row per interface and kind of operation (`parse`, `fold`, `check` and `print`),
+// and one with the kind `all` for the whole trace:
+//
+//   interface,kind,count,ops_per_s,p50_ns,p99_ns,peak_rss_kb
+//
+// The latency of an operation includes reading the clock, which costs some tens of nanoseconds.
+// The peak resident set size is that of the whole process so far, trace included;
+// name an interface to replay it alone in a fresh process, so that it is not charged for earlier interfaces.
+
+#if defined(__unix__) || defined(__APPLE__)
+#define _POSIX_C_SOURCE 200809L
+#define BL_REPLAY_RUSAGE 1
+#else
+#define BL_REPLAY_RUSAGE 0
+#endif
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "basic/bz.h"
+#include "basic/compact.h"
+#include "basic/expr.h"
+
+#if BL_REPLAY_RUSAGE
+#include <sys/resource.h>
+#endif
+
+// Return the time in nanoseconds.
+// This is an integer because a double only has a resolution of some hundreds of nanoseconds at the present epoch.
+static uint64_t now(void) {
+  struct timespec t;
+  timespec_get(&t, TIME_UTC);
+  return (uint64_t)t.tv_sec * 1000000000 + t.tv_nsec;
+}
+
+static long peakRssKb(void) {
+#if BL_REPLAY_RUSAGE
+  struct rusage r;
+  if (getrusage(RUSAGE_SELF, &r) != 0) { return 0; }
+#if defined(__APPLE__)
+  return r.ru_maxrss / 1024; // bytes, rather than kilobytes
+#else
+  return r.ru_maxrss;
+#endif
+#else
+  return 0;
+#endif
+}
+
+////// Traces //////
+
+typedef enum opcode {
+  OP_LIT,
+  OP_ADD, OP_SUB, OP_MUL, OP_DIV, OP_MOD, OP_AND, OP_OR, OP_XOR,
+  OP_SHL, OP_SHR, OP_NEG,
+  OP_FITS,
+  OP_PRINT,
+} opcode;
+
+static const char* const opNames[] = {
+  "lit",
+  "add", "sub", "mul", "div", "mod", "and", "or", "xor",
+  "shl", "shr", "neg",
+  "fits",
+  "print",
+};
+
+#define N_OPCODES (sizeof(opNames) / sizeof(opNames[0]))
+
+typedef enum kind { KIND_PARSE, KIND_FOLD, KIND_CHECK, KIND_PRINT, N_KINDS } kind;
+
+static const char* const kindNames[N_KINDS] = { "parse", "fold", "check", "print" };
+
+static kind kindOf(opcode op) {
+  switch (op) {
+    case OP_LIT: return KIND_PARSE;
+    case OP_FITS: return KIND_CHECK;
+    case OP_PRINT: return KIND_PRINT;
+    default: return KIND_FOLD;
+  }
+}
+
+typedef struct op {
+  opcode code;
+  size_t dst; // register written by `lit` and folds; read by `fits` and `print`
+  size_t a; // first operand; the radix of `lit` and `print`; the width of `fits`
+  size_t b; // second operand, or shift amount
+  const char* str; // the digits of `lit`, within the trace text
+  size_t len;
+} op;
+
+typedef struct trace {
+  char* text;
+  op* ops;
+  size_t nOps;
+  size_t nRegs;
+} trace;
+
+static bool parseSize(char** at, size_t* out) {
+  char* end;
+  unsigned long long n = strtoull(*at, &end, 10);
+  if (end == *at) { return false; }
+  *at = end;
+  *out = n;
+  return true;
+}
+
+static char* skipSpace(char* at) {
+  while (*at == ' ' || *at == '\t') { ++at; }
+  return at;
+}
+
+// Read the operation on the nul-terminated `line`, returning false if it is malformed.
+static bool parseOp(char* line, op* out) {
+  size_t nameLen = strcspn(line, " \t");
+  size_t code = 0;
+  while (code < N_OPCODES && !(strlen(opNames[code]) == nameLen && strncmp(opNames[code], line, nameLen) == 0)) { ++code; }
+  if (code == N_OPCODES) { return false; }
+  out->code = code;
+  char* at = line + nameLen;
+  switch (out->code) {
+    case OP_LIT:
+      if (!parseSize(&at, &out->dst) || !parseSize(&at, &out->a)) { return false; }
+      at = skipSpace(at);
+      out->str = at;
+      out->len = strcspn(at, " \t\r");
+      return out->len != 0 && 2 <= out->a && out->a <= 36;
+    case OP_FITS:
+      return parseSize(&at, &out->dst) && parseSize(&at, &out->a) && out->a <= 16;
+    case OP_PRINT:
+      return parseSize(&at, &out->dst) && parseSize(&at, &out->a) && 2 <= out->a && out->a <= 36;
+    case OP_NEG:
+      return parseSize(&at, &out->dst) && parseSize(&at, &out->a);
+    default:
+      return parseSize(&at, &out->dst) && parseSize(&at, &out->a) && parseSize(&at, &out->b);
+  }
+}
+
+static size_t maxRegister(const op* o) {
+  size_t out = o->dst;
+  if (OP_ADD <= o->code && o->code <= OP_NEG && o->a > out) { out = o->a; }
+  if (OP_ADD <= o->code && o->code <= OP_XOR && o->b > out) { out = o->b; }
+  return out;
+}
+
+static bool loadTrace(const char* path, trace* out) {
+  FILE* f = fopen(path, "rb");
+  if (f == NULL) { return false; }
+  size_t cap = 1 << 16, len = 0;
+  out->text = malloc(cap);
+  assert(out->text != NULL);
+  for (size_t n; (n = fread(out->text + len, 1, cap - len - 1, f)) != 0; ) {
+    len += n;
+    if (cap - len - 1 == 0) {
+      cap *= 2;
+      out->text = realloc(out->text, cap);
+      assert(out->text != NULL);
+    }
+  }
+  fclose(f);
+  out->text[len] = '\0';
+
+  size_t nLines = 1;
+  for (size_t i = 0; i < len; ++i) { nLines += out->text[i] == '\n'; }
+  out->ops = malloc(nLines * sizeof(op));
+  assert(out->ops != NULL);
+  out->nOps = 0;
+  out->nRegs = 0;
+  size_t lineNo = 0;
+  for (char* line = out->text; line != NULL; ) {
+    char* next = strchr(line, '\n');
+    if (next != NULL) { *next++ = '\0'; }
+    ++lineNo;
+    line = skipSpace(line);
+    if (*line != '\0' && *line != '#' && *line != '\r') {
+      op* o = &out->ops[out->nOps];
+      if (!parseOp(line, o)) {
+        fprintf(stderr, "%s:%zu: malformed operation\n", path, lineNo);
+        return false;
+      }
+      if (maxRegister(o) + 1 > out->nRegs) { out->nRegs = maxRegister(o) + 1; }
+      ++out->nOps;
+    }
+    line = next;
+  }
+  return true;
+}
+
+////// Generation //////
+
+static uint64_t rng;
+
+static uint64_t next(void) {
+  rng = rng * UINT64_C(6364136223846793005) + UINT64_C(1442695040888963407);
+  return rng >> 16;
+}
+
+static double uniform(void) {
+  return (next() & ((UINT64_C(1) << 48) - 1)) / (double)(UINT64_C(1) << 48);
+}
+
+// A number of digits, mostly tiny, with a long tail out to ten thousand.
+static size_t literalDigits(void) {
+  double u = uniform();
+  if (u < 0.70) { return 1 + next() % 2; }
+  if (u < 0.90) { return 3 + next() % 8; }
+  if (u < 0.98) { return 11 + next() % 30; }
+  if (u < 0.999) { return 41 + next() % 960; }
+  return 1000 + next() % 9001;
+}
+
+static unsigned literalRadix(void) {
+  double u = uniform();
+  return u < 0.80 ? 10 : u < 0.95 ? 16 : u < 0.99 ? 2 : 8;
+}
+
+// Registers form a ring, so that folds mostly combine recent values, as in the expressions of a program.
+#define GEN_REGS 256
+
+// Folds whose result would be longer than this many bits are replaced by additions, so that values do not snowball.
+#define GEN_MAX_BITS (1 << 16)
+
+// Dividends longer than this many bits are not divided, as the bit-serial division would swamp everything else.
+#define GEN_MAX_DIV_BITS 4096
+
+static int generate(size_t nOps, uint64_t seed) {
+  rng = seed;
+  size_t bits[GEN_REGS] = { 0 };
+  size_t top = 0; // the next register to write
+  size_t nWritten = 0;
+  printf("# generated by run_replay generate %zu %llu\n", nOps, (unsigned long long)seed);
+  for (size_t i = 0; i < nOps; ++i) {
+    double u = uniform();
+    size_t newest = (top + GEN_REGS - 1) % GEN_REGS;
+    if (u < 0.50 || nWritten < 2) {
+      size_t nDigits = literalDigits();
+      unsigned radix = literalRadix();
+      printf("lit %zu %u %s", top, radix, uniform() < 0.05 ? "-" : "");
+      for (size_t k = 0; k < nDigits; ++k) {
+        unsigned d = k == 0 && nDigits > 1 ? 1 + next() % (radix - 1) : next() % radix;
+        putchar("0123456789abcdef"[d]);
+      }
+      putchar('\n');
+      // an overestimate, which is all the size limits need
+      bits[top] = nDigits * (radix == 10 ? 4 : radix == 16 ? 4 : radix == 8 ? 3 : 1);
+    }
+    else if (u < 0.80) {
+      size_t depth = nWritten < 8 ? nWritten : 8;
+      size_t a = (top + GEN_REGS - 1 - next() % depth) % GEN_REGS;
+      size_t b = (top + GEN_REGS - 1 - next() % depth) % GEN_REGS;
+      size_t big = bits[a] > bits[b] ? bits[a] : bits[b];
+      double v = uniform();
+      opcode code = v < 0.30 ? OP_ADD : v < 0.50 ? OP_SUB : v < 0.70 ? OP_MUL : v < 0.75 ? OP_DIV : v < 0.80 ? OP_MOD
+        : v < 0.84 ? OP_AND : v < 0.87 ? OP_OR : v < 0.90 ? OP_XOR : v < 0.95 ? OP_SHL : v < 0.98 ? OP_SHR : OP_NEG;
+      if (code == OP_MUL && bits[a] + bits[b] > GEN_MAX_BITS) { code = OP_ADD; }
+      if ((code == OP_DIV || code == OP_MOD) && bits[a] > GEN_MAX_DIV_BITS) { code = OP_ADD; }
+      if (code == OP_SHL && big + 64 > GEN_MAX_BITS) { code = OP_SHR; }
+      size_t out = big + 1;
+      if (code == OP_MUL) { out = bits[a] + bits[b]; }
+      if (code == OP_DIV || code == OP_MOD || code == OP_NEG || code == OP_SHR) { out = bits[a]; }
+      if (code == OP_SHL || code == OP_SHR) {
+        b = next() % 65;
+        if (code == OP_SHL) { out = bits[a] + b; }
+        printf("%s %zu %zu %zu\n", opNames[code], top, a, b);
+      }
+      else if (code == OP_NEG) { printf("neg %zu %zu\n", top, a); }
+      else { printf("%s %zu %zu %zu\n", opNames[code], top, a, b); }
+      bits[top] = out;
+    }
+    else if (u < 0.92) {
+      static const unsigned widths[] = { 1, 2, 4, 8, 16 };
+      printf("fits %zu %u\n", newest, widths[next() % 5]);
+      continue;
+    }
+    else {
+      printf("print %zu %u\n", newest, uniform() < 0.9 ? 10 : 16);
+      continue;
+    }
+    top = (top + 1) % GEN_REGS;
+    ++nWritten;
+  }
+  return 0;
+}
+
+////// Interfaces //////
+
+// Each interface keeps its own registers in the context it opens.
+typedef struct interface {
+  const char* name;
+  void* (*open)(size_t nRegs);
+  void (*close)(void* ctx);
+  // Perform `o`, returning something derived from the result so that it cannot be optimized away.
+  size_t (*run)(void* ctx, const op* o);
+} interface;
+
+// Parse the literal of `o`, returning false if it is malformed.
+static bool parseLiteral(bz* dst, const op* o) {
+  bool isNeg = o->str[0] == '-';
+  bn* mag = bn_parse(o->str + isNeg, o->len - isNeg, o->a);
+  if (mag == NULL) { return false; }
+  *dst = isNeg ? bz_negative(mag) : bz_positive(mag);
+  bn_free(mag);
+  return true;
+}
+
+// Return whether `o` is a fold that would divide by zero.
+static bool dividesByZero(const op* o, bz y) {
+  return (o->code == OP_DIV || o->code == OP_MOD) && y.magnitude->len == 0;
+}
+
+// Fold `x op y` as `o` says; unary operations ignore `y`.
+static bz fold(const op* o, bz x, bz y) {
+  switch (o->code) {
+    case OP_ADD: return bz_add(x, y);
+    case OP_SUB: return bz_sub(x, y);
+    case OP_MUL: return bz_mul(x, y);
+    case OP_DIV: return bz_div(x, y);
+    case OP_MOD: return bz_mod(x, y);
+    case OP_AND: return bz_and(x, y);
+    case OP_OR: return bz_or(x, y);
+    case OP_XOR: return bz_xor(x, y);
+    case OP_SHL: return bz_shl(x, o->b);
+    case OP_SHR: return bz_shr(x, o->b);
+    case OP_NEG: return bz_neg(x);
+    default: break;
+  }
+  assert(false && "not a fold");
+  return bz_imax(0);
+}
+
+static bool isBinary(opcode code) {
+  return OP_ADD <= code && code <= OP_XOR;
+}
+
+// A buffer for printing, which grows as needed.
+typedef struct printBuf {
+  char* buf;
+  size_t len;
+} printBuf;
+
+static void printBufInit(printBuf* p) {
+  p->len = 64;
+  p->buf = malloc(p->len);
+  assert(p->buf != NULL);
+}
+
+// Write `src` out in `radix`, returning the number of characters written.
+static size_t printBz(printBuf* p, bz src, unsigned radix) {
+  size_t need = 1 + bn_sizeofFormat(src.magnitude, radix);
+  if (need > p->len) {
+    free(p->buf);
+    p->len = need;
+    p->buf = malloc(need);
+    assert(p->buf != NULL);
+  }
+  p->buf[0] = '-';
+  return src.isNeg + bn_format(p->buf + src.isNeg, p->len - src.isNeg, src.magnitude, radix);
+}
+
+static size_t fits(bz src, size_t width) {
+  uint8_t buf[16];
+  return bz_toTwosComplement(buf, width, src);
+}
+
+// The basic interface keeps every register as a `bz`.
+
+typedef struct basicCtx {
+  bz* regs;
+  size_t nRegs;
+  printBuf print;
+} basicCtx;
+
+static void* basicOpen(size_t nRegs) {
+  basicCtx* c = malloc(sizeof(basicCtx));
+  assert(c != NULL);
+  c->regs = malloc(nRegs * sizeof(bz));
+  assert(nRegs == 0 || c->regs != NULL);
+  for (size_t i = 0; i < nRegs; ++i) { c->regs[i] = bz_imax(0); }
+  c->nRegs = nRegs;
+  printBufInit(&c->print);
+  return c;
+}
+
+static void basicClose(void* ctx) {
+  basicCtx* c = ctx;
+  for (size_t i = 0; i < c->nRegs; ++i) { bz_free(c->regs[i]); }
+  free(c->regs);
+  free(c->print.buf);
+  free(c);
+}
+
+static size_t basicSet(basicCtx* c, size_t dst, bz src) {
+  bz_free(c->regs[dst]);
+  c->regs[dst] = src;
+  return src.magnitude->len;
+}
+
+static size_t basicRun(void* ctx, const op* o) {
+  basicCtx* c = ctx;
+  bz* r = c->regs;
+  switch (o->code) {
+    case OP_LIT: {
+      bz out;
+      return parseLiteral(&out, o) ? basicSet(c, o->dst, out) : 0;
+    }
+    case OP_FITS: return fits(r[o->dst], o->a);
+    case OP_PRINT: return printBz(&c->print, r[o->dst], o->a);
+    default: {
+      bz y = isBinary(o->code) ? r[o->b] : r[o->a];
+      if (dividesByZero(o, y)) { return 0; }
+      return basicSet(c, o->dst, fold(o, r[o->a], y));
+    }
+  }
+}
+
+// The compact interface keeps every register as a 16-byte handle, as a syntax tree would,
+// and folds by viewing the handles as `bz` and converting the result back.
+
+typedef struct compactCtx {
+  bl_compact* regs;
+  size_t nRegs;
+  printBuf print;
+} compactCtx;
+
+static void* compactOpen(size_t nRegs) {
+  compactCtx* c = malloc(sizeof(compactCtx));
+  assert(c != NULL);
+  // a handle whose bytes are all zero is zero
+  c->regs = calloc(nRegs, sizeof(bl_compact));
+  assert(nRegs == 0 || c->regs != NULL);
+  c->nRegs = nRegs;
+  printBufInit(&c->print);
+  return c;
+}
+
+static void compactClose(void* ctx) {
+  compactCtx* c = ctx;
+  for (size_t i = 0; i < c->nRegs; ++i) { bl_compactFree(c->regs[i]); }
+  free(c->regs);
+  free(c->print.buf);
+  free(c);
+}
+
+// Store a compact copy of `src` in register `dst`, and release `src`.
+static size_t compactSet(compactCtx* c, size_t dst, bz src) {
+  bl_compact out = bl_compactFromBz(src);
+  size_t len = src.magnitude->len;
+  bz_free(src);
+  bl_compactFree(c->regs[dst]);
+  c->regs[dst] = out;
+  return len;
+}
+
+static size_t compactRun(void* ctx, const op* o) {
+  compactCtx* c = ctx;
+  bl_compact* r = c->regs;
+  bl_compactView va, vb;
+  switch (o->code) {
+    case OP_LIT: {
+      bz out;
+      return parseLiteral(&out, o) ? compactSet(c, o->dst, out) : 0;
+    }
+    case OP_FITS: return fits(bl_compactBz(r[o->dst], &va), o->a);
+    case OP_PRINT: return printBz(&c->print, bl_compactBz(r[o->dst], &va), o->a);
+    default: {
+      bz x = bl_compactBz(r[o->a], &va);
+      bz y = isBinary(o->code) ? bl_compactBz(r[o->b], &vb) : x;
+      if (dividesByZero(o, y)) { return 0; }
+      // the views stay valid until the old value of `dst` is released, after folding
+      return compactSet(c, o->dst, fold(o, x, y));
+    }
+  }
+}
+
+// The expression interface does not fold as it goes: each fold adds a node to a `bl_expr`,
+// and a register is only evaluated when its value is needed (to check, print, or divide by it).
+// So a run of folds is evaluated in one planned arena rather than an allocation per intermediate.
+// The expression is restarted every `EXPR_NODES` nodes, so that planning stays cheap.
+
+#define EXPR_NODES 64
+
+#define NO_NODE SIZE_MAX
+
+typedef struct exprCtx {
+  bl_expr* e;
+  size_t nNodes;
+  size_t nRegs;
+  bz* vals; // the value of each register, owned by it, unless it is pending
+  size_t* nodes; // the node of each register in `e`, or `NO_NODE`
+  bool* pending; // whether the register is only known as its node, and has no value yet
+  bool* borrowed; // whether the value of the register is a leaf of `e`
+  bz* dead; // overwritten values that are still leaves of `e`
+  size_t nDead;
+  printBuf print;
+} exprCtx;
+
+static void* exprOpen(size_t nRegs) {
+  exprCtx* c = malloc(sizeof(exprCtx));
+  assert(c != NULL);
+  c->e = bl_exprNew();
+  c->nNodes = 0;
+  c->nRegs = nRegs;
+  c->vals = malloc(nRegs * sizeof(bz));
+  c->nodes = malloc(nRegs * sizeof(size_t));
+  c->pending = calloc(nRegs, sizeof(bool));
+  c->borrowed = calloc(nRegs, sizeof(bool));
+  // every node but the leaves retires at most one value
+  c->dead = malloc(EXPR_NODES * sizeof(bz));
+  assert(nRegs == 0 || (c->vals != NULL && c->nodes != NULL && c->pending != NULL && c->borrowed != NULL));
+  assert(c->dead != NULL);
+  for (size_t i = 0; i < nRegs; ++i) {
+    c->vals[i] = bz_imax(0);
+    c->nodes[i] = NO_NODE;
+  }
+  c->nDead = 0;
+  printBufInit(&c->print);
+  return c;
+}
+
+// Give register `r` its value, if it is pending.
+static bz exprValue(exprCtx* c, size_t r) {
+  if (c->pending[r]) {
+    c->vals[r] = bl_exprEval(c->e, c->nodes[r]);
+    c->pending[r] = false;
+    // later folds read the value as a leaf, rather than evaluating its node again
+    c->nodes[r] = NO_NODE;
+  }
+  return c->vals[r];
+}
+
+// Evaluate every pending register, and start a new expression.
+static void exprRestart(exprCtx* c) {
+  for (size_t i = 0; i < c->nRegs; ++i) {
+    exprValue(c, i);
+    c->nodes[i] = NO_NODE;
+    c->borrowed[i] = false;
+  }
+  for (size_t i = 0; i < c->nDead; ++i) { bz_free(c->dead[i]); }
+  c->nDead = 0;
+  bl_exprFree(c->e);
+  c->e = bl_exprNew();
+  c->nNodes = 0;
+}
+
+static void exprClose(void* ctx) {
+  exprCtx* c = ctx;
+  exprRestart(c);
+  for (size_t i = 0; i < c->nRegs; ++i) { bz_free(c->vals[i]); }
+  bl_exprFree(c->e);
+  free(c->vals);
+  free(c->nodes);
+  free(c->pending);
+  free(c->borrowed);
+  free(c->dead);
+  free(c->print.buf);
+  free(c);
+}
+
+// Return the node of register `r`, adding its value as a leaf if it has none.
+static size_t exprNode(exprCtx* c, size_t r) {
+  if (c->nodes[r] == NO_NODE) {
+    c->nodes[r] = bl_exprLeaf(c->e, c->vals[r]);
+    c->borrowed[r] = true;
+    ++c->nNodes;
+  }
+  return c->nodes[r];
+}
+
+// Release the value of register `r`, which is about to be overwritten.
+static void exprDrop(exprCtx* c, size_t r) {
+  if (c->pending[r]) { return; }
+  if (c->borrowed[r]) { c->dead[c->nDead++] = c->vals[r]; }
+  else { bz_free(c->vals[r]); }
+  c->borrowed[r] = false;
+}
+
+static size_t exprRun(void* ctx, const op* o) {
+  exprCtx* c = ctx;
+  switch (o->code) {
+    case OP_LIT: {
+      bz out;
+      if (!parseLiteral(&out, o)) { return 0; }
+      exprDrop(c, o->dst);
+      c->vals[o->dst] = out;
+      c->nodes[o->dst] = NO_NODE;
+      c->pending[o->dst] = false;
+      return out.magnitude->len;
+    }
+    case OP_FITS: return fits(exprValue(c, o->dst), o->a);
+    case OP_PRINT: return printBz(&c->print, exprValue(c, o->dst), o->a);
+    default: {
+      // a fold adds at most three nodes
+      if (c->nNodes + 3 > EXPR_NODES) { exprRestart(c); }
+      if ((o->code == OP_DIV || o->code == OP_MOD) && exprValue(c, o->b).magnitude->len == 0) { return 0; }
+      size_t a = exprNode(c, o->a);
+      size_t b = isBinary(o->code) ? exprNode(c, o->b) : a;
+      size_t out;
+      switch (o->code) {
+        case OP_ADD: out = bl_exprAdd(c->e, a, b); break;
+        case OP_SUB: out = bl_exprSub(c->e, a, b); break;
+        case OP_MUL: out = bl_exprMul(c->e, a, b); break;
+        case OP_DIV: out = bl_exprDiv(c->e, a, b); break;
+        case OP_MOD: out = bl_exprMod(c->e, a, b); break;
+        case OP_AND: out = bl_exprAnd(c->e, a, b); break;
+        case OP_OR: out = bl_exprOr(c->e, a, b); break;
+        case OP_XOR: out = bl_exprXor(c->e, a, b); break;
+        case OP_SHL: out = bl_exprShl(c->e, a, o->b); break;
+        case OP_SHR: out = bl_exprShr(c->e, a, o->b); break;
+        default: out = bl_exprNeg(c->e, a); break;
+      }
+      ++c->nNodes;
+      exprDrop(c, o->dst);
+      c->nodes[o->dst] = out;
+      c->pending[o->dst] = true;
+      return out;
+    }
+  }
+}
+
+static const interface interfaces[] = {
+  { "basic", basicOpen, basicClose, basicRun },
+  { "compact", compactOpen, compactClose, compactRun },
+  { "expr", exprOpen, exprClose, exprRun },
+};
+
+#define N_INTERFACES (sizeof(interfaces) / sizeof(interfaces[0]))
+
+////// Replay //////
+
+static int cmpDouble(const void* a, const void* b) {
+  double x = *(const double*)a, y = *(const double*)b;
+  return (x > y) - (x < y);
+}
+
+// Return the `p`th percentile of the `n` sorted latencies `xs` (nearest rank).
+static double percentile(const double* xs, size_t n, double p) {
+  if (n == 0) { return 0; }
+  size_t rank = (size_t)(p * n + 0.999999);
+  return xs[rank == 0 ? 0 : rank - 1];
+}
+
+static void report(const char* iface, const char* kind, double* ns, size_t n, double total, long rss) {
+  qsort(ns, n, sizeof(double), cmpDouble);
+  printf("%s,%s,%zu,%.0f,%.0f,%.0f,%ld\n",
+    iface, kind, n, total > 0 ? n / (total * 1e-9) : 0.0, percentile(ns, n, 0.50), percentile(ns, n, 0.99), rss);
+}
+
+static void replay(const interface* iface, const trace* t) {
+  double* ns = malloc((t->nOps + 1) * sizeof(double));
+  double* byKind = malloc((t->nOps + 1) * sizeof(double));
+  assert(ns != NULL && byKind != NULL);
+  volatile size_t sink = 0;
+
+  void* ctx = iface->open(t->nRegs);
+  uint64_t start = now();
+  for (size_t i = 0; i < t->nOps; ++i) {
+    uint64_t t0 = now();
+    sink += iface->run(ctx, &t->ops[i]);
+    ns[i] = now() - t0;
+  }
+  uint64_t wall = now() - start;
+  iface->close(ctx);
+  long rss = peakRssKb();
+
+  for (kind k = 0; k < N_KINDS; ++k) {
+    size_t n = 0;
+    double total = 0;
+    for (size_t i = 0; i < t->nOps; ++i) {
+      if (kindOf(t->ops[i].code) != k) { continue; }
+      byKind[n++] = ns[i];
+      total += ns[i];
+    }
+    report(iface->name, kindNames[k], byKind, n, total, rss);
+  }
+  report(iface->name, "all", ns, t->nOps, wall, rss);
+  fflush(stdout);
+  free(byKind);
+  free(ns);
+}
+
+int main(int argc, char** argv) {
+  if (argc >= 3 && strcmp(argv[1], "generate") == 0) {
+    return generate(strtoull(argv[2], NULL, 10), argc > 3 ? strtoull(argv[3], NULL, 10) : 1);
+  }
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s generate nOps [seed]\n       %s trace [interface]\n", argv[0], argv[0]);
+    return 2;
+  }
+  trace t;
+  if (!loadTrace(argv[1], &t)) {
+    fprintf(stderr, "%s: cannot read trace\n", argv[1]);
+    return 1;
+  }
+  const char* only = argc > 2 ? argv[2] : NULL;
+  size_t i = 0;
+  while (only != NULL && i < N_INTERFACES && strcmp(only, interfaces[i].name) != 0) { ++i; }
+  if (i == N_INTERFACES) {
+    fprintf(stderr, "%s: no such interface\n", only);
+    return 1;
+  }
+  printf("interface,kind,count,ops_per_s,p50_ns,p99_ns,peak_rss_kb\n");
+  for (; i < N_INTERFACES; ++i) {
+    replay(&interfaces[i], &t);
+    if (only != NULL) { break; }
+  }
+  free(t.ops);
+  free(t.text);
+  return 0;
+}
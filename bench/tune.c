@@ -0,0 +1,187 @@
+// Measure the algorithm thresholds of the core on this machine.
+//
+// Usage: run_tune [header]
+//
+// Writes `#define`s for the thresholds of `core/thresholds.h` to `header` (by default, standard output),
+// and prints them as a `bn_setThresholds` spec, so that a deployment host can also be tuned without recompiling.
+// `./BUILD.sh tune` runs this and rebuilds the library against the result.
+//
+// Each crossover is found the way GMP's tuneup finds its own: at every size, the operation is timed twice,
+// once with the threshold just above the size (so the simple algorithm runs)
+// and once with it at the size (so the fast algorithm runs one level, then hands back to the simple one).
+// The threshold is the first size at which the fast algorithm wins several sizes in a row.
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "core/bn.h"
+
+// Every measurement repeats the operation for at least this long, and the best of several measurements is kept.
+#define MIN_NS 2000000
+#define ROUNDS 5
+
+// The fast algorithm must win this many consecutive sizes before it is trusted.
+#define WINS 3
+
+static uint64_t now(void) {
+  struct timespec t;
+  timespec_get(&t, TIME_UTC);
+  return (uint64_t)t.tv_sec * 1000000000 + t.tv_nsec;
+}
+
+static bn_* alloc(size_t nDigits) {
+  bn_* out = aligned_alloc(sizeof(bn_), (sizeof(bn_) + nDigits + sizeof(bn_) - 1) / sizeof(bn_) * sizeof(bn_));
+  assert(out != NULL);
+  out->len = nDigits;
+  return out;
+}
+
+static uint64_t seed = 1;
+
+static bn_* randomWords(size_t nWords) {
+  bn_* out = alloc(8 * nWords);
+  for (size_t i = 0; i < out->len; ++i) {
+    seed = seed * UINT64_C(6364136223846793005) + UINT64_C(1442695040888963407);
+    out->base256le[i] = seed >> 56;
+  }
+  out->base256le[out->len - 1] |= 0x80;
+  return out;
+}
+
+// The operands of one measurement, and space for its results.
+typedef struct fixture {
+  bn_* a;
+  bn_* b;
+  bn_* dst;
+  bn_* scratch;
+  char* str;
+  size_t strLen;
+  size_t parseLen;
+} fixture;
+
+static void mul(fixture* f) {
+  f->dst->len = bn__sizeof_mul(f->a, f->b);
+  f->scratch->len = bn__sizeof_karatsuba_scratch(f->a, f->b, NULL);
+  bl_result err = bn__karatsuba(f->dst, f->a, f->b, f->scratch, NULL);
+  assert(err == BL_OK);
+}
+
+static void convert(fixture* f) {
+  size_t n;
+  f->scratch->len = bn__sizeof_format_scratch(f->a, 10, NULL);
+  bl_result err = bn__format(f->str, f->strLen, &n, f->a, 10, f->scratch, NULL);
+  assert(err == BL_OK);
+  f->dst->len = bn__sizeof_parse(f->parseLen, 10);
+  f->scratch->len = bn__sizeof_parse_scratch(f->parseLen, 10, NULL);
+  err = bn__parse(f->dst, f->str, f->parseLen, 10, f->scratch, NULL);
+  assert(err == BL_OK);
+}
+
+// Return the best time in nanoseconds of one `op(f)` under the thresholds `t`.
+static double measure(void (*op)(fixture*), fixture* f, bn__thresholds t) {
+  bn__set_thresholds(t);
+  double best = 0;
+  for (int round = 0; round < ROUNDS; ++round) {
+    size_t iters = 0;
+    uint64_t t0 = now(), elapsed;
+    do {
+      op(f);
+      ++iters;
+      elapsed = now() - t0;
+    } while (elapsed < MIN_NS);
+    double each = (double)elapsed / iters;
+    if (round == 0 || each < best) { best = each; }
+  }
+  return best;
+}
+
+// Set up `f` for operands of `n` words, with room for the scratch space of every threshold tried.
+static void setup(fixture* f, size_t n) {
+  f->a = randomWords(n);
+  f->b = randomWords(n);
+  f->dst = alloc(16 * n + 64);
+  f->strLen = bn__sizeof_format(f->a, 10);
+  f->str = malloc(f->strLen);
+  assert(f->str != NULL);
+  // parse the leading digits that fill exactly `n` chunks of 19 decimal digits, as the parsing threshold counts
+  f->parseLen = 19 * n;
+  bn__set_thresholds((bn__thresholds){ 4, 2, 2 });
+  size_t scratch = bn__sizeof_karatsuba_scratch(f->a, f->b, NULL);
+  if (bn__sizeof_format_scratch(f->a, 10, NULL) > scratch) { scratch = bn__sizeof_format_scratch(f->a, 10, NULL); }
+  if (bn__sizeof_parse_scratch(f->strLen, 10, NULL) > scratch) { scratch = bn__sizeof_parse_scratch(f->strLen, 10, NULL); }
+  // thresholds above the operand size need less scratch than any recursion, but may need the base-case minimum
+  f->scratch = alloc(scratch + 16 * n + 64);
+}
+
+static void teardown(fixture* f) {
+  free(f->a);
+  free(f->b);
+  free(f->dst);
+  free(f->scratch);
+  free(f->str);
+}
+
+// Set the threshold `field` of `t` to the first size in `[lo, hi]` from which the fast algorithm wins `WINS` sizes in a row,
+// or to `hi` if it never does.
+// Operands of `n` words take the fast algorithm once the threshold is `n`, or when `strict`, below `n`.
+static void crossover(void (*op)(fixture*), bn__thresholds* t, size_t* field, size_t lo, size_t hi, bool strict) {
+  size_t wins = 0, first = hi;
+  for (size_t n = lo; n <= hi; n += n / 8 > 1 ? n / 8 : 1) {
+    fixture f;
+    setup(&f, n);
+    *field = strict ? n : n + 1;
+    double simple = measure(op, &f, *t);
+    *field = strict ? n - 1 : n;
+    double fast = measure(op, &f, *t);
+    teardown(&f);
+    if (fast < simple) {
+      if (wins++ == 0) { first = strict ? n - 1 : n; }
+      if (wins == WINS) { break; }
+    }
+    else { wins = 0; }
+  }
+  *field = wins == WINS ? first : hi;
+}
+
+// Set the threshold `field` of `t` to whichever of the `nCandidates` values converts an `n`-word number fastest.
+static void fastest(bn__thresholds* t, size_t* field, const size_t* candidates, size_t nCandidates, size_t n) {
+  fixture f;
+  setup(&f, n);
+  size_t out = candidates[0];
+  double best = 0;
+  for (size_t i = 0; i < nCandidates; ++i) {
+    *field = candidates[i];
+    double time = measure(convert, &f, *t);
+    if (i == 0 || time < best) {
+      best = time;
+      out = candidates[i];
+    }
+  }
+  teardown(&f);
+  *field = out;
+}
+
+int main(int argc, char** argv) {
+  bn__thresholds t = bn__get_thresholds();
+  crossover(mul, &t, &t.karatsubaWords, 8, 256, false);
+  // radix conversion is measured with its multiplications already tuned
+  crossover(convert, &t, &t.radixWords, 4, 512, true);
+  static const size_t recips[] = { 2, 4, 8, 12, 16, 24, 32, 48, 64 };
+  fastest(&t, &t.recipWords, recips, sizeof(recips) / sizeof(recips[0]), 2048);
+
+  FILE* out = argc > 1 ? fopen(argv[1], "w") : stdout;
+  if (out == NULL) {
+    fprintf(stderr, "%s: cannot write\n", argv[1]);
+    return 1;
+  }
+  fprintf(out, "// Generated by bench/run_tune on the build machine; delete this file to return to the portable defaults.\n");
+  fprintf(out, "#define BN__KARATSUBA_WORDS %zu\n", t.karatsubaWords);
+  fprintf(out, "#define BN__RADIX_WORDS %zu\n", t.radixWords);
+  fprintf(out, "#define BN__RECIP_WORDS %zu\n", t.recipWords);
+  if (out != stdout) { fclose(out); }
+  printf("karatsuba=%zu,radix=%zu,recip=%zu\n", t.karatsubaWords, t.radixWords, t.recipWords);
+  return 0;
+}
@@ -0,0 +1,25 @@
+#ifndef BIGLIT_BASIC_ALLOC
+#define BIGLIT_BASIC_ALLOC
+
+// This header is private to the basic translation units.
+// All of their memory is obtained and released through these functions,
+// so that the allocator set by `bn_setAllocator` (see `basic/bn.h`) sees every allocation, and only its own.
+
+#include <stddef.h>
+
+// Return at least `nBytes` bytes; never `NULL`.
+void* bl__alloc(size_t nBytes);
+
+// Resize `ptr`, which was allocated with room for `oldBytes` bytes, to hold `nBytes`, preserving its contents.
+void* bl__realloc(void* ptr, size_t oldBytes, size_t nBytes);
+
+// Release memory from `bl__alloc` or `bl__realloc`; `NULL` is ignored.
+void bl__free(void* ptr);
+
+struct bn_;
+
+// Normalize a fresh result that was allocated with room for `nDigits` digits, and give back the room it turned out not to need.
+// A zero result is released, and the shared zero returned in its place.
+struct bn_* bl__fit(struct bn_* dst, size_t nDigits);
+
+#endif
@@ -0,0 +1,61 @@
+#include "basic/alloc.h"
+#include "basic/batch.h"
+#include "core/batch.h"
+#include "stats.h"
+
+#include <stdlib.h>
+
+// Return the digits in all `n` lanes of `a`, for the instrumentation.
+static inline size_t lanesLen(const bn* const a[], size_t n) {
+  size_t out = 0;
+  for (size_t i = 0; i < n; ++i) { out += a[i]->len; }
+  return out;
+}
+
+// Likewise for the magnitudes of `src`.
+static inline size_t zLanesLen(const bz src[], size_t n) {
+  size_t out = 0;
+  for (size_t i = 0; i < n; ++i) { out += src[i].magnitude->len; }
+  return out;
+}
+
+void bn_batchAdd(bn* dst[], const bn* const a[], const bn* const b[], size_t n) {
+  BL_STAT(lanesLen(a, n) + lanesLen(b, n));
+  size_t len = bn__sizeof_batch_add(a, b, n);
+  // one block holds every result, carved out at `bn_` alignment, which every allocation already has
+  uint8_t* mem = bl__alloc(len);
+  bl_result err = bn__batch_add(dst, a, b, n, mem, len);
+  assert(err == BL_OK);
+  for (size_t i = 0; i < n; ++i) { bn__normalize(dst[i]); }
+  if (n == 0) { bl__free(mem); }
+}
+
+void bn_batchMul(bn* dst[], const bn* const a[], const bn* const b[], size_t n) {
+  BL_STAT(lanesLen(a, n) + lanesLen(b, n));
+  size_t len = bn__sizeof_batch_mul(a, b, n);
+  uint8_t* mem = bl__alloc(len);
+  bl_result err = bn__batch_mul(dst, a, b, n, mem, len);
+  assert(err == BL_OK);
+  for (size_t i = 0; i < n; ++i) { bn__normalize(dst[i]); }
+  if (n == 0) { bl__free(mem); }
+}
+
+void bn_batchFree(bn* dst[], size_t n) {
+  BL_STAT(0);
+  if (n != 0) { bl__free(dst[0]); }
+}
+
+void bn_batchCmp(bl_ord dst[], const bn* const a[], const bn* const b[], size_t n) {
+  BL_STAT(lanesLen(a, n) + lanesLen(b, n));
+  bn__batch_cmp(dst, a, b, n);
+}
+
+void bn_batchFits(bool dst[], const bn* const src[], size_t n, size_t nbits) {
+  BL_STAT(lanesLen(src, n));
+  bn__batch_fits(dst, src, n, nbits);
+}
+
+void bz_batchFits(bool dst[], const bz src[], size_t n, size_t nbits) {
+  BL_STAT(zLanesLen(src, n));
+  bz__batch_fits(dst, src, n, nbits);
+}
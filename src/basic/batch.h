@@ -0,0 +1,33 @@
+#ifndef BIGLIT_BASIC_BATCH
+#define BIGLIT_BASIC_BATCH
+
+#include "basic/bn.h"
+#include "basic/bz.h"
+
+// These functions evaluate many independent operations at once: lane `i` combines `a[i]` with `b[i]` and writes `dst[i]`.
+// They are meant for compiler passes which fold a large number of small literals (enum values, case labels, and so on),
+// where a function call, size query, allocation and normalization per operation would dominate the cost.
+//
+// The results of one batch share a single allocation, and are released together by `bn_batchFree`;
+// they must not be passed to `bn_free` individually.
+// Operand arrays are arrays of pointers to constant numbers, so they may be built from the results of other batches.
+
+// Place `a[i] + b[i]` in `dst[i]` for each of the `n` lanes.
+void bn_batchAdd(bn* dst[], const bn* const a[], const bn* const b[], size_t n);
+
+// Place `a[i] * b[i]` in `dst[i]` for each of the `n` lanes.
+void bn_batchMul(bn* dst[], const bn* const a[], const bn* const b[], size_t n);
+
+// Release all the results of the batch that produced `dst`.
+void bn_batchFree(bn* dst[], size_t n);
+
+// Store whether `a[i]` is less than/equal to/greater than `b[i]` in `dst[i]`.
+void bn_batchCmp(bl_ord dst[], const bn* const a[], const bn* const b[], size_t n);
+
+// Store whether `src[i]` fits in an unsigned `nbits`-bit type in `dst[i]`.
+void bn_batchFits(bool dst[], const bn* const src[], size_t n, size_t nbits);
+
+// Store whether `src[i]` fits in a signed (two's-complement) `nbits`-bit type in `dst[i]`.
+void bz_batchFits(bool dst[], const bz src[], size_t n, size_t nbits);
+
+#endif
@@ -0,0 +1,116 @@
+#include "basic/alloc.h"
+#include "basic/bd.h"
+#include "core/bd.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// All `bd` results must be normalized (no leading zero bytes), as with `bn`.
+
+static inline bd_* alloc(size_t nBytes) {
+  assert(SIZE_MAX - sizeof(bd_) >= nBytes);
+  bd_* out = bl__alloc(sizeof(bd_) + nBytes);
+  out->len = nBytes;
+  return out;
+}
+
+////// Initialization //////
+
+void bd_free(bd* src) {
+  bl__free(src);
+}
+
+bd* bd_copy(const bd* src) {
+  bd* dst = alloc(src->len);
+  memcpy(&dst->bcdle[0], &src->bcdle[0], src->len);
+  return dst;
+}
+
+////// Queries //////
+
+size_t bd_nDigits(const bd* src) {
+  return bd__ndigits(src);
+}
+
+bl_ord bd_cmp(const bd* a, const bd* b) {
+  if (a->len != b->len) { return a->len < b->len ? BL_LT : BL_GT; }
+  return bd__cmp(a, b);
+}
+
+bool bd_eq(const bd* a, const bd* b) {
+  return bd_cmp(a, b) == BL_EQ;
+}
+bool bd_neq(const bd* a, const bd* b) {
+  return bd_cmp(a, b) != BL_EQ;
+}
+bool bd_lt(const bd* a, const bd* b) {
+  return bd_cmp(a, b) == BL_LT;
+}
+bool bd_lte(const bd* a, const bd* b) {
+  return bd_cmp(a, b) != BL_GT;
+}
+bool bd_gt(const bd* a, const bd* b) {
+  return bd_cmp(a, b) == BL_GT;
+}
+bool bd_gte(const bd* a, const bd* b) {
+  return bd_cmp(a, b) != BL_LT;
+}
+
+////// Arithmetic //////
+
+bd* bd_add(const bd* a, const bd* b) {
+  bd* dst = alloc(bd__sizeof_add(a, b));
+  bl_result err = bd__add(dst, a, b);
+  assert(err == BL_OK);
+  bd__normalize(dst);
+  return dst;
+}
+
+bd* bd_sub(const bd* a, const bd* b) {
+  bd* dst = alloc(bd__sizeof_sub(a, b));
+  if (bd__sub(dst, a, b) != BL_OK) { dst->len = 0; }
+  bd__normalize(dst);
+  return dst;
+}
+
+////// Text //////
+
+bd* bd_parse(const char* str, size_t len) {
+  bd* dst = alloc(bd__sizeof_parse(len));
+  bl_result err = bd__parse(dst, str, len);
+  assert(err != BL_OVERFLOW);
+  if (err != BL_OK) {
+    bl__free(dst);
+    return NULL;
+  }
+  bd__normalize(dst);
+  return dst;
+}
+
+size_t bd_sizeofPrint(const bd* src) {
+  return bd__sizeof_print(src);
+}
+
+size_t bd_print(char* dst, size_t dstLen, const bd* src) {
+  if (bd__print(dst, dstLen, src) != BL_OK) { return 0; }
+  return bd__sizeof_print(src);
+}
+
+////// Conversion //////
+
+bn* bd_toBn(const bd* src) {
+  bn_buffer* dst = bn_new(bd__sizeof_bn(src), NULL);
+  bl_result err = bd__to_bn(dst, src);
+  assert(err == BL_OK);
+  return bn_create(dst, SIZE_MAX);
+}
+
+bd* bd_fromBn(const bn* src) {
+  bd* dst = alloc(bd__sizeof_from_bn(src));
+  bn_buffer* scratch = bn_new(bd__sizeof_from_bn_scratch(src), NULL);
+  bl_result err = bd__from_bn(dst, src, scratch);
+  assert(err == BL_OK);
+  bl__free(scratch);
+  bd__normalize(dst);
+  return dst;
+}
@@ -0,0 +1,66 @@
+#ifndef BIGLIT_BASIC_BD
+#define BIGLIT_BASIC_BD
+
+#include "basic/bn.h"
+#include "core/bd.h"
+
+// This interface uses the system allocator (specifically `malloc`) to create memory for all results,
+// unless another allocator is set with `bn_setAllocator`.
+// Results are always placed in a fresh pointer rather than attempt to share pointers.
+// Thus, to deallocate later, call `bd_free` on any `bd*` returned by the functions of this library.
+//
+// A `bd` is a natural number kept in decimal.
+// Parsing and printing take one pass over the digits, and addition and subtraction work directly on them,
+// so a literal that is only range-checked and written back out never needs converting to binary.
+// When other arithmetic is needed, convert to `bn` with `bd_toBn`.
+
+typedef struct bd_ bd;
+
+////// Initialization //////
+
+void bd_free(bd* src);
+
+bd* bd_copy(const bd* src);
+
+////// Queries //////
+
+// Return the number of decimal digits in `src` (zero for zero).
+size_t bd_nDigits(const bd* src);
+
+// Return if the first number is less than/equal to/greater than the second.
+bl_ord bd_cmp(const bd* a, const bd* b);
+
+bool bd_eq(const bd* a, const bd* b);
+bool bd_neq(const bd* a, const bd* b);
+bool bd_lt(const bd* a, const bd* b);
+bool bd_lte(const bd* a, const bd* b);
+bool bd_gt(const bd* a, const bd* b);
+bool bd_gte(const bd* a, const bd* b);
+
+////// Arithmetic //////
+
+bd* bd_add(const bd* a, const bd* b);
+
+// if `b > a`, returns zero.
+bd* bd_sub(const bd* a, const bd* b);
+
+////// Text //////
+
+// Parse the `len` characters at `str` as a natural number written in decimal.
+// Returns `NULL` if there are no digits, or any character is not a decimal digit.
+bd* bd_parse(const char* str, size_t len);
+
+// Return the number of characters in the decimal representation of `src`.
+size_t bd_sizeofPrint(const bd* src);
+
+// Write `src` in decimal to the start of `dst`, without a terminating nul.
+// Return the number of characters written, or zero if `dstLen` is less than `bd_sizeofPrint(src)`.
+size_t bd_print(char* dst, size_t dstLen, const bd* src);
+
+////// Conversion //////
+
+bn* bd_toBn(const bd* src);
+
+bd* bd_fromBn(const bn* src);
+
+#endif
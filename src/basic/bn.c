@@ -1,8 +1,24 @@
+#if defined(__unix__) || defined(__APPLE__)
+#define _POSIX_C_SOURCE 200809L
+#define BL_FREELISTS_PTHREAD 1
+#else
+#define BL_FREELISTS_PTHREAD 0
+#endif
+
+#include "basic/alloc.h"
 #include "basic/bn.h"
 #include "core/bn.h"
+#include "core/bz_type.h"
+#include "stats.h"
 
+#include <errno.h>
 #include <signal.h>
 #include <stdlib.h>
+#include <string.h>
+
+#if BL_FREELISTS_PTHREAD
+#include <pthread.h>
+#endif
 
 // All `bn` results must be normalized (no leading zeros), because we depend on normalization in several places.
 // typedef struct bn { bn_ bn; } bn;
@@ -15,27 +31,218 @@ static inline size_t max(size_t a, size_t b) {
   return a > b ? a : b;
 }
 
+////// Allocation //////
+
+// Requests are rounded up to a multiple of this many bytes,
+// so that numbers of similar sizes ask for exactly the same size, and a slab allocator can serve them from one slab.
+#define SIZE_CLASS 16
+
+static void* systemAlloc(void* ctx, size_t nBytes) {
+  (void)ctx;
+  return malloc(nBytes);
+}
+
+static void* systemRealloc(void* ctx, void* ptr, size_t nBytes) {
+  (void)ctx;
+  return realloc(ptr, nBytes);
+}
+
+static void systemFree(void* ctx, void* ptr) {
+  (void)ctx;
+  free(ptr);
+}
+
+static struct {
+  void* (*alloc)(void* ctx, size_t nBytes);
+  void* (*realloc)(void* ctx, void* ptr, size_t nBytes);
+  void (*free)(void* ctx, void* ptr);
+  void* ctx;
+} allocator = { systemAlloc, systemRealloc, systemFree, NULL };
+
+static size_t sizeClass(size_t nBytes) {
+  assert(nBytes <= SIZE_MAX - (SIZE_CLASS - 1));
+  nBytes = (nBytes + SIZE_CLASS - 1) / SIZE_CLASS * SIZE_CLASS;
+  return nBytes == 0 ? SIZE_CLASS : nBytes;
+}
+
+// Blocks of the smallest size classes released by `bn_free` are kept for reuse on a freelist per class,
+// linked through their first word, so that most small results cost a pointer pop rather than a call to `malloc`.
+// The lists are per-thread, so need no locking, and are bounded, so that a thread holds at most a few kilobytes.
+// A thread's lists are released when it exits, by the destructor of a thread-specific key that is set when it first keeps a block
+// (without POSIX threads, only `bn_releaseFreelists` releases them).
+// A custom allocator is assumed to be fast already, so while one is set, the freelists are neither filled nor used.
+#define N_FREELISTS 4
+#define FREELIST_CAP 32
+
+static _Thread_local struct {
+  void* head;
+  size_t len;
+} freelists[N_FREELISTS];
+
+#if BL_FREELISTS_PTHREAD
+
+static pthread_key_t freelistsKey;
+static pthread_once_t freelistsKeyOnce = PTHREAD_ONCE_INIT;
+static _Thread_local bool freelistsKeySet;
+
+static void releaseAtExit(void* arg) {
+  (void)arg;
+  bn_releaseFreelists();
+}
+
+static void createFreelistsKey(void) {
+  int err = pthread_key_create(&freelistsKey, releaseAtExit);
+  assert(err == 0);
+}
+
+// Arrange for the calling thread's lists to be released when it exits.
+static void releaseFreelistsAtExit(void) {
+  if (freelistsKeySet) { return; }
+  pthread_once(&freelistsKeyOnce, createFreelistsKey);
+  // the destructor runs only for a non-NULL value, which is otherwise unused
+  int err = pthread_setspecific(freelistsKey, &freelistsKeySet);
+  assert(err == 0);
+  freelistsKeySet = true;
+}
+
+#else
+
+static void releaseFreelistsAtExit(void) {}
+
+#endif
+
+static bool useFreelists(void) {
+  return allocator.alloc == systemAlloc;
+}
+
+static void* popFreelist(size_t nBytes) {
+  if (nBytes > N_FREELISTS * SIZE_CLASS || !useFreelists()) { return NULL; }
+  size_t i = nBytes / SIZE_CLASS - 1;
+  void* out = freelists[i].head;
+  if (out == NULL) { return NULL; }
+  memcpy(&freelists[i].head, out, sizeof(void*));
+  freelists[i].len -= 1;
+  return out;
+}
+
+// Keep `ptr`, which holds at least `nBytes`, for reuse if there is room; returns false if there is not.
+// A number that shrank after it was allocated is filed by its current size, so its block may serve a class smaller than itself;
+// the extra room is wasted until it is freed for good, but there are never more than `FREELIST_CAP` such blocks per class.
+static bool pushFreelist(void* ptr, size_t nBytes) {
+  if (nBytes > N_FREELISTS * SIZE_CLASS || !useFreelists()) { return false; }
+  size_t i = nBytes / SIZE_CLASS - 1;
+  if (freelists[i].len == FREELIST_CAP) { return false; }
+  releaseFreelistsAtExit();
+  memcpy(ptr, &freelists[i].head, sizeof(void*));
+  freelists[i].head = ptr;
+  freelists[i].len += 1;
+  return true;
+}
+
+void bn_releaseFreelists(void) {
+  for (size_t i = 0; i < N_FREELISTS; ++i) {
+    while (freelists[i].head != NULL) {
+      void* block = freelists[i].head;
+      memcpy(&freelists[i].head, block, sizeof(void*));
+      free(block);
+    }
+    freelists[i].len = 0;
+  }
+}
+
+// Every zero result with no room to spare is this one object, which is never written (it has no digits) and never freed.
+static bn_ zero = { .len = 0 };
+
+void bn_setAllocator(void* (*alloc)(void* ctx, size_t nBytes), void* (*realloc)(void* ctx, void* ptr, size_t nBytes), void (*free)(void* ctx, void* ptr), void* ctx) {
+  bn_releaseFreelists();
+  if (alloc == NULL || free == NULL) {
+    allocator.alloc = systemAlloc;
+    allocator.realloc = systemRealloc;
+    allocator.free = systemFree;
+    allocator.ctx = NULL;
+  }
+  else {
+    allocator.alloc = alloc;
+    allocator.realloc = realloc;
+    allocator.free = free;
+    allocator.ctx = ctx;
+  }
+}
+
+void* bl__alloc(size_t nBytes) {
+  nBytes = sizeClass(nBytes);
+  BL_STAT_ALLOC(nBytes);
+  void* out = popFreelist(nBytes);
+  if (out != NULL) { return out; }
+  out = allocator.alloc(allocator.ctx, nBytes);
+  assert(out != NULL);
+  return out;
+}
+
+void* bl__realloc(void* ptr, size_t oldBytes, size_t nBytes) {
+  oldBytes = sizeClass(oldBytes);
+  nBytes = sizeClass(nBytes);
+  if (nBytes == oldBytes) { return ptr; }
+  BL_STAT_ALLOC(nBytes);
+  void* out;
+  if (allocator.realloc != NULL) {
+    out = allocator.realloc(allocator.ctx, ptr, nBytes);
+    assert(out != NULL);
+  }
+  else {
+    out = allocator.alloc(allocator.ctx, nBytes);
+    assert(out != NULL);
+    memcpy(out, ptr, min(oldBytes, nBytes));
+    allocator.free(allocator.ctx, ptr);
+  }
+  return out;
+}
+
+void bl__free(void* ptr) {
+  if (ptr == NULL || ptr == &zero) { return; }
+  allocator.free(allocator.ctx, ptr);
+}
+
+// Release a number, keeping its memory for reuse if it is small.
+static void release(bn_* src) {
+  if (src == NULL || src == &zero) { return; }
+  // lengths only ever shrink after allocation, so the block holds at least this much
+  if (pushFreelist(src, sizeClass(sizeof(bn_) + src->len))) { return; }
+  allocator.free(allocator.ctx, src);
+}
+
 static inline bn_* alloc(size_t nDigits) {
   assert(SIZE_MAX - sizeof(bn) >= nDigits);
-  bn_* out = aligned_alloc(4, sizeof(bn_) + nDigits);
-  assert(out != NULL);
+  bn_* out = bl__alloc(sizeof(bn_) + nDigits);
   out->len = nDigits;
   return out;
 }
 
 static inline bn* newZero() {
-  bn* dst = alloc(0);
-  dst->len = 0;
-  return dst;
+  return &zero;
+}
+
+// See `basic/alloc.h`; shrinking means a number kept for a long time holds no more than its own size class.
+// Sizes are predicted closely enough that this rarely changes size class, and then it is a shrink the allocator can do in place.
+bn_* bl__fit(bn_* dst, size_t nDigits) {
+  bn__normalize(dst);
+  if (dst->len == 0) {
+    release(dst);
+    return newZero();
+  }
+  return bl__realloc(dst, sizeof(bn_) + nDigits, sizeof(bn_) + dst->len);
 }
 
 ////// Initialization //////
 
 void bn_free(bn* src) {
-  free(src);
+  BL_STAT(0);
+  release(src);
 }
 
 bn* bn_umax(uintmax_t src) {
+  BL_STAT(0);
+  if (src == 0) { return newZero(); }
   bn* dst = alloc(sizeof(uintmax_t));
   bl_result err = bn__umax(dst, src);
   assert(err == BL_OK);
@@ -43,6 +250,7 @@ bn* bn_umax(uintmax_t src) {
 }
 
 bn* bn_copy(const bn* src) {
+  BL_STAT(src->len);
   bn* dst = alloc(src->len);
   dst->len = src->len;
   bl_result err = bn__copy(dst, src);
@@ -53,10 +261,12 @@ bn* bn_copy(const bn* src) {
 ////// Queries //////
 
 bool bn_bit(const bn* src, size_t i) {
+  BL_STAT(src->len);
   return bn__bit(src, i);
 }
 
 size_t bn_nBits(const bn* src) {
+  BL_STAT(src->len);
   if (src->len == 0) { return 0; }
   size_t out = 8 * src->len;
   uint8_t hiByte = src->base256le[src->len - 1];
@@ -68,16 +278,24 @@ size_t bn_nBits(const bn* src) {
   return out;
 }
 
+size_t bn_popcount(const bn* src) {
+  BL_STAT(src->len);
+  return bn__popcount(src);
+}
+
 uint8_t bn_byte(const bn* src, size_t i) {
+  BL_STAT(src->len);
   if (i >= src->len) { return 0; }
   return src->base256le[i];
 }
 
 size_t bn_nBytes(const bn* src) {
+  BL_STAT(src->len);
   return src->len;
 }
 
 bl_ord bn_cmp(const bn* a, const bn* b) {
+  BL_STAT(a->len + b->len);
   if (a == b) { return BL_EQ; }
   else if (a->len > b->len) { return BL_GT; }
   else if (a->len < b->len) { return BL_LT; }
@@ -85,106 +303,165 @@ bl_ord bn_cmp(const bn* a, const bn* b) {
 }
 
 bool bn_eq(const bn* a, const bn* b) {
+  BL_STAT(a->len + b->len);
   return bn_cmp(a, b) == BL_EQ;
 }
 bool bn_neq(const bn* a, const bn* b) {
+  BL_STAT(a->len + b->len);
   return bn_cmp(a, b) != BL_EQ;
 }
 bool bn_lt(const bn* a, const bn* b) {
+  BL_STAT(a->len + b->len);
   return bn_cmp(a, b) == BL_LT;
 }
 bool bn_lte(const bn* a, const bn* b) {
+  BL_STAT(a->len + b->len);
   return bn_cmp(a, b) != BL_GT;
 }
 bool bn_gt(const bn* a, const bn* b) {
+  BL_STAT(a->len + b->len);
   return bn_cmp(a, b) == BL_GT;
 }
 bool bn_gte(const bn* a, const bn* b) {
+  BL_STAT(a->len + b->len);
   return bn_cmp(a, b) != BL_LT;
 }
 
 ////// Bitwise //////
 
 bn* bn_and(const bn* a, const bn* b) {
-  bn* dst = alloc(bn__sizeof_and(a, b));
+  BL_STAT(a->len + b->len);
+  size_t nDigits = bn__sizeof_and(a, b);
+  bn* dst = alloc(nDigits);
   bn__and(dst, a, b);
-  bn__normalize(dst);
-  return dst;
+  return bl__fit(dst, nDigits);
 }
 
 bn* bn_or(const bn* a, const bn* b) {
-  bn* dst = alloc(bn__sizeof_or(a, b));
+  BL_STAT(a->len + b->len);
+  size_t nDigits = bn__sizeof_or(a, b);
+  bn* dst = alloc(nDigits);
   bn__or(dst, a, b);
-  bn__normalize(dst);
-  return dst;
+  return bl__fit(dst, nDigits);
 }
 
 bn* bn_xor(const bn* a, const bn* b) {
-  bn* dst = alloc(bn__sizeof_xor(a, b));
+  BL_STAT(a->len + b->len);
+  size_t nDigits = bn__sizeof_xor(a, b);
+  bn* dst = alloc(nDigits);
   bn__xor(dst, a, b);
-  bn__normalize(dst);
-  return dst;
+  return bl__fit(dst, nDigits);
 }
 
 ////// Arithmetic //////
 
 bn* bn_inc(const bn* a) {
-  bn* dst = alloc(bn__sizeof_inc(a));
+  BL_STAT(a->len);
+  size_t nDigits = bn__sizeof_inc(a);
+  bn* dst = alloc(nDigits);
   dst->base256le[dst->len - 1] = 0;
   bl_result err = bn__inc(dst, a);
   assert(err == BL_OK);
-  bn__normalize(dst);
-  return dst;
+  return bl__fit(dst, nDigits);
 }
 
 bn* bn_add(const bn* a, const bn* b) {
-  bn* dst = alloc(bn__sizeof_add(a, b));
+  BL_STAT(a->len + b->len);
+  size_t nDigits = bn__sizeof_add(a, b);
+  bn* dst = alloc(nDigits);
   dst->base256le[dst->len - 1] = 0;
   bl_result err = bn__add(dst, a, b);
   assert(err == BL_OK);
-  bn__normalize(dst);
-  return dst;
+  return bl__fit(dst, nDigits);
 }
 
 bn* bn_dec(const bn* a) {
-  bn* dst = alloc(bn__sizeof_dec(a));
+  BL_STAT(a->len);
+  size_t nDigits = bn__sizeof_dec(a);
+  bn* dst = alloc(nDigits);
   bl_result err = bn__dec(dst, a);
   assert(err == BL_OK);
-  bn__normalize(dst);
-  return dst;
+  return bl__fit(dst, nDigits);
 }
 
 bn* bn_sub(const bn* a, const bn* b) {
+  BL_STAT(a->len + b->len);
   if (b->len > a->len) { return newZero(); }
-  bn* dst = alloc(bn__sizeof_sub(a, b));
+  size_t nDigits = bn__sizeof_sub(a, b);
+  bn* dst = alloc(nDigits);
   bl_result err = bn__sub(dst, a, b);
-  if (err == BL_OVERFLOW) {
-    dst->len = 0;
-    return dst;
-  }
-  bn__normalize(dst);
-  return dst;
+  if (err == BL_OVERFLOW) { dst->len = 0; }
+  return bl__fit(dst, nDigits);
 }
 
 bn* bn_mul(const bn* a, const bn* b) {
+  BL_STAT(a->len + b->len);
   if (a->len == 0 || b->len == 0) { return newZero(); }
-  bn* dst = alloc(bn__sizeof_mul(a, b));
-  bn__blank(dst);
-  bl_result err = bn__mul(dst, a, b);
+  size_t nDigits = bn__sizeof_mul(a, b);
+  bn* dst = alloc(nDigits);
+  bn_* scratch = alloc(bn__sizeof_karatsuba_scratch(a, b, NULL));
+  bl_result err = bn__karatsuba(dst, a, b, scratch, NULL);
   assert(err == BL_OK);
-  bn__normalize(dst);
-  return dst;
+  bl__free(scratch);
+  return bl__fit(dst, nDigits);
+}
+
+bn* bn_addMul1(const bn* acc, const bn* a, uint64_t k) {
+  BL_STAT(acc->len + a->len);
+  size_t nDigits = bn__sizeof_addmul_1(acc, a, k);
+  if (nDigits == 0) { return newZero(); }
+  bn* dst = alloc(nDigits);
+  bl_result err = bn__copy(dst, acc);
+  assert(err == BL_OK);
+  err = bn__addmul_1(dst, a, k);
+  assert(err == BL_OK);
+  return bl__fit(dst, nDigits);
+}
+
+bn* bn_subMul1(const bn* acc, const bn* a, uint64_t k) {
+  BL_STAT(acc->len + a->len);
+  size_t nDigits = acc->len;
+  if (nDigits == 0) { return newZero(); }
+  bn* dst = alloc(nDigits);
+  bl_result err = bn__copy(dst, acc);
+  assert(err == BL_OK);
+  err = bn__submul_1(dst, a, k);
+  if (err == BL_OVERFLOW) { dst->len = 0; }
+  return bl__fit(dst, nDigits);
+}
+
+bn* bn_fma(const bn* a, const bn* b, const bn* c) {
+  BL_STAT(a->len + b->len + c->len);
+  size_t nDigits = bn__sizeof_fma(a, b, c);
+  if (nDigits == 0) { return newZero(); }
+  bn* dst = alloc(nDigits);
+  bl_result err;
+  if (min(a->len, b->len) < 8 * bn__get_thresholds().karatsubaWords) {
+    err = bn__fma(dst, a, b, c);
+  }
+  else {
+    // schoolbook rows would cost more than the extra pass to add `c`
+    bn_* scratch = alloc(bn__sizeof_karatsuba_scratch(a, b, NULL));
+    err = bn__karatsuba(dst, a, b, scratch, NULL);
+    assert(err == BL_OK);
+    bl__free(scratch);
+    err = bn__add(dst, dst, c);
+  }
+  assert(err == BL_OK);
+  return bl__fit(dst, nDigits);
 }
 
 struct bn_divmod bn_divmod(const bn* a, const bn* b) {
+  BL_STAT(a->len + b->len);
   if (b->len == 0) {
     raise(SIGFPE);
     assert(false && "raise(SGFPE) returned");
     exit(1);
   }
   struct bn_divmod dst;
-  dst.div = alloc(bn__sizeof_div(a, b));
-  dst.mod = alloc(bn__sizeof_mod(a, b));
+  size_t divDigits = bn__sizeof_div(a, b), modDigits = bn__sizeof_mod(a, b);
+  dst.div = alloc(divDigits);
+  dst.mod = alloc(modDigits);
   assert(dst.div != NULL);
   assert(dst.mod != NULL);
   bn__blank(dst.div);
@@ -192,45 +469,342 @@ struct bn_divmod bn_divmod(const bn* a, const bn* b) {
   bl_result err = bn__divmod(dst.div, dst.mod, a, b);
   assert(err != BL_DIVZERO);
   assert(err == BL_OK);
-  bn__normalize(dst.div);
-  bn__normalize(dst.mod);
+  dst.div = bl__fit(dst.div, divDigits);
+  dst.mod = bl__fit(dst.mod, modDigits);
   return dst;
 }
 
 
 bn* bn_div(const bn* a, const bn* b) {
+  BL_STAT(a->len + b->len);
   struct bn_divmod r = bn_divmod(a, b);
-  free(r.mod);
+  release(r.mod);
   return r.div;
 }
 
 bn* bn_mod(const bn* a, const bn* b) {
+  BL_STAT(a->len + b->len);
   struct bn_divmod r = bn_divmod(a, b);
-  free(r.div);
+  release(r.div);
   return r.mod;
 }
 
+////// Wrapping Arithmetic //////
+
+bn* bn_wrap(const bn* src, size_t nbits) {
+  BL_STAT(src->len);
+  size_t nDigits = bn__sizeof_wrap(nbits);
+  bn* dst = alloc(nDigits);
+  bn__wrap(dst, src, nbits);
+  return bl__fit(dst, nDigits);
+}
+
+bn* bn_addWrap(const bn* a, const bn* b, size_t nbits) {
+  BL_STAT(a->len + b->len);
+  size_t nDigits = bn__sizeof_wrap(nbits);
+  bn* dst = alloc(nDigits);
+  bn__add_wrap(dst, a, b, nbits);
+  return bl__fit(dst, nDigits);
+}
+
+bn* bn_subWrap(const bn* a, const bn* b, size_t nbits) {
+  BL_STAT(a->len + b->len);
+  size_t nDigits = bn__sizeof_wrap(nbits);
+  bn* dst = alloc(nDigits);
+  bn__sub_wrap(dst, a, b, nbits);
+  return bl__fit(dst, nDigits);
+}
+
+bn* bn_mulWrap(const bn* a, const bn* b, size_t nbits) {
+  BL_STAT(a->len + b->len);
+  size_t nDigits = bn__sizeof_wrap(nbits);
+  bn* dst = alloc(nDigits);
+  bn__mul_lo(dst, a, b, nbits);
+  return bl__fit(dst, nDigits);
+}
+
+////// Number Theory //////
+
+bn* bn_gcd(const bn* a, const bn* b) {
+  BL_STAT(a->len + b->len);
+  size_t nDigits = bn__sizeof_gcd(a, b);
+  bn* dst = alloc(nDigits);
+  bn_* scratch = alloc(bn__sizeof_gcd_scratch(a, b));
+  bl_result err = bn__gcd(dst, a, b, scratch);
+  assert(err == BL_OK);
+  bl__free(scratch);
+  return bl__fit(dst, nDigits);
+}
+
+bn* bn_lcm(const bn* a, const bn* b) {
+  BL_STAT(a->len + b->len);
+  if (a->len == 0 || b->len == 0) { return newZero(); }
+  // divide before multiplying to keep the intermediate small
+  bn* g = bn_gcd(a, b);
+  bn_* q = alloc(a->len);
+  bn__divexact(q, a, g);
+  q = bl__fit(q, a->len);
+  bn* dst = bn_mul(q, b);
+  release(q);
+  release(g);
+  return dst;
+}
+
+bn* bn_modinv(const bn* a, const bn* m) {
+  BL_STAT(a->len + m->len);
+  if (m->len == 0) {
+    raise(SIGFPE);
+    assert(false && "raise(SGFPE) returned");
+    exit(1);
+  }
+  bn* r = bn_mod(a, m);
+  size_t sDigits = bn__sizeof_gcdext_s(r, m);
+  bn* g = alloc(bn__sizeof_gcd(r, m));
+  bz_ s = { false, alloc(sDigits) };
+  bz_ t = { false, alloc(bn__sizeof_gcdext_t(r, m)) };
+  bn_* scratch = alloc(bn__sizeof_gcdext_scratch(r, m));
+  bl_result err = bn__gcdext(g, &s, &t, r, m, scratch);
+  assert(err == BL_OK);
+  bl__free(scratch);
+  release(t.magnitude);
+  release(r);
+  bn__normalize(g);
+  bool invertible = g->len == 1 && g->base256le[0] == 1;
+  release(g);
+  if (!invertible) {
+    release(s.magnitude);
+    return NULL;
+  }
+  // `s·a ≡ 1 (mod m)`, and `|s| < m`, so a negative `s` needs only one correction
+  s.magnitude = bl__fit(s.magnitude, sDigits);
+  if (!s.isNeg) { return s.magnitude; }
+  bn* dst = bn_sub(m, s.magnitude);
+  release(s.magnitude);
+  return dst;
+}
+
+////// Roots //////
+
+// Compute the `k`th root of `n`, and its remainder if `rem` is not `NULL`.
+static bn* iroot(bn** rem, const bn* n, unsigned k) {
+  if (k == 0) {
+    raise(SIGFPE);
+    assert(false && "raise(SGFPE) returned");
+    exit(1);
+  }
+  size_t rootDigits = bn__sizeof_iroot(n, k), remDigits = bn__sizeof_iroot_rem(n, k);
+  bn* root = alloc(rootDigits);
+  if (rem != NULL) { *rem = alloc(remDigits); }
+  bn_* scratch = alloc(bn__sizeof_iroot_scratch(n, k));
+  bl_result err = bn__iroot(root, rem != NULL ? *rem : NULL, n, k, scratch);
+  assert(err == BL_OK);
+  bl__free(scratch);
+  if (rem != NULL) { *rem = bl__fit(*rem, remDigits); }
+  return bl__fit(root, rootDigits);
+}
+
+bn* bn_isqrt(const bn* n) {
+  BL_STAT(n->len);
+  return iroot(NULL, n, 2);
+}
+
+bn* bn_iroot(const bn* n, unsigned k) {
+  BL_STAT(n->len);
+  return iroot(NULL, n, k);
+}
+
+struct bn_rootrem bn_rootrem(const bn* n, unsigned k) {
+  BL_STAT(n->len);
+  struct bn_rootrem dst;
+  dst.root = iroot(&dst.rem, n, k);
+  return dst;
+}
+
 ////// Shifting //////
 
 bn* bn_shr(bn* src, size_t amt) {
+  BL_STAT(src->len);
   bn* dst = bn_copy(src);
   bn__shr(dst, amt);
-  bn__normalize(dst);
-  return dst;
+  return bl__fit(dst, src->len);
 }
 
 bn* bn_shl(bn* src, size_t amt) {
-  size_t dstDigits = src->len + amt / 8 + 1; // not quite ceiling: pad the floor with an extra byte just in case
+  BL_STAT(src->len);
+  if (src->len == 0) { return newZero(); }
+  // normalized, so the result needs exactly this many bits
+  size_t nbits = bn__nbits(src) + amt;
+  size_t dstDigits = nbits / 8 + (nbits % 8 != 0);
   bn* dst = alloc(dstDigits);
   bn__copy(dst, src);
   bn__shl(dst, amt);
-  bn__normalize(dst);
   return dst;
 }
 
+////// Serialization //////
+
+size_t bn_sizeofLeb128(const bn* src) {
+  BL_STAT(src->len);
+  return bn__sizeof_leb128(src);
+}
+
+size_t bn_toLeb128(uint8_t* dst, size_t dstLen, const bn* src) {
+  BL_STAT(src->len);
+  if (bn__leb128_encode(dst, dstLen, src) != BL_OK) { return 0; }
+  return bn__sizeof_leb128(src);
+}
+
+bn* bn_fromLeb128(const uint8_t* src, size_t srcLen, size_t* nRead) {
+  BL_STAT(srcLen);
+  size_t dummy;
+  if (nRead == NULL) { nRead = &dummy; }
+  size_t nDigits = bn__sizeof_leb128_decode(src, srcLen);
+  bn* dst = alloc(nDigits);
+  bl_result err = bn__leb128_decode(dst, nRead, src, srcLen);
+  if (err == BL_SYNTAX) {
+    bl__free(dst);
+    return NULL;
+  }
+  assert(err == BL_OK);
+  return bl__fit(dst, nDigits);
+}
+
+size_t bn_toVlq(uint8_t* dst, size_t dstLen, const bn* src) {
+  BL_STAT(src->len);
+  if (bn__vlq_encode(dst, dstLen, src) != BL_OK) { return 0; }
+  return bn__sizeof_leb128(src);
+}
+
+bn* bn_fromVlq(const uint8_t* src, size_t srcLen, size_t* nRead) {
+  BL_STAT(srcLen);
+  size_t dummy;
+  if (nRead == NULL) { nRead = &dummy; }
+  size_t nDigits = bn__sizeof_vlq_decode(src, srcLen);
+  bn* dst = alloc(nDigits);
+  bl_result err = bn__vlq_decode(dst, nRead, src, srcLen);
+  if (err == BL_SYNTAX) {
+    bl__free(dst);
+    return NULL;
+  }
+  assert(err == BL_OK);
+  return bl__fit(dst, nDigits);
+}
+
+////// Parsing //////
+
+struct bn_parser {
+  bn__parser st;
+  bn_* acc;
+  bool failed;
+};
+
+// Ensure the accumulator has room for `nMore` more characters, at least doubling its size when it must grow.
+static void reserve(bn_parser* p, size_t nMore) {
+  size_t need = bn__sizeof_parser(&p->st, nMore);
+  if (need <= p->acc->len) { return; }
+  size_t len = max(need, 2 * p->acc->len);
+  p->acc = bl__realloc(p->acc, sizeof(bn_) + p->acc->len, sizeof(bn_) + len);
+  p->acc->len = len;
+}
+
+bn* bn_parse(const char* str, size_t len, unsigned radix) {
+  BL_STAT(len);
+  assert(2 <= radix && radix <= 36);
+  size_t nDigits = bn__sizeof_parse(len, radix);
+  bn* dst = alloc(nDigits);
+  bn_* scratch = alloc(bn__sizeof_parse_scratch(len, radix, NULL));
+  bl_result err = bn__parse(dst, str, len, radix, scratch, NULL);
+  bl__free(scratch);
+  if (err != BL_OK) {
+    bl__free(dst);
+    return NULL;
+  }
+  return bl__fit(dst, nDigits);
+}
+
+bn_parser* bn_parser_init(unsigned radix) {
+  BL_STAT(0);
+  bn_parser* p = bl__alloc(sizeof(bn_parser));
+  bn__parser_init(&p->st, radix);
+  p->acc = alloc(16);
+  p->failed = false;
+  return p;
+}
+
+bool bn_parser_feed(bn_parser* p, const char* buf, size_t len) {
+  BL_STAT(len);
+  if (p->failed) { return false; }
+  reserve(p, len);
+  bl_result err = bn__parser_feed(&p->st, p->acc, buf, len);
+  assert(err != BL_OVERFLOW);
+  p->failed = err != BL_OK;
+  return !p->failed;
+}
+
+bn* bn_parser_finish(bn_parser* p) {
+  BL_STAT(0);
+  bn* dst = p->acc;
+  size_t nDigits = dst->len;
+  bool ok = !p->failed && bn__parser_finish(&p->st, dst) == BL_OK;
+  bl__free(p);
+  if (!ok) {
+    bl__free(dst);
+    return NULL;
+  }
+  // the accumulator grew by doubling
+  return bl__fit(dst, nDigits);
+}
+
+////// Formatting //////
+
+size_t bn_sizeofFormat(const bn* src, unsigned radix) {
+  BL_STAT(src->len);
+  return bn__sizeof_format(src, radix);
+}
+
+size_t bn_format(char* dst, size_t dstLen, const bn* src, unsigned radix) {
+  BL_STAT(src->len);
+  if (dstLen < bn__sizeof_format(src, radix)) { return 0; }
+  bn_* scratch = alloc(bn__sizeof_format_scratch(src, radix, NULL));
+  size_t out;
+  bl_result err = bn__format(dst, dstLen, &out, src, radix, scratch, NULL);
+  assert(err == BL_OK);
+  bl__free(scratch);
+  return out;
+}
+
+////// Tuning //////
+
+bool bn_setThresholds(const char* spec) {
+  if (spec == NULL) { return true; }
+  bn__thresholds t = bn__get_thresholds();
+  const char* at = spec;
+  while (*at != '\0') {
+    size_t* field;
+    size_t nameLen = strcspn(at, "=");
+    if (at[nameLen] != '=') { return false; }
+    if (nameLen == 9 && strncmp(at, "karatsuba", 9) == 0) { field = &t.karatsubaWords; }
+    else if (nameLen == 5 && strncmp(at, "radix", 5) == 0) { field = &t.radixWords; }
+    else if (nameLen == 5 && strncmp(at, "recip", 5) == 0) { field = &t.recipWords; }
+    else { return false; }
+    at += nameLen + 1;
+    if (*at < '0' || '9' < *at) { return false; }
+    char* end;
+    errno = 0;
+    unsigned long long n = strtoull(at, &end, 10);
+    if (*end != '\0' && *end != ',') { return false; }
+    if (errno == ERANGE || n > SIZE_MAX) { return false; }
+    *field = n;
+    at = *end == ',' ? end + 1 : end;
+  }
+  bn__set_thresholds(t);
+  return true;
+}
+
 ////// Destructive Operations //////
 
 bn_buffer* bn_new(size_t nBytes, bn* src) {
+  BL_STAT(src != NULL ? src->len : 0);
   if (src != NULL) {
     bn_* dst = alloc(max(nBytes,src->len));
     bn__copy(dst, src);
@@ -245,18 +819,21 @@ bn_buffer* bn_new(size_t nBytes, bn* src) {
 }
 
 bn* bn_create(bn_buffer* src, size_t maxBytes) {
+  BL_STAT(src->len);
+  size_t nDigits = src->len;
   if (maxBytes < src->len) {
     src->len = maxBytes;
   }
-  bn__normalize(src);
-  return src;
+  return bl__fit(src, nDigits);
 }
 
 void bn_writeBit(bn_buffer* dst, size_t i, bool bit) {
+  BL_STAT(0);
   bn__wrbit(dst, i, bit);
 }
 
 void bn_writeByte(bn_buffer* dst, size_t i, uint8_t byte) {
+  BL_STAT(0);
   if (i >= dst->len) { return; }
   dst->base256le[i] = byte;
 }
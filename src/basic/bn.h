@@ -8,8 +8,10 @@
 
 #include "common.h"
 #include "basic/version.h"
+#include "core/bz_type.h"
 
-// This interface uses the system allocator (specifically `aligned_alloc`) to create memory for all results.
+// This interface uses the system allocator (specifically `malloc`) to create memory for all results,
+// unless another allocator is set with `bn_setAllocator`.
 // Results are always placed in a fresh pointer rather than attempt to share pointers.
 // Thus, to deallocate later, call `bn_free` on any `bn*` returned by the functions of this library.
 // The only arithmetic error condition allowed is divide-by-zero, and this raises the FPE signal.
@@ -32,6 +34,9 @@ bool bn_bit(const bn* src, size_t i);
 
 size_t bn_nBits(const bn* src);
 
+// Return the number of set bits in `src`.
+size_t bn_popcount(const bn* src);
+
 // Return the `i`th byte of `src` (zero-indexed, little-endian).
 uint8_t bn_byte(const bn* src, size_t i);
 
@@ -69,6 +74,15 @@ bn* bn_sub(const bn* a, const bn* b);
 
 bn* bn_mul(const bn* a, const bn* b);
 
+// Return `acc + a·k` in one pass over `a`; a step of Horner's rule `acc·k + d` is `bn_addMul1(d, acc, k)`.
+bn* bn_addMul1(const bn* acc, const bn* a, uint64_t k);
+
+// Return `acc - a·k`; if `a·k > acc`, returns zero.
+bn* bn_subMul1(const bn* acc, const bn* a, uint64_t k);
+
+// Return `a·b + c`, without a separate pass (or allocation) to add `c` unless the operands are long enough for Karatsuba.
+bn* bn_fma(const bn* a, const bn* b, const bn* c);
+
 struct bn_divmod {
   bn* div;
   bn* mod;
@@ -79,23 +93,154 @@ bn* bn_div(const bn* a, const bn* b);
 
 bn* bn_mod(const bn* a, const bn* b);
 
+////// Wrapping Arithmetic //////
+
+// These return their results modulo `2^nbits`, as the unsigned arithmetic of an `nbits`-wide machine type would;
+// e.g. `bn_mulWrap(a, b, 32)` folds a `u32` multiplication.
+// Only the low `nbits` bits are ever computed.
+
+bn* bn_wrap(const bn* src, size_t nbits);
+
+bn* bn_addWrap(const bn* a, const bn* b, size_t nbits);
+
+bn* bn_subWrap(const bn* a, const bn* b, size_t nbits);
+
+bn* bn_mulWrap(const bn* a, const bn* b, size_t nbits);
+
+////// Number Theory //////
+
+// Return the greatest common divisor of `a` and `b`, where `gcd(0, 0) = 0`.
+bn* bn_gcd(const bn* a, const bn* b);
+
+// Return the least common multiple of `a` and `b`, which is zero if either is zero.
+bn* bn_lcm(const bn* a, const bn* b);
+
+// Return the inverse of `a` modulo `m`: the `x < m` such that `a·x ≡ 1 (mod m)`.
+// Returns `NULL` if there is no such `x` (that is, if `a` and `m` share a factor).
+bn* bn_modinv(const bn* a, const bn* m);
+
+// The result of the extended Euclidean algorithm: `gcd = s·a + t·b`.
+// The cofactors are small: `|s| ≤ b / 2·gcd` and `|t| ≤ a / 2·gcd` except when one of them is zero or one.
+// The cofactors are signed, so are freed with `bz_free` (see `basic/bz.h`), and the function is built with the integers.
+struct bn_gcdext {
+  bn* gcd;
+  bz_ s;
+  bz_ t;
+};
+struct bn_gcdext bn_gcdext(const bn* a, const bn* b);
+
+////// Roots //////
+
+// Return `⌊n^(1/2)⌋`.
+bn* bn_isqrt(const bn* n);
+
+// Return `⌊n^(1/k)⌋`.
+// If `k` is zero, raises the FPE signal.
+bn* bn_iroot(const bn* n, unsigned k);
+
+// The `k`th root of `n` together with `n - root^k`; `n` is a perfect power exactly when `rem` is zero.
+struct bn_rootrem {
+  bn* root;
+  bn* rem;
+};
+struct bn_rootrem bn_rootrem(const bn* n, unsigned k);
+
 ////// Shifting //////
 
 bn* bn_shr(bn* src, size_t amt);
 
 bn* bn_shl(bn* src, size_t amt);
 
+////// Serialization //////
+
+// Return the number of bytes in the LEB128 encoding of `src`; VLQ encodings are the same size.
+size_t bn_sizeofLeb128(const bn* src);
+
+// Write the LEB128 encoding of `src` to the start of `dst`.
+// Return the number of bytes written, or zero if `dstLen` is less than `bn_sizeofLeb128(src)`.
+size_t bn_toLeb128(uint8_t* dst, size_t dstLen, const bn* src);
+
+// Read a LEB128-encoded number from the start of `src`, storing the number of bytes it occupied into `nRead` (if non-null).
+// Returns `NULL` when `src` ends before the encoding does.
+bn* bn_fromLeb128(const uint8_t* src, size_t srcLen, size_t* nRead);
+
+// As `bn_toLeb128`, but in VLQ format.
+size_t bn_toVlq(uint8_t* dst, size_t dstLen, const bn* src);
+
+// As `bn_fromLeb128`, but in VLQ format.
+bn* bn_fromVlq(const uint8_t* src, size_t srcLen, size_t* nRead);
+
+////// Parsing //////
+
+// Parse the `len` characters at `str` as a natural number written in `radix` (2–36).
+// Letters of either case stand for the digits ten and above; no prefixes, signs or separators are accepted.
+// Returns `NULL` if there are no digits, or any character is not a digit in the radix.
+bn* bn_parse(const char* str, size_t len, unsigned radix);
+
+// A parser converts a number whose digits arrive in pieces, such as a literal lexed from a file in blocks,
+// without first gathering the whole text.
+typedef struct bn_parser bn_parser;
+
+// Begin parsing a natural number written in `radix` (2–36).
+bn_parser* bn_parser_init(unsigned radix);
+
+// Feed the parser the next `len` characters of the number.
+// Returns false if any character is not a digit in the radix, after which the parser will only produce `NULL`.
+bool bn_parser_feed(bn_parser* p, const char* buf, size_t len);
+
+// Release the parser, returning the number it parsed.
+// Returns `NULL` if no digits were fed, or a call to `bn_parser_feed` failed.
+bn* bn_parser_finish(bn_parser* p);
+
+////// Formatting //////
+
+// Return the maximum number of characters needed to write `src` in `radix` (2–36).
+size_t bn_sizeofFormat(const bn* src, unsigned radix);
+
+// Write `src` in `radix` (2–36) to the start of `dst`, most significant digit first, without a terminating nul.
+// Lowercase letters stand for the digits ten and above.
+// Return the number of characters written, or zero if `dstLen` is less than `bn_sizeofFormat(src, radix)`.
+size_t bn_format(char* dst, size_t dstLen, const bn* src, unsigned radix);
+
+////// Tuning //////
+
+// Override the algorithm thresholds compiled into the library, e.g. with `bn_setThresholds(getenv("BIGLIT_THRESHOLDS"))`.
+// `spec` is a comma-separated list of `name=words` settings, where the names are `karatsuba`, `radix` and `recip`,
+// as printed by `bench/run_tune`; a value of zero restores the compiled-in default, and unnamed thresholds are unchanged.
+// Returns false, changing nothing, if `spec` is malformed or a value overflows; a `NULL` spec changes nothing and succeeds.
+// Call this before any other thread uses the library.
+bool bn_setThresholds(const char* spec);
+
+////// Allocation //////
+
+// Obtain all the memory of the basic interfaces (of every number system) from `alloc`, resize it with `realloc`, and release it with `free`,
+// passing each `ctx` as its first argument, in place of the system allocator.
+// Requests are rounded up to a multiple of 16 bytes, so that small numbers of similar sizes make identical requests.
+// `alloc` and `realloc` must return memory aligned at least as `malloc` would, or `NULL` only if the program should abort.
+// If `realloc` is `NULL`, memory is resized by allocating, copying and releasing it;
+// if `alloc` or `free` is `NULL`, the system allocator is restored.
+// When workers are in use (see `basic/workers.h`), these are called from several threads at once.
+// Call this before the library allocates anything, or once everything it allocated has been released,
+// since memory is always released through the allocator set at the time.
+void bn_setAllocator(void* (*alloc)(void* ctx, size_t nBytes), void* (*realloc)(void* ctx, void* ptr, size_t nBytes), void (*free)(void* ctx, void* ptr), void* ctx);
+
+// With the system allocator, each thread keeps a few small blocks released by `bn_free` for reuse,
+// which are returned to the system when the thread exits (where POSIX threads are available).
+// Return the calling thread's to the system now, e.g. before a long idle period, or before the thread exits without POSIX threads.
+void bn_releaseFreelists(void);
+
 ////// Destructive Operations //////
 
 typedef struct bn_ bn_buffer;
 
 // Create a new buffer with nBytes base256 digits.
 // It is initialized to src if it is non-null (ignoring overflow), or else zero.
-// When finished with the buffer, either pass to `bn_create` or `free`.
+// When finished with the buffer, either pass to `bn_create` or `bn_free`.
 bn_buffer* bn_new(size_t nBytes, bn* src);
 
 // Create a big natural from a buffer.
 // Any bytes larger than `maxBytes` will be truncated; set to `SIZE_MAX` to never truncate.
+// The buffer is shrunk to fit the number, which may move it, so only the returned pointer may be used afterwards.
 bn* bn_create(bn_buffer* src, size_t maxBytes);
 
 // If the index is out of bounds, the write is ignored.
@@ -0,0 +1,148 @@
+#include "basic/alloc.h"
+#include "basic/bq.h"
+#include "core/bq.h"
+#include "core/bz.h"
+
+#include <signal.h>
+#include <stdlib.h>
+
+// Results are reduced once their numerator or denominator would have more than this many digits.
+#define LAZY_DIGITS 32
+
+// Borrow a natural number as a (non-negative) integer, without copying.
+static bz asBz(const bn* src) {
+  bz out = { .isNeg = false, .magnitude = (bn*)src };
+  return out;
+}
+
+static bq reduced(bq src) {
+  bn_buffer* scratch = bn_new(bq__sizeof_reduce_scratch(src), NULL);
+  bl_result err = bq__reduce(src, scratch);
+  assert(err == BL_OK);
+  bl__free(scratch);
+  bz__normalize(src.num);
+  bn__normalize(src.den);
+  return src;
+}
+
+// Take ownership of `num / den`, reducing it if it has grown too large.
+static bq lazy(bz num, bn* den) {
+  bq out = { .num = num, .den = den };
+  if (num.magnitude->len > LAZY_DIGITS || den->len > LAZY_DIGITS) {
+    out = reduced(out);
+  }
+  return out;
+}
+
+////// Initialization //////
+
+void bq_free(bq src) {
+  bz_free(src.num);
+  bn_free(src.den);
+}
+
+bq bq_copy(bq src) {
+  bq out = { .num = bz_copy(src.num), .den = bn_copy(src.den) };
+  return out;
+}
+
+bq bq_ratio(bz num, const bn* den) {
+  if (den->len == 0) {
+    raise(SIGFPE);
+    assert(false && "raise(SGFPE) returned");
+    exit(1);
+  }
+  return lazy(bz_copy(num), bn_copy(den));
+}
+
+////// Conversion //////
+
+bq bq_fromBz(bz src) {
+  bq out = { .num = bz_copy(src), .den = bn_umax(1) };
+  return out;
+}
+
+bq bq_reduce(bq src) {
+  return reduced(bq_copy(src));
+}
+
+bz bq_num(bq src) {
+  bq r = bq_reduce(src);
+  bn_free(r.den);
+  return r.num;
+}
+
+bn* bq_den(bq src) {
+  bq r = bq_reduce(src);
+  bz_free(r.num);
+  return r.den;
+}
+
+////// Queries //////
+
+bl_ord bq_cmp(bq a, bq b) {
+  bn_buffer* scratch = bn_new(bq__sizeof_cmp_scratch(a, b), NULL);
+  bl_ord out;
+  bl_result err = bq__cmp(&out, a, b, scratch);
+  assert(err == BL_OK);
+  bl__free(scratch);
+  return out;
+}
+
+bool bq_eq(bq a, bq b) {
+  return bq_cmp(a, b) == BL_EQ;
+}
+bool bq_neq(bq a, bq b) {
+  return bq_cmp(a, b) != BL_EQ;
+}
+bool bq_lt(bq a, bq b) {
+  return bq_cmp(a, b) == BL_LT;
+}
+bool bq_lte(bq a, bq b) {
+  return bq_cmp(a, b) != BL_GT;
+}
+bool bq_gt(bq a, bq b) {
+  return bq_cmp(a, b) == BL_GT;
+}
+bool bq_gte(bq a, bq b) {
+  return bq_cmp(a, b) != BL_LT;
+}
+
+////// Arithmetic //////
+
+bq bq_neg(bq a) {
+  bq out = { .num = bz_neg(a.num), .den = bn_copy(a.den) };
+  if (out.num.magnitude->len == 0) { out.num.isNeg = false; }
+  return out;
+}
+
+bq bq_add(bq a, bq b) {
+  // a/b + c/d = (ad + cb) / bd
+  bz ad = bz_mul(a.num, asBz(b.den));
+  bz cb = bz_mul(b.num, asBz(a.den));
+  bz num = bz_add(ad, cb);
+  bz_free(ad);
+  bz_free(cb);
+  return lazy(num, bn_mul(a.den, b.den));
+}
+
+bq bq_sub(bq a, bq b) {
+  b.num.isNeg = !b.num.isNeg;
+  return bq_add(a, b);
+}
+
+bq bq_mul(bq a, bq b) {
+  return lazy(bz_mul(a.num, b.num), bn_mul(a.den, b.den));
+}
+
+bq bq_div(bq a, bq b) {
+  if (b.num.magnitude->len == 0) {
+    raise(SIGFPE);
+    assert(false && "raise(SGFPE) returned");
+    exit(1);
+  }
+  // (a/b) / (c/d) = ad / bc, keeping the sign on top
+  bz num = bz_mul(a.num, asBz(b.den));
+  num.isNeg = num.magnitude->len != 0 && (a.num.isNeg != b.num.isNeg);
+  return lazy(num, bn_mul(a.den, b.num.magnitude));
+}
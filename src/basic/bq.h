@@ -0,0 +1,66 @@
+#ifndef BIGLIT_BASIC_BQ
+#define BIGLIT_BASIC_BQ
+
+#include "basic/bz.h"
+#include "core/bq_type.h"
+
+// This interface uses the system allocator (specifically `malloc`) to create memory for all results,
+// unless another allocator is set with `bn_setAllocator`.
+// Results are always placed in a fresh pointer rather than attempt to share pointers.
+// Thus, to deallocate later, call `bq_free` on any `bq` returned by the functions of this library.
+// The only arithmetic error condition allowed is divide-by-zero, and this raises the FPE signal.
+//
+// Fractions are not kept in lowest terms, since finding the gcd is the most expensive part of most operations.
+// Instead, results are only reduced when they grow past a threshold, or when their numerator or denominator is asked for.
+// Comparison is exact whether or not fractions are reduced.
+
+typedef bq_ bq;
+
+////// Initialization //////
+
+void bq_free(bq src);
+
+bq bq_copy(bq src);
+
+// Create the fraction `num / den`, raising the FPE signal if `den` is zero.
+bq bq_ratio(bz num, const bn* den);
+
+////// Conversion //////
+
+bq bq_fromBz(bz src);
+
+// Return the same number in lowest terms.
+bq bq_reduce(bq src);
+
+// Return the numerator of `src` in lowest terms.
+bz bq_num(bq src);
+
+// Return the denominator of `src` in lowest terms.
+bn* bq_den(bq src);
+
+////// Queries //////
+
+bl_ord bq_cmp(bq a, bq b);
+
+bool bq_eq(bq a, bq b);
+bool bq_neq(bq a, bq b);
+bool bq_lt(bq a, bq b);
+bool bq_lte(bq a, bq b);
+bool bq_gt(bq a, bq b);
+bool bq_gte(bq a, bq b);
+
+////// Arithmetic //////
+
+bq bq_neg(bq a);
+
+bq bq_add(bq a, bq b);
+
+bq bq_sub(bq a, bq b);
+
+bq bq_mul(bq a, bq b);
+
+// Raises the FPE signal if `b` is zero.
+bq bq_div(bq a, bq b);
+
+
+#endif
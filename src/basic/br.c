@@ -0,0 +1,348 @@
+#include "basic/alloc.h"
+#include "basic/br.h"
+#include "core/br.h"
+
+#include <float.h>
+#include <stdlib.h>
+#include <string.h>
+
+static_assert(FLT_RADIX == 2 && DBL_MANT_DIG == 53 && DBL_MAX_EXP == 1024, "double is not IEEE binary64");
+static_assert(FLT_MANT_DIG == 24 && FLT_MAX_EXP == 128, "float is not IEEE binary32");
+
+////// Decimal Conversion //////
+
+double br_decimalToDouble(const bn* w, intmax_t q) {
+  uint64_t bits;
+  if (br__decimal_binary64(&bits, w, q, NULL) != BL_OK) {
+    bn_buffer* scratch = bn_new(br__sizeof_decimal_scratch(w, q), NULL);
+    bl_result err = br__decimal_binary64(&bits, w, q, scratch);
+    assert(err == BL_OK);
+    bl__free(scratch);
+  }
+  double out;
+  memcpy(&out, &bits, sizeof(out));
+  return out;
+}
+
+float br_decimalToFloat(const bn* w, intmax_t q) {
+  uint32_t bits;
+  if (br__decimal_binary32(&bits, w, q, NULL) != BL_OK) {
+    bn_buffer* scratch = bn_new(br__sizeof_decimal_scratch(w, q), NULL);
+    bl_result err = br__decimal_binary32(&bits, w, q, scratch);
+    assert(err == BL_OK);
+    bl__free(scratch);
+  }
+  float out;
+  memcpy(&out, &bits, sizeof(out));
+  return out;
+}
+
+////// Exact Reals //////
+
+// Return the exponent `src` as an integer.
+// One that does not fit would need a power of two or five too large for memory to be computed.
+static intmax_t smallExp(bz src) {
+  assert(bn_nBits(src.magnitude) < 63 && "exponent too large");
+  intmax_t out = 0;
+  for (size_t i = bn_nBytes(src.magnitude); i > 0; --i) {
+    out = (out << 8) | bn_byte(src.magnitude, i - 1);
+  }
+  return src.isNeg ? -out : out;
+}
+
+// 2^32 × log2(5) lies between this and the next integer.
+#define LOG2_5_SCALED INTMAX_C(9972605231)
+
+// Bound the magnitude of a finite, nonzero `src` as `2^lo ≤ |src| < 2^hi`, without computing any powers of five.
+static void log2Bounds(bz* lo, bz* hi, br src) {
+  bz a = bz_imax(LOG2_5_SCALED);
+  bz b = bz_imax(LOG2_5_SCALED + 1);
+  bz scale = bz_imax(INTMAX_C(1) << 32);
+  bz x = bz_mul(src.exp5, a);
+  bz y = bz_mul(src.exp5, b);
+  // the exponent of five adds between `x / 2^32` and `y / 2^32` to the exponent of two, or between `y` and `x` if negative;
+  // Euclidean division by a positive number rounds down
+  bz lo5 = bz_div(src.exp5.isNeg ? y : x, scale);
+  bz hi5Floor = bz_div(src.exp5.isNeg ? x : y, scale);
+  bz hi5 = bz_inc(hi5Floor);
+  bz nbits = bz_imax((intmax_t)bn_nBits(src.significand));
+  bz top = bz_add(nbits, src.exp2);
+  bz bottom = bz_dec(top);
+  *lo = bz_add(bottom, lo5);
+  *hi = bz_add(top, hi5);
+  bz_free(bottom);
+  bz_free(top);
+  bz_free(nbits);
+  bz_free(hi5);
+  bz_free(hi5Floor);
+  bz_free(lo5);
+  bz_free(y);
+  bz_free(x);
+  bz_free(scale);
+  bz_free(b);
+  bz_free(a);
+}
+
+static bn* pow5(uintmax_t k) {
+  bn* out = bn_umax(1);
+  bn* base = bn_umax(5);
+  while (k != 0) {
+    if (k & 1) {
+      bn* tmp = bn_mul(out, base);
+      bn_free(out);
+      out = tmp;
+    }
+    k = k >> 1;
+    if (k != 0) {
+      bn* tmp = bn_mul(base, base);
+      bn_free(base);
+      base = tmp;
+    }
+  }
+  bn_free(base);
+  return out;
+}
+
+static br nonfinite(br_kind kind, bool isNeg) {
+  br out = { kind, isNeg, bn_umax(0), bz_imax(0), bz_imax(0) };
+  return out;
+}
+
+// Build a finite number, making the significand odd.
+static br finite(bool isNeg, const bn* w, bz exp2, bz exp5) {
+  size_t tz = bn__ctz(w);
+  br out = { BR_FINITE, isNeg, NULL, { false, NULL }, { false, NULL } };
+  if (bn_nBits(w) == 0) {
+    out.significand = bn_umax(0);
+    out.exp2 = bz_imax(0);
+    out.exp5 = bz_imax(0);
+    return out;
+  }
+  out.significand = bn_shr((bn*)w, tz);
+  bz shift = bz_imax(tz);
+  out.exp2 = bz_add(exp2, shift);
+  bz_free(shift);
+  out.exp5 = bz_copy(exp5);
+  return out;
+}
+
+void br_free(br src) {
+  bn_free(src.significand);
+  bz_free(src.exp2);
+  bz_free(src.exp5);
+}
+
+br br_copy(br src) {
+  br out = { src.kind, src.isNeg, bn_copy(src.significand), bz_copy(src.exp2), bz_copy(src.exp5) };
+  return out;
+}
+
+br br_zero(bool isNeg) {
+  return nonfinite(BR_FINITE, isNeg);
+}
+
+br br_infinity(bool isNeg) {
+  return nonfinite(BR_INFINITE, isNeg);
+}
+
+br br_nan(bool isNeg) {
+  return nonfinite(BR_NAN, isNeg);
+}
+
+br br_binary(bool isNeg, const bn* w, bz exp) {
+  bz zero = bz_imax(0);
+  br out = finite(isNeg, w, exp, zero);
+  bz_free(zero);
+  return out;
+}
+
+br br_decimal(bool isNeg, const bn* w, bz q) {
+  // 10^q = 2^q × 5^q
+  return finite(isNeg, w, q, q);
+}
+
+// Return whether `str` is `word`, ignoring (ASCII) case.
+static bool matchWord(const char* str, size_t len, const char* word) {
+  if (len != strlen(word)) { return false; }
+  for (size_t i = 0; i < len; ++i) {
+    char c = 'A' <= str[i] && str[i] <= 'Z' ? str[i] - 'A' + 'a' : str[i];
+    if (c != word[i]) { return false; }
+  }
+  return true;
+}
+
+static size_t spanDigits(const char* str, size_t len) {
+  size_t i = 0;
+  while (i < len && '0' <= str[i] && str[i] <= '9') { ++i; }
+  return i;
+}
+
+br br_parseDecimal(const char* str, size_t len) {
+  br invalid = { BR_FINITE, false, NULL, { false, NULL }, { false, NULL } };
+  bool isNeg = false;
+  if (len != 0 && (str[0] == '+' || str[0] == '-')) {
+    isNeg = str[0] == '-';
+    str += 1; len -= 1;
+  }
+  if (matchWord(str, len, "inf") || matchWord(str, len, "infinity")) { return br_infinity(isNeg); }
+  if (matchWord(str, len, "nan")) { return br_nan(isNeg); }
+  // split into integer digits, fraction digits, and exponent
+  const char* intPart = str;
+  size_t intLen = spanDigits(str, len);
+  const char* fracPart = &str[intLen];
+  size_t fracLen = 0;
+  size_t i = intLen;
+  if (i < len && str[i] == '.') {
+    fracPart = &str[i + 1];
+    fracLen = spanDigits(fracPart, len - i - 1);
+    i += 1 + fracLen;
+  }
+  if (intLen + fracLen == 0) { return invalid; }
+  bz exp = bz_imax(0);
+  if (i < len && (str[i] == 'e' || str[i] == 'E')) {
+    i += 1;
+    bool expNeg = false;
+    if (i < len && (str[i] == '+' || str[i] == '-')) {
+      expNeg = str[i] == '-';
+      i += 1;
+    }
+    size_t expLen = spanDigits(&str[i], len - i);
+    bn* expDigits = bn_parse(&str[i], expLen, 10);
+    if (expDigits == NULL) { bz_free(exp); return invalid; }
+    bz_free(exp);
+    exp = expNeg ? bz_negative(expDigits) : bz_positive(expDigits);
+    bn_free(expDigits);
+    i += expLen;
+  }
+  if (i != len) { bz_free(exp); return invalid; }
+  // the significand is the digits on both sides of the point, each of which after it lowers the exponent
+  bn_parser* p = bn_parser_init(10);
+  bn_parser_feed(p, intPart, intLen);
+  bn_parser_feed(p, fracPart, fracLen);
+  bn* w = bn_parser_finish(p);
+  bz nFrac = bz_imax(fracLen);
+  bz q = bz_sub(exp, nFrac);
+  br out = br_decimal(isNeg, w, q);
+  bz_free(q);
+  bz_free(nFrac);
+  bz_free(exp);
+  bn_free(w);
+  return out;
+}
+
+// Return -1, 0, or 1 as `src` is negative, zero, or positive.
+static int sign(br src) {
+  if (src.kind == BR_FINITE && bn_nBits(src.significand) == 0) { return 0; }
+  return src.isNeg ? -1 : 1;
+}
+
+bl_ord br_cmp(br a, br b) {
+  assert(a.kind != BR_NAN && b.kind != BR_NAN);
+  int sa = sign(a), sb = sign(b);
+  if (sa != sb) { return sa < sb ? BL_LT : BL_GT; }
+  if (sa == 0) { return BL_EQ; }
+  bl_ord mag;
+  if (a.kind == BR_INFINITE || b.kind == BR_INFINITE) {
+    mag = a.kind == b.kind ? BL_EQ : a.kind == BR_INFINITE ? BL_GT : BL_LT;
+  }
+  else {
+    // settle numbers of different sizes before computing any powers of five
+    bz aLo, aHi, bLo, bHi;
+    log2Bounds(&aLo, &aHi, a);
+    log2Bounds(&bLo, &bHi, b);
+    bool below = bz_lte(aHi, bLo), above = bz_lte(bHi, aLo);
+    bz_free(aLo); bz_free(aHi); bz_free(bLo); bz_free(bHi);
+    if (below || above) { return (sa < 0) == below ? BL_GT : BL_LT; }
+    // scale both significands by the larger exponents, leaving integers to compare
+    bz e2 = bz_sub(a.exp2, b.exp2);
+    bz e5 = bz_sub(a.exp5, b.exp5);
+    intmax_t d2 = smallExp(e2);
+    intmax_t d5 = smallExp(e5);
+    bz_free(e2);
+    bz_free(e5);
+    bn* p5 = pow5(d5 < 0 ? -d5 : d5);
+    bn* x = bn_shl(a.significand, d2 > 0 ? d2 : 0);
+    bn* y = bn_shl(b.significand, d2 < 0 ? -d2 : 0);
+    bn* tmp = bn_mul(d5 > 0 ? x : y, p5);
+    if (d5 > 0) { bn_free(x); x = tmp; }
+    else { bn_free(y); y = tmp; }
+    mag = bn_cmp(x, y);
+    bn_free(p5);
+    bn_free(x);
+    bn_free(y);
+  }
+  return sa < 0 ? (bl_ord)-mag : mag;
+}
+
+void br_round(uint8_t* dst, br src, br_format fmt, br_rounding mode) {
+  if (src.kind != BR_FINITE) {
+    br__nonfinite(dst, fmt, src.isNeg, src.kind == BR_NAN);
+    return;
+  }
+  size_t nbits = bn_nBits(src.significand);
+  if (nbits == 0) {
+    br__round(dst, fmt, mode, src.isNeg, src.significand, 0, false);
+    return;
+  }
+  // settle numbers far outside every format before computing any powers of five
+  // (the widest format's exponents are well within ±2^15)
+  bz lo, hi;
+  log2Bounds(&lo, &hi, src);
+  bz limit = bz_imax(INTMAX_C(1) << 15);
+  bz negLimit = bz_neg(limit);
+  bool huge = bz_gt(lo, limit), tiny = bz_lt(hi, negLimit);
+  bz_free(negLimit);
+  bz_free(limit);
+  bz_free(hi);
+  bz_free(lo);
+  if (huge) {
+    br__round(dst, fmt, mode, src.isNeg, src.significand, INTMAX_MAX, false);
+    return;
+  }
+  if (tiny) {
+    br__round(dst, fmt, mode, src.isNeg, src.significand, INTMAX_MIN, false);
+    return;
+  }
+  intmax_t e2 = smallExp(src.exp2);
+  intmax_t e5 = smallExp(src.exp5);
+  if (e5 >= 0) {
+    bn* p5 = pow5(e5);
+    bn* x = bn_mul(src.significand, p5);
+    br__round(dst, fmt, mode, src.isNeg, x, e2, false);
+    bn_free(x);
+    bn_free(p5);
+  }
+  else {
+    // divide with enough quotient bits for the format to round from, and note any remainder
+    bn* p5 = pow5(-e5);
+    size_t want = br__precision(fmt) + 2 + bn_nBits(p5);
+    size_t k = want > nbits ? want - nbits : 0;
+    bn* num = bn_shl(src.significand, k);
+    struct bn_divmod qr = bn_divmod(num, p5);
+    br__round(dst, fmt, mode, src.isNeg, qr.div, e2 - (intmax_t)k, bn_nBits(qr.mod) != 0);
+    bn_free(qr.div);
+    bn_free(qr.mod);
+    bn_free(num);
+    bn_free(p5);
+  }
+}
+
+double br_toDouble(br src, br_rounding mode) {
+  uint8_t buf[8];
+  br_round(buf, src, BR_BINARY64, mode);
+  uint64_t bits = 0;
+  for (size_t i = 8; i > 0; --i) { bits = (bits << 8) | buf[i - 1]; }
+  double out;
+  memcpy(&out, &bits, sizeof(out));
+  return out;
+}
+
+float br_toFloat(br src, br_rounding mode) {
+  uint8_t buf[4];
+  br_round(buf, src, BR_BINARY32, mode);
+  uint32_t bits = 0;
+  for (size_t i = 4; i > 0; --i) { bits = (bits << 8) | buf[i - 1]; }
+  float out;
+  memcpy(&out, &bits, sizeof(out));
+  return out;
+}
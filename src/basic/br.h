@@ -0,0 +1,77 @@
+#ifndef BIGLIT_BASIC_BR
+#define BIGLIT_BASIC_BR
+
+#include "basic/bz.h"
+#include "core/br.h"
+
+// This interface uses the system allocator (or the one set with `bn_setAllocator`) to create exact reals,
+// and for any temporary space needed by a conversion (though most conversions of literals to double or float need none).
+// Conversions require the host's `double` and `float` to be IEEE binary64 and binary32.
+
+typedef br_format_ br_format;
+typedef br_rounding_ br_rounding;
+
+typedef enum {
+  BR_FINITE,
+  BR_INFINITE,
+  BR_NAN
+} br_kind;
+
+// An exact real number, as written in a float literal.
+// A finite number is `±significand × 2^exp2 × 5^exp5`, where the significand is odd, or zero (with both exponents zero).
+// The sign is kept apart from the significand so that zeros and infinities can be negative;
+// for infinities and NaNs, the significand and exponents are zero.
+// The power of five is what lets decimal literals such as `0.1` be stored exactly.
+// As with `bz`, call `br_free` on any `br` returned by this library.
+typedef struct br {
+  br_kind kind;
+  bool isNeg;
+  bn* significand;
+  bz exp2;
+  bz exp5;
+} br;
+
+////// Decimal Conversion //////
+
+// Return the double nearest to `w × 10^q` (ties to even), or infinity if it is too large.
+// For a float literal, `w` is the number formed by all its digits, and `q` its exponent less the number of digits after the point.
+double br_decimalToDouble(const bn* w, intmax_t q);
+
+// Return the float nearest to `w × 10^q` (ties to even), or infinity if it is too large.
+float br_decimalToFloat(const bn* w, intmax_t q);
+
+////// Exact Reals //////
+
+void br_free(br src);
+
+br br_copy(br src);
+
+br br_zero(bool isNeg);
+
+br br_infinity(bool isNeg);
+
+br br_nan(bool isNeg);
+
+// Create `±w × 2^exp`, as from a hexadecimal float literal.
+br br_binary(bool isNeg, const bn* w, bz exp);
+
+// Create `±w × 10^q`, where `w` and `q` are as for `br_decimalToDouble`.
+br br_decimal(bool isNeg, const bn* w, bz q);
+
+// Read a decimal float literal, such as `-1.25e-3`, or one of `inf`, `infinity` or `nan` (in any case), optionally signed.
+// The significand of the result is `NULL` if `str` is not such a literal.
+br br_parseDecimal(const char* str, size_t len);
+
+// Compare the values of two numbers exactly, neither of which may be NaN.
+// Negative zero is equal to positive zero.
+bl_ord br_cmp(br a, br b);
+
+// Write the IEEE encoding of `src` rounded to `fmt` into `dst`, least-significant byte first.
+// `dst` must have room for `br__sizeof_format(fmt)` bytes.
+void br_round(uint8_t* dst, br src, br_format fmt, br_rounding mode);
+
+double br_toDouble(br src, br_rounding mode);
+
+float br_toFloat(br src, br_rounding mode);
+
+#endif
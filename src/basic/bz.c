@@ -1,13 +1,20 @@
+#include "basic/alloc.h"
 #include "basic/bn.h"
 #include "basic/bz.h"
+#include "core/bz.h"
+#include "stats.h"
+
+#include <stdlib.h>
 
 ////// Initialization //////
 
 void bz_free(bz src) {
+  BL_STAT(0);
   bn_free(src.magnitude);
 }
 
 bz bz_imax(intmax_t src) {
+  BL_STAT(0);
   uintmax_t usrc;
   // the absolute value of INTMAX_MIN may not fit into uintmax_t
   if (src == INTMAX_MIN) {
@@ -22,6 +29,7 @@ bz bz_imax(intmax_t src) {
 }
 
 bz bz_copy(bz src) {
+  BL_STAT(src.magnitude->len);
   bz out = { .isNeg = src.isNeg, .magnitude = bn_copy(src.magnitude) };
   return out;
 }
@@ -29,17 +37,20 @@ bz bz_copy(bz src) {
 ////// Conversion //////
 
 bz bz_positive(const bn* src) {
+  BL_STAT(src->len);
   bz out = { .isNeg = false, .magnitude = bn_copy(src) };
   return out;
 }
 
 bz bz_negative(const bn* src) {
+  BL_STAT(src->len);
   bz out = { .isNeg = true, .magnitude = bn_copy(src) };
   if (out.magnitude->len == 0) { out.isNeg = false; }
   return out;
 }
 
 bn* bz_magnitude(bz src) {
+  BL_STAT(src.magnitude->len);
   bn* out = bn_copy(src.magnitude);
   return out;
 }
@@ -47,6 +58,7 @@ bn* bz_magnitude(bz src) {
 ////// Queries //////
 
 bl_ord bz_cmp(bz a, bz b) {
+  BL_STAT(a.magnitude->len + b.magnitude->len);
   if (a.isNeg && !b.isNeg) {
     return BL_LT; 
   }
@@ -62,21 +74,27 @@ bl_ord bz_cmp(bz a, bz b) {
 }
 
 bool bz_eq(bz a, bz b) {
+  BL_STAT(a.magnitude->len + b.magnitude->len);
   return bz_cmp(a, b) == BL_EQ;
 }
 bool bz_neq(bz a, bz b) {
+  BL_STAT(a.magnitude->len + b.magnitude->len);
   return bz_cmp(a, b) != BL_EQ;
 }
 bool bz_lt(bz a, bz b) {
+  BL_STAT(a.magnitude->len + b.magnitude->len);
   return bz_cmp(a, b) == BL_LT;
 }
 bool bz_lte(bz a, bz b) {
+  BL_STAT(a.magnitude->len + b.magnitude->len);
   return bz_cmp(a, b) != BL_GT;
 }
 bool bz_gt(bz a, bz b) {
+  BL_STAT(a.magnitude->len + b.magnitude->len);
   return bz_cmp(a, b) == BL_GT;
 }
 bool bz_gte(bz a, bz b) {
+  BL_STAT(a.magnitude->len + b.magnitude->len);
   return bz_cmp(a, b) != BL_LT;
 }
 
@@ -84,11 +102,13 @@ bool bz_gte(bz a, bz b) {
 ////// Arithmetic //////
 
 bz bz_neg(bz a) {
+  BL_STAT(a.magnitude->len);
   bz out = { .isNeg = !a.isNeg, .magnitude = bn_copy(a.magnitude) };
   return out;
 }
 
 bz bz_inc(bz a) {
+  BL_STAT(a.magnitude->len);
   if (a.isNeg) {
     bz out = { .isNeg = true, .magnitude = bn_dec(a.magnitude) };
     if (out.magnitude->len == 0) {
@@ -103,6 +123,7 @@ bz bz_inc(bz a) {
 }
 
 bz bz_add(bz a, bz b) {
+  BL_STAT(a.magnitude->len + b.magnitude->len);
   bz out;
   if (a.isNeg == b.isNeg) {
     out.isNeg = a.isNeg;
@@ -128,6 +149,7 @@ bz bz_add(bz a, bz b) {
 }
 
 bz bz_dec(bz a) {
+  BL_STAT(a.magnitude->len);
   if (a.isNeg) {
     bz out = { .isNeg = true, .magnitude = bn_inc(a.magnitude) };
     return out;
@@ -142,11 +164,13 @@ bz bz_dec(bz a) {
 }
 
 bz bz_sub(bz a, bz b) {
+  BL_STAT(a.magnitude->len + b.magnitude->len);
   b.isNeg = !b.isNeg;
   return bz_add(a, b);
 }
 
 bz bz_mul(bz a, bz b) {
+  BL_STAT(a.magnitude->len + b.magnitude->len);
   bn* m = bn_mul(a.magnitude, b.magnitude);
   if (m->len == 0) {
     bz out = { .isNeg = false, .magnitude = m };
@@ -159,6 +183,7 @@ bz bz_mul(bz a, bz b) {
 }
 
 struct bz_divmod bz_divmod(bz a, bz b) {
+  BL_STAT(a.magnitude->len + b.magnitude->len);
   struct bn_divmod res = bn_divmod(a.magnitude, b.magnitude);
   struct bz_divmod out = {
     .div = { .isNeg = false, .magnitude = res.div },
@@ -168,7 +193,8 @@ struct bz_divmod bz_divmod(bz a, bz b) {
     out.div.isNeg = (a.isNeg ^ b.isNeg) & (out.div.magnitude->len != 0);
   }
   else if (a.isNeg & !b.isNeg) {
-    out.div.isNeg = out.div.magnitude->len != 0;
+    // the incremented quotient is never zero, even when `|a| < b`
+    out.div.isNeg = true;
     {
       bn* tmp = bn_inc(out.div.magnitude);
       bn_free(out.div.magnitude);
@@ -199,13 +225,205 @@ struct bz_divmod bz_divmod(bz a, bz b) {
 }
 
 bz bz_div(bz a, bz b) {
+  BL_STAT(a.magnitude->len + b.magnitude->len);
   struct bz_divmod r = bz_divmod(a, b);
   bz_free(r.mod);
   return r.div;
 }
 
 bz bz_mod(bz a, bz b) {
+  BL_STAT(a.magnitude->len + b.magnitude->len);
   struct bz_divmod r = bz_divmod(a, b);
   bz_free(r.div);
   return r.mod;
 }
+
+////// Number Theory //////
+
+struct bn_gcdext bn_gcdext(const bn* a, const bn* b) {
+  BL_STAT(a->len + b->len);
+  struct bn_gcdext out = {
+    .gcd = bn_new(bn__sizeof_gcd(a, b), NULL),
+    .s = { .isNeg = false, .magnitude = bn_new(bn__sizeof_gcdext_s(a, b), NULL) },
+    .t = { .isNeg = false, .magnitude = bn_new(bn__sizeof_gcdext_t(a, b), NULL) },
+  };
+  bn_buffer* scratch = bn_new(bn__sizeof_gcdext_scratch(a, b), NULL);
+  bl_result err = bn__gcdext(out.gcd, &out.s, &out.t, a, b, scratch);
+  assert(err == BL_OK);
+  bl__free(scratch);
+  out.gcd = bn_create(out.gcd, SIZE_MAX);
+  out.s.magnitude = bn_create(out.s.magnitude, SIZE_MAX);
+  out.t.magnitude = bn_create(out.t.magnitude, SIZE_MAX);
+  return out;
+}
+
+////// Two's Complement //////
+
+// Normalize a result freshly computed into a `bn_new` buffer.
+static bz twosResult(bz out) {
+  out.magnitude = bn_create(out.magnitude, SIZE_MAX);
+  if (out.magnitude->len == 0) { out.isNeg = false; }
+  return out;
+}
+
+bool bz_bit(bz src, size_t i) {
+  BL_STAT(src.magnitude->len);
+  return bz__bit(src, i);
+}
+
+bz bz_and(bz a, bz b) {
+  BL_STAT(a.magnitude->len + b.magnitude->len);
+  bz out = { .magnitude = bn_new(bz__sizeof_bitwise(a, b), NULL) };
+  bl_result err = bz__and(&out, a, b);
+  assert(err == BL_OK);
+  return twosResult(out);
+}
+
+bz bz_or(bz a, bz b) {
+  BL_STAT(a.magnitude->len + b.magnitude->len);
+  bz out = { .magnitude = bn_new(bz__sizeof_bitwise(a, b), NULL) };
+  bl_result err = bz__or(&out, a, b);
+  assert(err == BL_OK);
+  return twosResult(out);
+}
+
+bz bz_xor(bz a, bz b) {
+  BL_STAT(a.magnitude->len + b.magnitude->len);
+  bz out = { .magnitude = bn_new(bz__sizeof_bitwise(a, b), NULL) };
+  bl_result err = bz__xor(&out, a, b);
+  assert(err == BL_OK);
+  return twosResult(out);
+}
+
+bz bz_not(bz a) {
+  BL_STAT(a.magnitude->len);
+  bz out = { .magnitude = bn_new(bz__sizeof_not(a), NULL) };
+  bl_result err = bz__not(&out, a);
+  assert(err == BL_OK);
+  return twosResult(out);
+}
+
+bz bz_shl(bz a, size_t amt) {
+  BL_STAT(a.magnitude->len);
+  bz out = { .isNeg = a.isNeg, .magnitude = bn_shl(a.magnitude, amt) };
+  if (out.magnitude->len == 0) { out.isNeg = false; }
+  return out;
+}
+
+bz bz_shr(bz a, size_t amt) {
+  BL_STAT(a.magnitude->len);
+  bz out = { .magnitude = bn_new(bz__sizeof_shr(a, amt), NULL) };
+  bl_result err = bz__shr(&out, a, amt);
+  assert(err == BL_OK);
+  return twosResult(out);
+}
+
+size_t bz_sizeofTwosComplement(bz src) {
+  BL_STAT(src.magnitude->len);
+  size_t nbits = bz__twos_bits(src);
+  return nbits / 8 + (nbits % 8 != 0);
+}
+
+bool bz_toTwosComplement(uint8_t* dst, size_t width, bz src) {
+  BL_STAT(src.magnitude->len);
+  return bz__twos_encode(dst, width, src) == BL_OK;
+}
+
+bz bz_fromTwosComplement(const uint8_t* src, size_t width) {
+  BL_STAT(width);
+  bz out = { .magnitude = bn_new(width, NULL) };
+  bl_result err = bz__twos_decode(&out, src, width);
+  assert(err == BL_OK);
+  return twosResult(out);
+}
+
+////// Wrapping Arithmetic //////
+
+// Return the low `nbits` bits of the two's complement of `src`, in a fresh buffer.
+static bn_* wrapUnsigned(bz src, size_t nbits) {
+  bn_* dst = bn_new(bz__sizeof_wrap(nbits), NULL);
+  bl_result err = bz__wrap(dst, src, nbits);
+  assert(err == BL_OK);
+  return dst;
+}
+
+// Reinterpret the `nbits`-bit `src` as signed, consuming it.
+static bz wrapSigned(bn_* src, size_t nbits) {
+  bz tmp = { .isNeg = false, .magnitude = src };
+  bz out = { .magnitude = bn_new(bz__sizeof_wrap(nbits), NULL) };
+  bl_result err = bz__wrap_signed(&out, tmp, nbits);
+  assert(err == BL_OK);
+  bl__free(src);
+  return twosResult(out);
+}
+
+bn* bz_wrapUnsigned(bz src, size_t nbits) {
+  BL_STAT(src.magnitude->len);
+  return bn_create(wrapUnsigned(src, nbits), SIZE_MAX);
+}
+
+bz bz_wrap(bz src, size_t nbits) {
+  BL_STAT(src.magnitude->len);
+  bz out = { .magnitude = bn_new(bz__sizeof_wrap(nbits), NULL) };
+  bl_result err = bz__wrap_signed(&out, src, nbits);
+  assert(err == BL_OK);
+  return twosResult(out);
+}
+
+bz bz_addWrap(bz a, bz b, size_t nbits) {
+  BL_STAT(a.magnitude->len + b.magnitude->len);
+  bn_* x = wrapUnsigned(a, nbits);
+  bn_* y = wrapUnsigned(b, nbits);
+  bn__add_wrap(x, x, y, nbits);
+  bl__free(y);
+  return wrapSigned(x, nbits);
+}
+
+bz bz_subWrap(bz a, bz b, size_t nbits) {
+  BL_STAT(a.magnitude->len + b.magnitude->len);
+  bn_* x = wrapUnsigned(a, nbits);
+  bn_* y = wrapUnsigned(b, nbits);
+  bn__sub_wrap(x, x, y, nbits);
+  bl__free(y);
+  return wrapSigned(x, nbits);
+}
+
+bz bz_mulWrap(bz a, bz b, size_t nbits) {
+  BL_STAT(a.magnitude->len + b.magnitude->len);
+  bn_* x = wrapUnsigned(a, nbits);
+  bn_* y = wrapUnsigned(b, nbits);
+  bn_* z = bn_new(bz__sizeof_wrap(nbits), NULL);
+  bn__mul_lo(z, x, y, nbits);
+  bl__free(x); bl__free(y);
+  return wrapSigned(z, nbits);
+}
+
+////// Serialization //////
+
+size_t bz_sizeofSleb128(bz src) {
+  BL_STAT(src.magnitude->len);
+  return bz__sizeof_sleb128(src);
+}
+
+size_t bz_toSleb128(uint8_t* dst, size_t dstLen, bz src) {
+  BL_STAT(src.magnitude->len);
+  if (bz__sleb128_encode(dst, dstLen, src) != BL_OK) { return 0; }
+  return bz__sizeof_sleb128(src);
+}
+
+bz bz_fromSleb128(const uint8_t* src, size_t srcLen, size_t* nRead) {
+  BL_STAT(srcLen);
+  size_t dummy;
+  if (nRead == NULL) { nRead = &dummy; }
+  bz out = { .isNeg = false, .magnitude = bn_new(bz__sizeof_sleb128_decode(src, srcLen), NULL) };
+  bl_result err = bz__sleb128_decode(&out, nRead, src, srcLen);
+  if (err == BL_SYNTAX) {
+    bl__free(out.magnitude);
+    out.magnitude = NULL;
+    return out;
+  }
+  assert(err == BL_OK);
+  out.magnitude = bn_create(out.magnitude, SIZE_MAX);
+  if (out.magnitude->len == 0) { out.isNeg = false; }
+  return out;
+}
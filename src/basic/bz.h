@@ -4,7 +4,8 @@
 #include "basic/bn.h"
 #include "core/bz_type.h"
 
-// This interface uses the system allocator (specifically `aligned_alloc`) to create memory for all results.
+// This interface uses the system allocator (specifically `malloc`) to create memory for all results,
+// unless another allocator is set with `bn_setAllocator`.
 // Results are always placed in a fresh pointer rather than attempt to share pointers.
 // Thus, to deallocate later, call `bz_free` on any `bz` returned by the functions of this library.
 // The only arithmetic error condition allowed is divide-by-zero, and this raises the FPE signal.
@@ -89,5 +90,70 @@ bz bz_div(bz a, bz b);
 
 bz bz_mod(bz a, bz b);
 
+////// Two's Complement //////
+
+// Bitwise operations and shifts act on the infinite two's-complement representation of integers,
+// so that e.g. `bz_and(x, bz_imax(-8))` rounds `x` down to a multiple of eight, as it would for a native integer.
+
+// Return bit `i` of the two's-complement representation of `src`.
+bool bz_bit(bz src, size_t i);
+
+bz bz_and(bz a, bz b);
+
+bz bz_or(bz a, bz b);
+
+bz bz_xor(bz a, bz b);
+
+// Return the bitwise complement of `a`, which is `-a - 1`.
+bz bz_not(bz a);
+
+// Return `a * 2^amt`.
+bz bz_shl(bz a, size_t amt);
+
+// Return `floor(a / 2^amt)`, an arithmetic shift.
+bz bz_shr(bz a, size_t amt);
+
+// Return the number of bytes in the shortest two's-complement representation of `src`.
+size_t bz_sizeofTwosComplement(bz src);
+
+// Write the low `width` bytes of the two's-complement representation of `src` to `dst`, least significant first.
+// Return whether `src` fit; if not, the bytes written are `src` wrapped modulo `2^(8·width)`.
+bool bz_toTwosComplement(uint8_t* dst, size_t width, bz src);
+
+// Read the `width`-byte two's-complement number at `src`, least significant first.
+bz bz_fromTwosComplement(const uint8_t* src, size_t width);
+
+////// Wrapping Arithmetic //////
+
+// These emulate the signed arithmetic of an `nbits`-wide two's-complement machine type:
+// results are brought into `[-2^(nbits-1), 2^(nbits-1))` by adding a multiple of `2^nbits`;
+// e.g. `bz_mulWrap(a, b, 64)` folds an `i64` multiplication.
+// Only the low `nbits` bits are ever computed.
+
+// Return `src mod 2^nbits`, which is how an unsigned `nbits`-wide type would hold `src`.
+bn* bz_wrapUnsigned(bz src, size_t nbits);
+
+// Return how a signed `nbits`-wide type would hold `src`.
+bz bz_wrap(bz src, size_t nbits);
+
+bz bz_addWrap(bz a, bz b, size_t nbits);
+
+bz bz_subWrap(bz a, bz b, size_t nbits);
+
+bz bz_mulWrap(bz a, bz b, size_t nbits);
+
+////// Serialization //////
+
+// Return the number of bytes in the signed LEB128 encoding of `src`.
+size_t bz_sizeofSleb128(bz src);
+
+// Write the signed LEB128 encoding of `src` to the start of `dst`.
+// Return the number of bytes written, or zero if `dstLen` is less than `bz_sizeofSleb128(src)`.
+size_t bz_toSleb128(uint8_t* dst, size_t dstLen, bz src);
+
+// Read a signed-LEB128-encoded number from the start of `src`, storing the number of bytes it occupied into `nRead` (if non-null).
+// When `src` ends before the encoding does, the magnitude of the result is `NULL`.
+bz bz_fromSleb128(const uint8_t* src, size_t srcLen, size_t* nRead);
+
 
 #endif
@@ -0,0 +1,45 @@
+#include "basic/compact.h"
+
+#include <assert.h>
+
+void bl_compactFree(bl_compact src) {
+  if (bl__compact_isOutOfLine(&src)) {
+    bn_free(src.large.magnitude);
+  }
+}
+
+bl_compact bl_compactFromBz(bz src) {
+  bl_compact out;
+  if (bl__compact_fits(src.magnitude)) {
+    bl_result err = bl__compact_inline(&out, src.isNeg, src.magnitude);
+    assert(err == BL_OK);
+  }
+  else {
+    bl__compact_outOfLine(&out, src.isNeg, bn_create(bn_copy(src.magnitude), SIZE_MAX));
+  }
+  return out;
+}
+
+bl_compact bl_compactFromBn(const bn* src) {
+  // the magnitude is only read, and `bz` is merely the shape of the argument
+  bz wrapped = { .isNeg = false, .magnitude = (bn*)src };
+  return bl_compactFromBz(wrapped);
+}
+
+bool bl_compactIsOutOfLine(bl_compact src) {
+  return bl__compact_isOutOfLine(&src);
+}
+
+bool bl_compactIsNeg(bl_compact src) {
+  return bl__compact_isNeg(&src);
+}
+
+const bn* bl_compactBn(bl_compact src, bl_compactView* buf) {
+  return bl__compact_magnitude(&src, buf);
+}
+
+bz bl_compactBz(bl_compact src, bl_compactView* buf) {
+  // the magnitude is only borrowed, and the `bz` interface never mutates its inputs
+  bz out = { .isNeg = bl__compact_isNeg(&src), .magnitude = (bn*)bl__compact_magnitude(&src, buf) };
+  return out;
+}
@@ -0,0 +1,43 @@
+#ifndef BIGLIT_BASIC_COMPACT
+#define BIGLIT_BASIC_COMPACT
+
+#include "basic/bn.h"
+#include "basic/bz.h"
+#include "core/compact.h"
+
+// A compact integer is a 16-byte handle, which is cheaper than a `bz` for holding many small numbers (e.g. the literals of a syntax tree).
+// Any integer below 2^120 in magnitude is held entirely within the handle, so creating one does not allocate;
+// larger ones are held out-of-line, in memory obtained like that of every other basic interface.
+// Handles are plain values: they may be copied, stored in arrays, and compared bytewise for equality (see `core/compact.h`),
+// but only one copy should be passed to `bl_compactFree`.
+//
+// Compact integers have no arithmetic of their own.
+// Instead, they are viewed as `bn` or `bz` (which cost no allocation either), and the results converted back.
+
+typedef bl__compact bl_compact;
+
+// Storage for the view of an inline magnitude; see `bl_compactBn`.
+typedef bl__compactView bl_compactView;
+
+// Release any out-of-line memory of `src`.
+void bl_compactFree(bl_compact src);
+
+// Create a compact integer from a copy of `src`.
+bl_compact bl_compactFromBz(bz src);
+
+// Create a non-negative compact integer from a copy of `src`.
+bl_compact bl_compactFromBn(const bn* src);
+
+// Return whether `src` holds memory out-of-line.
+bool bl_compactIsOutOfLine(bl_compact src);
+
+bool bl_compactIsNeg(bl_compact src);
+
+// Return the magnitude of `src`, borrowed either from `src` itself or from `buf`; it must not be passed to `bn_free`.
+// `buf` must outlive every use of the magnitude.
+const bn* bl_compactBn(bl_compact src, bl_compactView* buf);
+
+// Return `src` as an integer, whose magnitude is borrowed like that of `bl_compactBn`; it must not be passed to `bz_free`.
+bz bl_compactBz(bl_compact src, bl_compactView* buf);
+
+#endif
@@ -0,0 +1,90 @@
+#include "basic/alloc.h"
+#include "basic/expr.h"
+#include "core/expr.h"
+
+#include <signal.h>
+#include <stdlib.h>
+
+struct bl_expr {
+  bl__exprNode* nodes;
+  size_t len;
+  size_t cap;
+};
+
+bl_expr* bl_exprNew(void) {
+  bl_expr* e = bl__alloc(sizeof(bl_expr));
+  *e = (bl_expr){ .nodes = NULL, .len = 0, .cap = 0 };
+  return e;
+}
+
+void bl_exprFree(bl_expr* e) {
+  bl__free(e->nodes);
+  bl__free(e);
+}
+
+// Append `node` to the expression and return its index.
+static size_t push(bl_expr* e, bl__exprNode node) {
+  if (e->len == e->cap) {
+    size_t cap = e->cap == 0 ? 8 : 2 * e->cap;
+    e->nodes = bl__realloc(e->nodes, e->cap * sizeof(bl__exprNode), cap * sizeof(bl__exprNode));
+    e->cap = cap;
+  }
+  e->nodes[e->len] = node;
+  return e->len++;
+}
+
+static size_t unary(bl_expr* e, bl__exprOp op, size_t a, size_t amt) {
+  assert(a < e->len);
+  return push(e, (bl__exprNode){ .op = op, .a = a, .amt = amt });
+}
+
+static size_t binary(bl_expr* e, bl__exprOp op, size_t a, size_t b) {
+  assert(a < e->len && b < e->len);
+  return push(e, (bl__exprNode){ .op = op, .a = a, .b = b });
+}
+
+size_t bl_exprLeaf(bl_expr* e, bz src) {
+  return push(e, (bl__exprNode){ .op = BL__EXPR_LEAF, .leaf = src });
+}
+
+size_t bl_exprLeafBn(bl_expr* e, const bn* src) {
+  // the magnitude is only ever read
+  bz leaf = { .isNeg = false, .magnitude = (bn*)src };
+  return bl_exprLeaf(e, leaf);
+}
+
+size_t bl_exprNeg(bl_expr* e, size_t a) { return unary(e, BL__EXPR_NEG, a, 0); }
+size_t bl_exprNot(bl_expr* e, size_t a) { return unary(e, BL__EXPR_NOT, a, 0); }
+size_t bl_exprAdd(bl_expr* e, size_t a, size_t b) { return binary(e, BL__EXPR_ADD, a, b); }
+size_t bl_exprSub(bl_expr* e, size_t a, size_t b) { return binary(e, BL__EXPR_SUB, a, b); }
+size_t bl_exprMul(bl_expr* e, size_t a, size_t b) { return binary(e, BL__EXPR_MUL, a, b); }
+size_t bl_exprDiv(bl_expr* e, size_t a, size_t b) { return binary(e, BL__EXPR_DIV, a, b); }
+size_t bl_exprMod(bl_expr* e, size_t a, size_t b) { return binary(e, BL__EXPR_MOD, a, b); }
+size_t bl_exprAnd(bl_expr* e, size_t a, size_t b) { return binary(e, BL__EXPR_AND, a, b); }
+size_t bl_exprOr(bl_expr* e, size_t a, size_t b) { return binary(e, BL__EXPR_OR, a, b); }
+size_t bl_exprXor(bl_expr* e, size_t a, size_t b) { return binary(e, BL__EXPR_XOR, a, b); }
+size_t bl_exprShl(bl_expr* e, size_t a, size_t amt) { return unary(e, BL__EXPR_SHL, a, amt); }
+size_t bl_exprShr(bl_expr* e, size_t a, size_t amt) { return unary(e, BL__EXPR_SHR, a, amt); }
+
+bz bl_exprEval(bl_expr* e, size_t root) {
+  assert(root < e->len);
+  size_t n = root + 1;
+  // one block holds the plan followed by the arena, which is aligned like a `bn_` because the steps are
+  bl__exprStep* steps = bl__alloc(n * sizeof(bl__exprStep));
+  size_t arenaLen;
+  bl_result err = bl__expr_plan(steps, &arenaLen, e->nodes, n);
+  assert(err == BL_OK);
+  steps = bl__realloc(steps, n * sizeof(bl__exprStep), n * sizeof(bl__exprStep) + arenaLen);
+  bz value;
+  err = bl__expr_eval(&value, steps, e->nodes, n, (uint8_t*)&steps[n], arenaLen);
+  if (err == BL_DIVZERO) {
+    bl__free(steps);
+    raise(SIGFPE);
+    assert(false && "raise(SGFPE) returned");
+    exit(1);
+  }
+  assert(err == BL_OK);
+  bz out = bz_copy(value);
+  bl__free(steps);
+  return out;
+}
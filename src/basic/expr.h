@@ -0,0 +1,47 @@
+#ifndef BIGLIT_BASIC_EXPR
+#define BIGLIT_BASIC_EXPR
+
+#include "basic/bn.h"
+#include "basic/bz.h"
+
+// An expression is built up node by node, each function returning the index of the node it adds,
+// which may then be used as an operand of any number of later nodes, so that common subexpressions are evaluated once.
+// Evaluation plans the size of every intermediate result up front and computes them all in a single scratch allocation,
+// reusing the space of intermediates that are no longer needed (see `core/expr.h`),
+// which suits a compiler folding the constant expressions of a source file.
+//
+// Leaves are borrowed: they must outlive every evaluation of the expression, and are not released with it.
+// Division and remainder are Euclidean, as `bz_div` and `bz_mod`, and raise `SIGFPE` when dividing by zero.
+// Operands must be the indices of earlier nodes of the same expression.
+
+typedef struct bl_expr bl_expr;
+
+bl_expr* bl_exprNew(void);
+// Release the expression, but not its leaves.
+void bl_exprFree(bl_expr* e);
+
+size_t bl_exprLeaf(bl_expr* e, bz src);
+size_t bl_exprLeafBn(bl_expr* e, const bn* src);
+
+size_t bl_exprNeg(bl_expr* e, size_t a);
+// Add the bitwise complement of `a` (that is, `-a - 1`).
+size_t bl_exprNot(bl_expr* e, size_t a);
+size_t bl_exprAdd(bl_expr* e, size_t a, size_t b);
+size_t bl_exprSub(bl_expr* e, size_t a, size_t b);
+size_t bl_exprMul(bl_expr* e, size_t a, size_t b);
+size_t bl_exprDiv(bl_expr* e, size_t a, size_t b);
+size_t bl_exprMod(bl_expr* e, size_t a, size_t b);
+// Add the bitwise and/or/xor of `a` and `b`, as `bz_and`/`bz_or`/`bz_xor`.
+size_t bl_exprAnd(bl_expr* e, size_t a, size_t b);
+size_t bl_exprOr(bl_expr* e, size_t a, size_t b);
+size_t bl_exprXor(bl_expr* e, size_t a, size_t b);
+// Add `a * 2^amt`.
+size_t bl_exprShl(bl_expr* e, size_t a, size_t amt);
+// Add `floor(a / 2^amt)`.
+size_t bl_exprShr(bl_expr* e, size_t a, size_t amt);
+
+// Return the value of node `root`, evaluating only the nodes it depends on.
+// The same expression may be evaluated any number of times, for instance at different roots.
+bz bl_exprEval(bl_expr* e, size_t root);
+
+#endif
@@ -0,0 +1,142 @@
+#if defined(__unix__) || defined(__APPLE__)
+#define _POSIX_C_SOURCE 200809L
+#define BL_POOL_MMAP 1
+#else
+#define BL_POOL_MMAP 0
+#endif
+
+#include "basic/alloc.h"
+#include "basic/pool.h"
+#include "core/pool.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if BL_POOL_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+struct bl_pool {
+  bl__pool view;
+  void* mem;
+  size_t memLen;
+};
+
+#if BL_POOL_MMAP
+
+// The file is written beside `path` and renamed over it once on disk,
+// so that a reader never sees it half-written, and one that has the old file mapped keeps reading the old file.
+bool bl_poolWrite(const char* path, const bz* entries, size_t n) {
+  size_t len = bl__sizeof_pool(entries, n);
+  size_t tmpLen = strlen(path) + 32;
+  char* tmp = bl__alloc(tmpLen);
+  snprintf(tmp, tmpLen, "%s.tmp.%ld", path, (long)getpid());
+  bool ok = false;
+  int fd = open(tmp, O_RDWR | O_CREAT | O_TRUNC, 0666);
+  if (fd >= 0) {
+    void* mem = ftruncate(fd, len) == 0 ? mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+    if (mem != MAP_FAILED) {
+      bl_result err = bl__pool_write(mem, len, entries, n);
+      assert(err == BL_OK);
+      ok = msync(mem, len, MS_SYNC) == 0;
+      ok = (munmap(mem, len) == 0) && ok;
+      ok = ok && fsync(fd) == 0;
+    }
+    ok = (close(fd) == 0) && ok;
+    ok = ok && rename(tmp, path) == 0;
+    if (!ok) { unlink(tmp); }
+  }
+  bl__free(tmp);
+  return ok;
+}
+
+bl_pool* bl_poolOpen(const char* path) {
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) { return NULL; }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size <= 0) { close(fd); return NULL; }
+  size_t len = st.st_size;
+  void* mem = mmap(NULL, len, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mem == MAP_FAILED) { return NULL; }
+  bl_pool* pool = bl__alloc(sizeof(bl_pool));
+  pool->mem = mem;
+  pool->memLen = len;
+  if (bl__pool_open(&pool->view, mem, len) != BL_OK) {
+    bl_poolClose(pool);
+    return NULL;
+  }
+  return pool;
+}
+
+void bl_poolClose(bl_pool* pool) {
+  munmap(pool->mem, pool->memLen);
+  bl__free(pool);
+}
+
+#else
+
+// As above, the file is written beside `path` first; without POSIX, an existing file is removed before the rename.
+bool bl_poolWrite(const char* path, const bz* entries, size_t n) {
+  size_t len = bl__sizeof_pool(entries, n);
+  uint8_t* mem = bl__alloc(len);
+  bl_result err = bl__pool_write(mem, len, entries, n);
+  assert(err == BL_OK);
+  size_t tmpLen = strlen(path) + 8;
+  char* tmp = bl__alloc(tmpLen);
+  snprintf(tmp, tmpLen, "%s.tmp", path);
+  FILE* fp = fopen(tmp, "wb");
+  bool ok = fp != NULL && fwrite(mem, 1, len, fp) == len && fflush(fp) == 0;
+  if (fp != NULL) { ok = (fclose(fp) == 0) && ok; }
+  if (ok) {
+    remove(path);
+    ok = rename(tmp, path) == 0;
+  }
+  if (!ok) { remove(tmp); }
+  bl__free(tmp);
+  bl__free(mem);
+  return ok;
+}
+
+bl_pool* bl_poolOpen(const char* path) {
+  FILE* fp = fopen(path, "rb");
+  if (fp == NULL) { return NULL; }
+  if (fseek(fp, 0, SEEK_END) != 0) { fclose(fp); return NULL; }
+  long len = ftell(fp);
+  if (len <= 0 || fseek(fp, 0, SEEK_SET) != 0) { fclose(fp); return NULL; }
+  bl_pool* pool = bl__alloc(sizeof(bl_pool));
+  pool->mem = bl__alloc(len);
+  pool->memLen = len;
+  bool ok = fread(pool->mem, 1, len, fp) == (size_t)len;
+  fclose(fp);
+  if (!ok || bl__pool_open(&pool->view, pool->mem, len) != BL_OK) {
+    bl_poolClose(pool);
+    return NULL;
+  }
+  return pool;
+}
+
+void bl_poolClose(bl_pool* pool) {
+  bl__free(pool->mem);
+  bl__free(pool);
+}
+
+#endif
+
+size_t bl_poolCount(const bl_pool* pool) {
+  return pool->view.count;
+}
+
+const bn* bl_poolBn(const bl_pool* pool, size_t i) {
+  return bl__pool_get(&pool->view, i);
+}
+
+bz bl_poolBz(const bl_pool* pool, size_t i) {
+  // the magnitude is only borrowed, and the `bz` interface never mutates its inputs
+  bz out = { .isNeg = bl__pool_isNeg(&pool->view, i), .magnitude = (bn*)bl__pool_get(&pool->view, i) };
+  return out;
+}
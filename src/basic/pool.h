@@ -0,0 +1,37 @@
+#ifndef BIGLIT_BASIC_POOL
+#define BIGLIT_BASIC_POOL
+
+#include "basic/bn.h"
+#include "basic/bz.h"
+
+// A pool is a file holding many numbers, which can be loaded back without copying or per-number allocation.
+// On POSIX systems, loading is done with `mmap`, and the numbers handed out point directly into the mapping,
+// so only the pages actually touched are ever read from disk.
+// Pool files are native to the machine that wrote them (see `core/pool.h`); they are meant as caches, not interchange.
+
+typedef struct bl_pool bl_pool;
+
+// Write the `n` entries to a new pool file at `path`, replacing any existing file (pools already open on it are unaffected).
+// Natural numbers can be stored with `bz_positive` or as `{ .isNeg = false, .magnitude = n }`.
+// Returns false if the file could not be written.
+bool bl_poolWrite(const char* path, const bz* entries, size_t n);
+
+// Load the pool file at `path`.
+// Returns `NULL` if the file cannot be read, or was not written as a pool by a compatible machine.
+bl_pool* bl_poolOpen(const char* path);
+
+// Release the pool.
+// This ends the lifetime of every number obtained from it.
+void bl_poolClose(bl_pool* pool);
+
+size_t bl_poolCount(const bl_pool* pool);
+
+// Return the magnitude of entry `i`, borrowed from the pool.
+// Returns `NULL` if `i` is out of range, or the entry is corrupt.
+const bn* bl_poolBn(const bl_pool* pool, size_t i);
+
+// Return entry `i` as an integer whose magnitude is borrowed from the pool; it must not be passed to `bz_free`.
+// If `i` is out of range, or the entry is corrupt, the magnitude is `NULL`.
+bz bl_poolBz(const bl_pool* pool, size_t i);
+
+#endif
@@ -0,0 +1,209 @@
+#if defined(__unix__) || defined(__APPLE__)
+#define _POSIX_C_SOURCE 200809L
+#define BL_WORKERS_PTHREAD 1
+#else
+#define BL_WORKERS_PTHREAD 0
+#endif
+
+#include "basic/alloc.h"
+#include "basic/workers.h"
+#include "core/bn.h"
+#include "stats.h"
+
+#include <assert.h>
+#include <stdlib.h>
+
+#if BL_WORKERS_PTHREAD
+#include <pthread.h>
+#endif
+
+// Products of operands shorter than this many words are not worth handing to another thread.
+#define MIN_PARALLEL_WORDS 256
+
+#if BL_WORKERS_PTHREAD
+
+// Tasks wait on a single shared stack.
+// A thread joining a task that has not finished does not sleep while there is work to do:
+// it takes (steals) the most recently forked task and runs it, which is very likely to be part of the same computation.
+// Sub-products are only forked for huge operands, so there are few tasks, and the lock is rarely contended.
+typedef struct task {
+  void (*fn)(void*);
+  void* arg;
+  bool done;
+  struct task* next;
+} task;
+
+struct bl_workers {
+  pthread_mutex_t lock;
+  pthread_cond_t queued;
+  pthread_cond_t finished;
+  task* stack;
+  bool stop;
+  size_t nThreads;
+  pthread_t threads[];
+};
+
+// Run `t`, which has already been popped, with the lock released; return with the lock held again.
+static void runLocked(bl_workers* w, task* t) {
+  pthread_mutex_unlock(&w->lock);
+  t->fn(t->arg);
+  pthread_mutex_lock(&w->lock);
+  t->done = true;
+  pthread_cond_broadcast(&w->finished);
+}
+
+static task* pop(bl_workers* w) {
+  task* t = w->stack;
+  w->stack = t->next;
+  return t;
+}
+
+static void* workerMain(void* arg) {
+  bl_workers* w = arg;
+  pthread_mutex_lock(&w->lock);
+  for (;;) {
+    while (w->stack == NULL && !w->stop) { pthread_cond_wait(&w->queued, &w->lock); }
+    if (w->stack == NULL) { break; }
+    runLocked(w, pop(w));
+  }
+  pthread_mutex_unlock(&w->lock);
+  return NULL;
+}
+
+static void* forkTask(void* ctx, void (*fn)(void*), void* arg) {
+  bl_workers* w = ctx;
+  task* t = bl__alloc(sizeof(task));
+  t->fn = fn;
+  t->arg = arg;
+  t->done = false;
+  pthread_mutex_lock(&w->lock);
+  t->next = w->stack;
+  w->stack = t;
+  pthread_cond_signal(&w->queued);
+  pthread_mutex_unlock(&w->lock);
+  return t;
+}
+
+static void joinTask(void* ctx, void* handle) {
+  bl_workers* w = ctx;
+  task* t = handle;
+  pthread_mutex_lock(&w->lock);
+  while (!t->done) {
+    if (w->stack != NULL) { runLocked(w, pop(w)); }
+    else { pthread_cond_wait(&w->finished, &w->lock); }
+  }
+  pthread_mutex_unlock(&w->lock);
+  bl__free(t);
+}
+
+bl_workers* bl_workersNew(size_t nThreads) {
+  bl_workers* w = bl__alloc(sizeof(bl_workers) + nThreads * sizeof(pthread_t));
+  pthread_mutex_init(&w->lock, NULL);
+  pthread_cond_init(&w->queued, NULL);
+  pthread_cond_init(&w->finished, NULL);
+  w->stack = NULL;
+  w->stop = false;
+  w->nThreads = 0;
+  for (size_t i = 0; i < nThreads; ++i) {
+    if (pthread_create(&w->threads[i], NULL, workerMain, w) != 0) { break; }
+    w->nThreads += 1;
+  }
+  return w;
+}
+
+void bl_workersFree(bl_workers* w) {
+  pthread_mutex_lock(&w->lock);
+  w->stop = true;
+  pthread_cond_broadcast(&w->queued);
+  pthread_mutex_unlock(&w->lock);
+  for (size_t i = 0; i < w->nThreads; ++i) { pthread_join(w->threads[i], NULL); }
+  pthread_cond_destroy(&w->finished);
+  pthread_cond_destroy(&w->queued);
+  pthread_mutex_destroy(&w->lock);
+  bl__free(w);
+}
+
+#else
+
+struct bl_workers {
+  size_t nThreads;
+};
+
+static void* forkTask(void* ctx, void (*fn)(void*), void* arg) {
+  fn(arg);
+  return NULL;
+}
+
+static void joinTask(void* ctx, void* handle) {
+}
+
+bl_workers* bl_workersNew(size_t nThreads) {
+  bl_workers* w = bl__alloc(sizeof(bl_workers));
+  w->nThreads = 0;
+  return w;
+}
+
+void bl_workersFree(bl_workers* w) {
+  bl__free(w);
+}
+
+#endif
+
+static bn_* alloc(size_t nDigits) {
+  bn_* out = bl__alloc(sizeof(bn_) + nDigits);
+  out->len = nDigits;
+  return out;
+}
+
+// Return a description of the workers for the core, or `NULL` if there are none to fork onto.
+static const bl__fork* forkOnto(bl__fork* par, bl_workers* workers) {
+  par->fork = forkTask;
+  par->join = joinTask;
+  par->ctx = workers;
+  par->minWords = MIN_PARALLEL_WORDS;
+  // with no threads to help, forking would only cost scratch space
+  return workers->nThreads == 0 ? NULL : par;
+}
+
+bn* bn_mulParallel(const bn* a, const bn* b, bl_workers* workers) {
+  BL_STAT(a->len + b->len);
+  bl__fork storage;
+  const bl__fork* par = forkOnto(&storage, workers);
+  size_t nDigits = bn__sizeof_mul(a, b);
+  bn_* dst = alloc(nDigits);
+  bn_* scratch = alloc(bn__sizeof_karatsuba_scratch(a, b, par));
+  bl_result err = bn__karatsuba(dst, a, b, scratch, par);
+  assert(err == BL_OK);
+  bl__free(scratch);
+  return bl__fit(dst, nDigits);
+}
+
+bn* bn_parseParallel(const char* str, size_t len, unsigned radix, bl_workers* workers) {
+  BL_STAT(len);
+  assert(2 <= radix && radix <= 36);
+  bl__fork storage;
+  const bl__fork* par = forkOnto(&storage, workers);
+  size_t nDigits = bn__sizeof_parse(len, radix);
+  bn_* dst = alloc(nDigits);
+  bn_* scratch = alloc(bn__sizeof_parse_scratch(len, radix, par));
+  bl_result err = bn__parse(dst, str, len, radix, scratch, par);
+  bl__free(scratch);
+  if (err != BL_OK) {
+    bl__free(dst);
+    return NULL;
+  }
+  return bl__fit(dst, nDigits);
+}
+
+size_t bn_formatParallel(char* dst, size_t dstLen, const bn* src, unsigned radix, bl_workers* workers) {
+  BL_STAT(src->len);
+  if (dstLen < bn__sizeof_format(src, radix)) { return 0; }
+  bl__fork storage;
+  const bl__fork* par = forkOnto(&storage, workers);
+  bn_* scratch = alloc(bn__sizeof_format_scratch(src, radix, par));
+  size_t out;
+  bl_result err = bn__format(dst, dstLen, &out, src, radix, scratch, par);
+  assert(err == BL_OK);
+  bl__free(scratch);
+  return out;
+}
@@ -0,0 +1,31 @@
+#ifndef BIGLIT_BASIC_WORKERS
+#define BIGLIT_BASIC_WORKERS
+
+#include "basic/bn.h"
+
+// A set of worker threads which the arithmetic on huge numbers can spread its work over.
+// There is no global state: a computation only uses the workers it is explicitly handed,
+// and the same workers may be shared by computations on several threads at once.
+// Operands below a (large) threshold are always computed serially on the calling thread,
+// and the results are always identical to those of the serial functions.
+// Where POSIX threads are unavailable, the workers do nothing and all work runs on the calling thread.
+
+typedef struct bl_workers bl_workers;
+
+// Start `nThreads` worker threads, which help the calling thread of any computation they are handed.
+bl_workers* bl_workersNew(size_t nThreads);
+
+// Stop the worker threads and release them.
+// No computation may be using them.
+void bl_workersFree(bl_workers* workers);
+
+// Return `a * b`, as `bn_mul`, with the sub-products of huge operands spread over the workers.
+bn* bn_mulParallel(const bn* a, const bn* b, bl_workers* workers);
+
+// As `bn_parse`, with the halves of huge literals converted by different workers.
+bn* bn_parseParallel(const char* str, size_t len, unsigned radix, bl_workers* workers);
+
+// As `bn_format`, with the halves of huge numbers converted by different workers.
+size_t bn_formatParallel(char* dst, size_t dstLen, const bn* src, unsigned radix, bl_workers* workers);
+
+#endif
@@ -12,7 +12,8 @@ static_assert((int16_t)-1 >> 1 == -1, "target does not perform arithmetic shift
 typedef enum {
   BL_OK = 0,
   BL_OVERFLOW,
-  BL_DIVZERO
+  BL_DIVZERO,
+  BL_SYNTAX
 } bl_result;
 
 typedef enum {
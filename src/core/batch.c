@@ -0,0 +1,190 @@
+#include "core/batch.h"
+#include "core/bz.h"
+#include "core/limb.h"
+#include "stats.h"
+
+#include <string.h>
+
+static inline size_t min(size_t a, size_t b) {
+  return a < b ? a : b;
+}
+
+// Return the digits in all `n` lanes of `a`, for the instrumentation.
+static inline size_t lanesLen(const bn_* const a[], size_t n) {
+  size_t out = 0;
+  for (size_t i = 0; i < n; ++i) { out += a[i]->len; }
+  return out;
+}
+
+// Likewise for the magnitudes of `src`.
+static inline size_t zLanesLen(const bz_ src[], size_t n) {
+  size_t out = 0;
+  for (size_t i = 0; i < n; ++i) { out += src[i].magnitude->len; }
+  return out;
+}
+
+// Lanes are processed this many at a time, so that the word arrays of a block stay in registers or at least in L1.
+#define LANES 16
+
+// Return whether lanes `[i0, i0 + m)` of `a` and `b` all fit in a word.
+static bool smallBlock(const bn_* const a[], const bn_* const b[], size_t i0, size_t m) {
+  bool out = true;
+  for (size_t k = 0; k < m; ++k) {
+    out &= a[i0 + k]->len <= 8 && b[i0 + k]->len <= 8;
+  }
+  return out;
+}
+
+// Gather the words of lanes `[i0, i0 + m)` of `src` into `dst`, padding the block with zeros.
+static void gather(uint64_t dst[LANES], const bn_* const src[], size_t i0, size_t m) {
+  for (size_t k = 0; k < LANES; ++k) {
+    dst[k] = k < m ? bn__loadN(&src[i0 + k]->base256le[0], src[i0 + k]->len) : 0;
+  }
+}
+
+// Store the word `w` into the low (up to eight) digits of `dst`, then `hi` into the rest.
+static void scatter(bn_* dst, uint64_t w, uint64_t hi) {
+  size_t lo = min(dst->len, 8);
+  bn__storeN(&dst->base256le[0], w, lo);
+  if (dst->len > 8) { bn__storeN(&dst->base256le[8], hi, dst->len - 8); }
+}
+
+////// Arithmetic //////
+
+size_t bn__sizeof_batch_add(const bn_* const a[], const bn_* const b[], size_t n) {
+  BL_STAT(lanesLen(a, n) + lanesLen(b, n));
+  size_t out = 0;
+  for (size_t i = 0; i < n; ++i) {
+    out += bn__sizeof_carve(bn__sizeof_add(a[i], b[i]));
+  }
+  return out;
+}
+
+bl_result bn__batch_add(bn_* dst[], const bn_* const a[], const bn_* const b[], size_t n, uint8_t* mem, size_t memLen) {
+  BL_STAT(lanesLen(a, n) + lanesLen(b, n));
+  uint8_t* at = mem;
+  for (size_t i = 0; i < n; ++i) {
+    dst[i] = bn__carve(&at, mem + memLen, bn__sizeof_add(a[i], b[i]));
+    if (dst[i] == NULL) { return BL_OVERFLOW; }
+  }
+  for (size_t i0 = 0; i0 < n; i0 += LANES) {
+    size_t m = min(LANES, n - i0);
+    if (smallBlock(a, b, i0, m)) {
+      uint64_t x[LANES], y[LANES], s[LANES], c[LANES];
+      gather(x, a, i0, m);
+      gather(y, b, i0, m);
+      for (size_t k = 0; k < LANES; ++k) {
+        s[k] = x[k] + y[k];
+        c[k] = s[k] < x[k];
+      }
+      for (size_t k = 0; k < m; ++k) { scatter(dst[i0 + k], s[k], c[k]); }
+    }
+    else {
+      for (size_t k = i0; k < i0 + m; ++k) {
+        // `bn__add` leaves the top digit alone when nothing carries into it
+        bn__blank(dst[k]);
+        bl_result err = bn__add(dst[k], a[k], b[k]);
+        if (err != BL_OK) { return err; }
+      }
+    }
+  }
+  return BL_OK;
+}
+
+size_t bn__sizeof_batch_mul(const bn_* const a[], const bn_* const b[], size_t n) {
+  BL_STAT(lanesLen(a, n) + lanesLen(b, n));
+  size_t out = 0;
+  for (size_t i = 0; i < n; ++i) {
+    out += bn__sizeof_carve(bn__sizeof_mul(a[i], b[i]));
+  }
+  return out;
+}
+
+bl_result bn__batch_mul(bn_* dst[], const bn_* const a[], const bn_* const b[], size_t n, uint8_t* mem, size_t memLen) {
+  BL_STAT(lanesLen(a, n) + lanesLen(b, n));
+  uint8_t* at = mem;
+  for (size_t i = 0; i < n; ++i) {
+    dst[i] = bn__carve(&at, mem + memLen, bn__sizeof_mul(a[i], b[i]));
+    if (dst[i] == NULL) { return BL_OVERFLOW; }
+  }
+  for (size_t i0 = 0; i0 < n; i0 += LANES) {
+    size_t m = min(LANES, n - i0);
+    if (smallBlock(a, b, i0, m)) {
+      uint64_t x[LANES], y[LANES], lo[LANES], hi[LANES];
+      gather(x, a, i0, m);
+      gather(y, b, i0, m);
+      for (size_t k = 0; k < LANES; ++k) {
+        lo[k] = bn__mul64(x[k], y[k], &hi[k]);
+      }
+      for (size_t k = 0; k < m; ++k) { scatter(dst[i0 + k], lo[k], hi[k]); }
+    }
+    else {
+      for (size_t k = i0; k < i0 + m; ++k) {
+        bn__blank(dst[k]);
+        bl_result err = bn__mul(dst[k], a[k], b[k]);
+        if (err != BL_OK) { return err; }
+      }
+    }
+  }
+  return BL_OK;
+}
+
+////// Queries //////
+
+void bn__batch_cmp(bl_ord dst[], const bn_* const a[], const bn_* const b[], size_t n) {
+  BL_STAT(lanesLen(a, n) + lanesLen(b, n));
+  for (size_t i0 = 0; i0 < n; i0 += LANES) {
+    size_t m = min(LANES, n - i0);
+    if (smallBlock(a, b, i0, m)) {
+      uint64_t x[LANES], y[LANES];
+      int ord[LANES];
+      gather(x, a, i0, m);
+      gather(y, b, i0, m);
+      for (size_t k = 0; k < LANES; ++k) {
+        ord[k] = (x[k] > y[k]) - (x[k] < y[k]);
+      }
+      for (size_t k = 0; k < m; ++k) { dst[i0 + k] = (bl_ord)ord[k]; }
+    }
+    else {
+      for (size_t k = i0; k < i0 + m; ++k) { dst[k] = bn__cmp(a[k], b[k]); }
+    }
+  }
+}
+
+void bn__batch_fits(bool dst[], const bn_* const src[], size_t n, size_t nbits) {
+  BL_STAT(lanesLen(src, n));
+  for (size_t i = 0; i < n; ++i) {
+    const bn_* x = src[i];
+    // most lanes are settled by their length alone
+    if (8 * x->len <= nbits) { dst[i] = true; continue; }
+    size_t len = x->len;
+    while (len != 0 && x->base256le[len - 1] == 0) { --len; }
+    dst[i] = len == 0 || 8 * (len - 1) + bn__bitlen64(x->base256le[len - 1]) <= nbits;
+  }
+}
+
+void bz__batch_fits(bool dst[], const bz_ src[], size_t n, size_t nbits) {
+  BL_STAT(zLanesLen(src, n));
+  for (size_t i0 = 0; i0 < n; i0 += LANES) {
+    size_t m = min(LANES, n - i0);
+    bool small = nbits != 0 && nbits <= 64;
+    for (size_t k = i0; small && k < i0 + m; ++k) { small = src[k].magnitude->len <= 8; }
+    if (small) {
+      // a magnitude fits exactly when it is at most `2^(nbits-1)`, less one if it is non-negative
+      uint64_t x[LANES], limit[LANES];
+      bool ok[LANES];
+      uint64_t half = UINT64_C(1) << (nbits - 1);
+      for (size_t k = 0; k < LANES; ++k) {
+        x[k] = k < m ? bn__loadN(&src[i0 + k].magnitude->base256le[0], src[i0 + k].magnitude->len) : 0;
+        limit[k] = k < m && src[i0 + k].isNeg ? half : half - 1;
+      }
+      for (size_t k = 0; k < LANES; ++k) {
+        ok[k] = x[k] <= limit[k];
+      }
+      memcpy(&dst[i0], ok, m * sizeof(bool));
+    }
+    else {
+      for (size_t k = i0; k < i0 + m; ++k) { dst[k] = bz__twos_bits(src[k]) <= nbits; }
+    }
+  }
+}
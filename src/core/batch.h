@@ -0,0 +1,39 @@
+#ifndef BIGLIT_CORE_BATCH
+#define BIGLIT_CORE_BATCH
+
+// This is the core interface for evaluating many independent operations at once,
+// such as range-checking every value of an enum or every label of a switch.
+// Lane `i` of a batch operation combines `a[i]` with `b[i]` and writes `dst[i]`.
+// Rather than a size query and a destination per lane, the results of a whole batch are carved out of one block of memory,
+// and lanes are processed in blocks: when every operand of a block fits in a machine word,
+// its lanes are gathered into word arrays and computed by loops with no per-digit work (which compilers can vectorize),
+// and otherwise each lane falls back on the usual kernel.
+
+#include "core/bz_type.h"
+
+// Return the number of bytes of memory needed to hold the results of `bn__batch_add(dst, a, b, n, …)`.
+size_t bn__sizeof_batch_add(const bn_* const a[], const bn_* const b[], size_t n);
+
+// Carve a result for each lane out of the `memLen` bytes at `mem` (which should be aligned like a `bn_`), and place `a[i] + b[i]` in it.
+// Pointers to the results are stored in `dst`; the first is at the start of `mem`.
+// Inputs need not be normalized, and the outputs are not normalized.
+// `BL_OVERFLOW` is returned if `memLen` is less than `bn__sizeof_batch_add(a, b, n)`, in which case the contents of `dst` are undefined.
+bl_result bn__batch_add(bn_* dst[], const bn_* const a[], const bn_* const b[], size_t n, uint8_t* mem, size_t memLen);
+
+// As the `batch_add` functions, but for `a[i] * b[i]`.
+size_t bn__sizeof_batch_mul(const bn_* const a[], const bn_* const b[], size_t n);
+bl_result bn__batch_mul(bn_* dst[], const bn_* const a[], const bn_* const b[], size_t n, uint8_t* mem, size_t memLen);
+
+// Store whether `a[i]` is less than/equal to/greater than `b[i]` in `dst[i]`.
+// This function does not require input normalization.
+void bn__batch_cmp(bl_ord dst[], const bn_* const a[], const bn_* const b[], size_t n);
+
+// Store whether `src[i]` fits in an unsigned type of `nbits` bits (that is, `src[i] < 2^nbits`) in `dst[i]`.
+// This function does not require input normalization.
+void bn__batch_fits(bool dst[], const bn_* const src[], size_t n, size_t nbits);
+
+// Store whether `src[i]` fits in a two's-complement type of `nbits` bits (that is, `-2^(nbits-1) ≤ src[i] < 2^(nbits-1)`) in `dst[i]`.
+// This function does not require input normalization.
+void bz__batch_fits(bool dst[], const bz_ src[], size_t n, size_t nbits);
+
+#endif
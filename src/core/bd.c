@@ -0,0 +1,262 @@
+#include "core/bd.h"
+#include "core/limb.h"
+
+#include <string.h>
+
+static inline size_t min(size_t a, size_t b) {
+  return a < b ? a : b;
+}
+
+static inline size_t max(size_t a, size_t b) {
+  return a > b ? a : b;
+}
+
+#define SIXES UINT64_C(0x6666666666666666)
+// the lowest bit of every nibble but the first: where a carry or borrow out of the nibble below arrives
+#define NIBBLE_CARRIES UINT64_C(0x1111111111111110)
+
+// Return the eight bytes of digits starting at byte `i`, reading bytes past the end as zero.
+static uint64_t loadWord(const bd_* src, size_t i) {
+  if (i >= src->len) { return 0; }
+  if (src->len - i >= 8) { return bn__load64(&src->bcdle[i]); }
+  return bn__loadN(&src->bcdle[i], src->len - i);
+}
+
+// Store eight bytes of digits starting at byte `i`, failing if any non-zero digits fall past the end of `dst`.
+static bl_result storeWord(bd_* dst, size_t i, uint64_t w) {
+  size_t room = i >= dst->len ? 0 : min(dst->len - i, 8);
+  if (room < 8 && (w >> (8 * room)) != 0) { return BL_OVERFLOW; }
+  if (room == 8) { bn__store64(&dst->bcdle[i], w); }
+  else if (room != 0) { bn__storeN(&dst->bcdle[i], w, room); }
+  return BL_OK;
+}
+
+////// Initialization //////
+
+size_t bd__sizeof(size_t nDigits) {
+  return sizeof(bd_) + (nDigits + 1) / 2;
+}
+
+void bd__blank(bd_* dst) {
+  memset(&dst->bcdle[0], 0, dst->len);
+}
+
+void bd__normalize(bd_* dst) {
+  while (dst->len != 0 && dst->bcdle[dst->len - 1] == 0) { --dst->len; }
+}
+
+////// Queries //////
+
+size_t bd__ndigits(const bd_* src) {
+  size_t len = src->len;
+  while (len != 0 && src->bcdle[len - 1] == 0) { --len; }
+  if (len == 0) { return 0; }
+  return 2 * len - (src->bcdle[len - 1] < 0x10);
+}
+
+bl_ord bd__cmp(const bd_* a, const bd_* b) {
+  // packed digits compare the same way as their bytes
+  for (size_t i = max(a->len, b->len); i > 0; --i) {
+    uint8_t x = i <= a->len ? a->bcdle[i - 1] : 0;
+    uint8_t y = i <= b->len ? b->bcdle[i - 1] : 0;
+    if (x != y) { return x < y ? BL_LT : BL_GT; }
+  }
+  return BL_EQ;
+}
+
+////// Arithmetic //////
+
+// Return the sixteen-digit sum `x + y + *carry`, and set `*carry` to the carry out of the top digit.
+static uint64_t addWord(uint64_t x, uint64_t y, uint64_t* carry) {
+  // with every digit of `x` biased by six, a decimal carry is exactly a nibble carry
+  uint64_t t1 = x + SIXES;
+  uint64_t t2 = t1 + y;
+  uint64_t out = t2 < t1;
+  t2 += *carry;
+  out |= t2 < *carry;
+  // remove the bias from the digits that did not carry
+  uint64_t kept = ~(t2 ^ t1 ^ y) & NIBBLE_CARRIES;
+  uint64_t fix = (kept >> 2) | (kept >> 3);
+  if (!out) { fix |= UINT64_C(6) << 60; }
+  *carry = out;
+  return t2 - fix;
+}
+
+// Return the sixteen-digit difference `x - y - *borrow`, and set `*borrow` to the borrow out of the top digit.
+static uint64_t subWord(uint64_t x, uint64_t y, uint64_t* borrow) {
+  uint64_t t1 = x - y;
+  uint64_t out = x < y;
+  uint64_t t2 = t1 - *borrow;
+  out |= t1 < *borrow;
+  // a digit that borrowed took sixteen from the next nibble rather than ten
+  uint64_t taken = (t2 ^ x ^ y) & NIBBLE_CARRIES;
+  uint64_t fix = (taken >> 2) | (taken >> 3);
+  if (out) { fix |= UINT64_C(6) << 60; }
+  *borrow = out;
+  return t2 - fix;
+}
+
+size_t bd__sizeof_add(const bd_* a, const bd_* b) {
+  return max(a->len, b->len) + 1;
+}
+
+bl_result bd__add(bd_* dst, const bd_* a, const bd_* b) {
+  size_t n = max(a->len, b->len);
+  uint64_t carry = 0;
+  size_t i = 0;
+  for (; i < n; i += 8) {
+    uint64_t w = addWord(loadWord(a, i), loadWord(b, i), &carry);
+    if (storeWord(dst, i, w) != BL_OK) { return BL_OVERFLOW; }
+  }
+  if (carry != 0) {
+    if (i >= dst->len) { return BL_OVERFLOW; }
+    dst->bcdle[i++] = 1;
+  }
+  if (i < dst->len) { memset(&dst->bcdle[i], 0, dst->len - i); }
+  return BL_OK;
+}
+
+size_t bd__sizeof_sub(const bd_* a, const bd_* b) {
+  return a->len;
+}
+
+bl_result bd__sub(bd_* dst, const bd_* a, const bd_* b) {
+  size_t n = max(a->len, b->len);
+  uint64_t borrow = 0;
+  size_t i = 0;
+  for (; i < n; i += 8) {
+    uint64_t w = subWord(loadWord(a, i), loadWord(b, i), &borrow);
+    if (storeWord(dst, i, w) != BL_OK) { return BL_OVERFLOW; }
+  }
+  if (borrow != 0) { return BL_OVERFLOW; }
+  if (i < dst->len) { memset(&dst->bcdle[i], 0, dst->len - i); }
+  return BL_OK;
+}
+
+////// Text //////
+
+// Return whether all eight characters in `w` are decimal digits.
+static bool allDigits(uint64_t w) {
+  // '0'–'9' are 0x30–0x39, and adding six to them does not leave 0x3_
+  uint64_t highs = UINT64_C(0xF0F0F0F0F0F0F0F0);
+  uint64_t threes = UINT64_C(0x3030303030303030);
+  return (w & highs) == threes && ((w + UINT64_C(0x0606060606060606)) & highs) == threes;
+}
+
+// Pack eight digit characters (the first being most significant) into four bytes of digits.
+static uint32_t packDigits(uint64_t w) {
+  uint64_t d = w - UINT64_C(0x3030303030303030);
+  // each pair of characters becomes one byte, then the bytes are gathered together
+  d = ((d & UINT64_C(0x00FF00FF00FF00FF)) << 4) | ((d >> 8) & UINT64_C(0x00FF00FF00FF00FF));
+  d = (d | (d >> 8)) & UINT64_C(0x0000FFFF0000FFFF);
+  d = (d | (d >> 16)) & UINT64_C(0xFFFFFFFF);
+  // the most significant pair is now in the lowest byte
+  return (uint32_t)(((d & 0xFF) << 24) | ((d & 0xFF00) << 8) | ((d >> 8) & 0xFF00) | (d >> 24));
+}
+
+size_t bd__sizeof_parse(size_t len) {
+  return (len + 1) / 2;
+}
+
+bl_result bd__parse(bd_* dst, const char* str, size_t len) {
+  if (len == 0) { return BL_SYNTAX; }
+  if (dst->len < bd__sizeof_parse(len)) { return BL_OVERFLOW; }
+  bd__blank(dst);
+  // the least significant digits are at the end of the string
+  size_t i = len, at = 0;
+  for (; i >= 8; i -= 8, at += 4) {
+    uint64_t w = bn__load64((const uint8_t*)&str[i - 8]);
+    if (!allDigits(w)) { return BL_SYNTAX; }
+    bn__storeN(&dst->bcdle[at], packDigits(w), 4);
+  }
+  for (unsigned nibble = 0; i > 0; --i, ++nibble) {
+    char c = str[i - 1];
+    if (c < '0' || '9' < c) { return BL_SYNTAX; }
+    dst->bcdle[at + nibble / 2] |= (c - '0') << (4 * (nibble % 2));
+  }
+  return BL_OK;
+}
+
+size_t bd__sizeof_print(const bd_* src) {
+  return max(bd__ndigits(src), 1);
+}
+
+bl_result bd__print(char* dst, size_t dstLen, const bd_* src) {
+  size_t n = bd__ndigits(src);
+  if (dstLen < max(n, 1)) { return BL_OVERFLOW; }
+  if (n == 0) { dst[0] = '0'; }
+  for (size_t i = 0; i < n; ++i) {
+    size_t nibble = n - 1 - i;
+    dst[i] = '0' + ((src->bcdle[nibble / 2] >> (4 * (nibble % 2))) & 0x0F);
+  }
+  return BL_OK;
+}
+
+////// Conversion //////
+
+#define TEN_TO_THE_16 UINT64_C(10000000000000000)
+
+// Return the value of sixteen packed digits.
+static uint64_t wordValue(uint64_t w) {
+  // combine neighbouring digits, then neighbouring pairs, and so on
+  w = (w & UINT64_C(0x0F0F0F0F0F0F0F0F)) + ((w >> 4) & UINT64_C(0x0F0F0F0F0F0F0F0F)) * 10;
+  w = (w & UINT64_C(0x00FF00FF00FF00FF)) + ((w >> 8) & UINT64_C(0x00FF00FF00FF00FF)) * 100;
+  w = (w & UINT64_C(0x0000FFFF0000FFFF)) + ((w >> 16) & UINT64_C(0x0000FFFF0000FFFF)) * 10000;
+  return (w & 0xFFFFFFFF) + (w >> 32) * 100000000;
+}
+
+// Return sixteen packed digits of `v < 10^16`.
+static uint64_t packWord(uint64_t v) {
+  uint64_t out = 0;
+  for (unsigned i = 0; i < 16; ++i) {
+    out |= (v % 10) << (4 * i);
+    v = v / 10;
+  }
+  return out;
+}
+
+size_t bd__sizeof_bn(const bd_* src) {
+  // log256(10) < 107/256
+  return (2 * src->len * 107 + 255) / 256 + 1;
+}
+
+bl_result bd__to_bn(bn_* dst, const bd_* src) {
+  bn__blank(dst);
+  size_t used = 0;
+  for (size_t i = (src->len + 7) / 8; i > 0; --i) {
+    bl_result err = bn__muladd1(dst, &used, TEN_TO_THE_16, wordValue(loadWord(src, 8 * (i - 1))));
+    if (err != BL_OK) { return err; }
+  }
+  return BL_OK;
+}
+
+size_t bd__sizeof_from_bn(const bn_* src) {
+  // log10(2) < 78/256
+  size_t nDigits = (8 * src->len * 78 + 255) / 256;
+  return (nDigits + 1) / 2;
+}
+
+size_t bd__sizeof_from_bn_scratch(const bn_* src) {
+  return bn__sizeof_carve(src->len);
+}
+
+bl_result bd__from_bn(bd_* dst, const bn_* src, bn_* scratch) {
+  if (scratch == NULL || scratch->len < bd__sizeof_from_bn_scratch(src)) { return BL_OVERFLOW; }
+  uint8_t* at = &scratch->base256le[0];
+  bn_* rest = bn__carve(&at, at + scratch->len, src->len);
+  bn__copy(rest, src);
+  bn__normalize(rest);
+  bd__blank(dst);
+  // peel off sixteen digits at a time from the bottom
+  for (size_t i = 0; rest->len != 0; i += 8) {
+    uint64_t rem = 0;
+    for (size_t j = rest->len; j > 0; --j) {
+      rem = (rem << 8) | rest->base256le[j - 1];
+      rest->base256le[j - 1] = rem / TEN_TO_THE_16;
+      rem = rem % TEN_TO_THE_16;
+    }
+    bn__normalize(rest);
+    if (storeWord(dst, i, packWord(rem)) != BL_OK) { return BL_OVERFLOW; }
+  }
+  return BL_OK;
+}
@@ -0,0 +1,101 @@
+#ifndef BIGLIT_CORE_BD
+#define BIGLIT_CORE_BD
+
+// This is the core interface for natural numbers in binary-coded decimal.
+// Most literals are written in decimal, and many are only range-checked and written back out;
+// keeping those digits in decimal means they never pay for conversion to and from binary.
+// Conversion to `bn_` is left for when binary arithmetic is actually needed.
+// As with the rest of the core, its functions do not allocate.
+
+#include "core/bn.h"
+
+// Digits are packed two to a byte, least significant byte first;
+// within a byte, the low nibble holds the less significant digit.
+// Every nibble must be a decimal digit (0–9).
+typedef struct bd_ {
+  size_t len;
+  uint8_t bcdle[];
+} bd_;
+
+////// Initialization //////
+
+// Return the size in bytes of the memory required to store a number with `nDigits` decimal digits.
+size_t bd__sizeof(size_t nDigits);
+
+// Set all digits of the destination to zero.
+// The desintation is _not_ normalized.
+void bd__blank(bd_* dst);
+
+// Remove leading zero bytes, so that the most significant byte is non-zero.
+void bd__normalize(bd_* dst);
+
+////// Queries //////
+
+// Return the number of significant decimal digits in `src` (zero for zero).
+// This function does not require input normalization.
+size_t bd__ndigits(const bd_* src);
+
+// Return if the first number is less than/equal to/greater than the second.
+// This function does not require input normalization.
+bl_ord bd__cmp(const bd_* a, const bd_* b);
+
+////// Arithmetic //////
+
+// Additions and subtractions work on sixteen digits at once, using the usual SWAR decimal adjust:
+// each digit is biased by six so that decimal carries coincide with nibble carries,
+// and the bias is removed from those digits that did not carry.
+
+// Place the result of `a + b` in `dst`, which may be either input.
+// Inputs need not be normalized, and the output is not normalized.
+// `BL_OVERFLOW` is returned when the destination is too small, in which case its contents are undefined.
+bl_result bd__add(bd_* dst, const bd_* a, const bd_* b);
+// Return the maximum size (in bytes of digits) that must be allocated to hold the result of `a + b`.
+size_t bd__sizeof_add(const bd_* a, const bd_* b);
+
+// Place the result of `a - b` in `dst`, which may be either input.
+// Inputs need not be normalized, and the output is not normalized.
+// `BL_OVERFLOW` is returned when `b > a` or the destination is too small, in which case its contents are undefined.
+bl_result bd__sub(bd_* dst, const bd_* a, const bd_* b);
+// Return the maximum size (in bytes of digits) that must be allocated to hold the result of `a - b`.
+size_t bd__sizeof_sub(const bd_* a, const bd_* b);
+
+////// Text //////
+
+// Return the size (in bytes of digits) that holds the number written with `len` decimal digits.
+size_t bd__sizeof_parse(size_t len);
+
+// Place the number written in decimal by the `len` characters at `str` in `dst`.
+// No signs, separators or prefixes are accepted.
+// `BL_SYNTAX` is returned if there are no characters or any is not a decimal digit,
+// and `BL_OVERFLOW` if the destination is too small.
+// The output is not normalized.
+bl_result bd__parse(bd_* dst, const char* str, size_t len);
+
+// Return the number of characters needed to write `src` in decimal (at least one, for zero).
+size_t bd__sizeof_print(const bd_* src);
+
+// Write `src` in decimal to the first `bd__sizeof_print(src)` characters of `dst`, without a terminating nul.
+// `BL_OVERFLOW` is returned when `dstLen` is too small.
+bl_result bd__print(char* dst, size_t dstLen, const bd_* src);
+
+////// Conversion //////
+
+// Return the maximum size (in base256 digits) of the natural number equal to `src`.
+size_t bd__sizeof_bn(const bd_* src);
+
+// Place the natural number equal to `src` in `dst`, sixteen digits at a time.
+// The output is not normalized.
+// `BL_OVERFLOW` is returned when the destination is too small.
+bl_result bd__to_bn(bn_* dst, const bd_* src);
+
+// Return the maximum size (in bytes of digits) of the decimal equal to `src`.
+size_t bd__sizeof_from_bn(const bn_* src);
+// Return the number of base256 digits of scratch space needed to convert `src` to decimal.
+size_t bd__sizeof_from_bn_scratch(const bn_* src);
+
+// Place the decimal equal to `src` in `dst`, sixteen digits at a time.
+// The output is not normalized.
+// `BL_OVERFLOW` is returned when the destination or scratch space is too small.
+bl_result bd__from_bn(bd_* dst, const bn_* src, bn_* scratch);
+
+#endif
@@ -1,4 +1,9 @@
 #include "core/bn.h"
+#include "core/limb.h"
+#include "core/bz_type.h"
+#include "core/kernels.h"
+#include "core/thresholds.h"
+#include "stats.h"
 
 #include <string.h>
 
@@ -10,9 +15,48 @@ static inline size_t max(size_t a, size_t b) {
   return a > b ? a : b;
 }
 
+// Return the `i`th 64-bit word of `src`, with digits past the end read as zero.
+static uint64_t wordAt(const bn_* src, size_t i) {
+  size_t at = 8 * i;
+  if (at >= src->len) { return 0; }
+  if (src->len - at >= 8) { return bn__load64(&src->base256le[at]); }
+  return bn__loadN(&src->base256le[at], src->len - at);
+}
+
+// Write the `i`th 64-bit word of `dst`, dropping any digits past the end.
+static void setWordAt(bn_* dst, size_t i, uint64_t w) {
+  size_t at = 8 * i;
+  if (at >= dst->len) { return; }
+  if (dst->len - at >= 8) { bn__store64(&dst->base256le[at], w); }
+  else { bn__storeN(&dst->base256le[at], w, dst->len - at); }
+}
+
+// Return the `k < 8` digits of `src` just below digit `end` as a word, with digits outside of `src` read as zero.
+static uint64_t digitsBelow(const bn_* src, size_t end, size_t k) {
+  // usually, a whole word ending at `end` lies within `src`, and one load does
+  if (k != 0 && end >= 8 && end <= src->len) { return bn__load64(&src->base256le[end - 8]) >> (8 * (8 - k)); }
+  size_t pad = k > end ? k - end : 0;
+  size_t lo = end + pad - k, hi = min(end, src->len);
+  uint64_t out = hi > lo ? bn__loadN(&src->base256le[lo], hi - lo) : 0;
+  return out << (8 * pad);
+}
+
+// Return the number of base256 digits of `w`.
+static size_t digitLen64(uint64_t w) {
+  return (bn__bitlen64(w) + 7) / 8;
+}
+
+// Return the number of digits in `src` once normalized.
+static size_t normLen(const bn_* src) {
+  size_t len = src->len;
+  while (len != 0 && src->base256le[len - 1] == 0) { --len; }
+  return len;
+}
+
 ////// Initialization helpers //////
 
 size_t bn__sizeof(size_t nbits) {
+  BL_STAT(0);
   size_t ndigits = nbits / 8;
   if ((nbits % 8) != 0) { ndigits += 1; } // ceiling instead of floor
   assert(ndigits <= SIZE_MAX - sizeof(bn_));
@@ -21,10 +65,12 @@ size_t bn__sizeof(size_t nbits) {
 
 
 void bn__blank(bn_* dst) {
+  BL_STAT(0);
   memset(&dst->base256le[0], 0, dst->len);
 }
 
 bl_result bn__copy(bn_*restrict dst, const bn_*restrict src) {
+  BL_STAT(src->len);
   if (dst->len < src->len) { return BL_OVERFLOW; }
   memcpy(&dst->base256le[0], &src->base256le[0], src->len);
   memset(&dst->base256le[src->len], 0, dst->len - src->len);
@@ -32,6 +78,7 @@ bl_result bn__copy(bn_*restrict dst, const bn_*restrict src) {
 }
 
 bl_result bn__umax(bn_* dst, uintmax_t src) {
+  BL_STAT(0);
   for (size_t i = 0; i < dst->len; ++i) {
     dst->base256le[i] = src & 0xFF;
     src = src >> 8;
@@ -50,6 +97,7 @@ bl_result bn__umax(bn_* dst, uintmax_t src) {
 
 
 bool bn__bit(const bn_* src, size_t i) {
+  BL_STAT(src->len);
   size_t digit = i / 8,
          bit = i % 8;
   if (digit < src->len) {
@@ -60,7 +108,29 @@ bool bn__bit(const bn_* src, size_t i) {
   }
 }
 
+size_t bn__nbits(const bn_* src) {
+  BL_STAT(src->len);
+  size_t len = src->len;
+  while (len != 0 && src->base256le[len - 1] == 0) { --len; }
+  if (len == 0) { return 0; }
+  return 8 * (len - 1) + bn__bitlen64(src->base256le[len - 1]);
+}
+
+size_t bn__ctz(const bn_* src) {
+  BL_STAT(src->len);
+  size_t i = 0;
+  while (i < src->len && src->base256le[i] == 0) { ++i; }
+  if (i == src->len) { return 0; }
+  return 8 * i + bn__ctz64(src->base256le[i]);
+}
+
+size_t bn__popcount(const bn_* src) {
+  BL_STAT(src->len);
+  return bn__kernels->popcount(&src->base256le[0], src->len);
+}
+
 bl_ord bn__cmp(const bn_* a, const bn_* b) {
+  BL_STAT(a->len + b->len);
   // ensure a is longer than b
   // and remember to flip the results if we had to flip inputs
   bool flip = false;
@@ -86,49 +156,51 @@ bl_ord bn__cmp(const bn_* a, const bn_* b) {
 ////// Bitwise //////
 
 size_t bn__sizeof_and(const bn_* a, const bn_* b) {
+  BL_STAT(a->len + b->len);
   return min(a->len, b->len);
 }
 void bn__and(bn_* dst, const bn_* a, const bn_* b) {
+  BL_STAT(a->len + b->len);
   size_t bigI = min(dst->len, min(a->len, b->len));
-  for (size_t i = 0; i < bigI; ++i) {
-    dst->base256le[i] = a->base256le[i] & b->base256le[i];
-  }
+  bn__kernels->bitAnd(&dst->base256le[0], &a->base256le[0], &b->base256le[0], bigI);
   dst->len = bigI;
 }
 
 size_t bn__sizeof_or(const bn_* a, const bn_* b) {
+  BL_STAT(a->len + b->len);
   return max(a->len, b->len);
 }
 void bn__or(bn_* dst, const bn_* a, const bn_* b) {
+  BL_STAT(a->len + b->len);
   // ensure a is the longer argument
   if (a->len < b->len) {
     const bn_* tmp = a; a = b; b = tmp;
   }
-  // iterate until we reach the end of b (the shorter one), `or`ing bits
-  for (size_t i = 0; i < min(dst->len, b->len); ++i) {
-    dst->base256le[i] = a->base256le[i] | b->base256le[i];
-  }
-  // iterate until we raech the end of a (the longer one), copying bits
-  for (size_t i = b->len; i < min(dst->len, a->len); ++i) {
-    dst->base256le[i] = a->base256le[i];
+  // `or` bits until we reach the end of b (the shorter one)
+  size_t bLen = min(dst->len, b->len);
+  bn__kernels->bitOr(&dst->base256le[0], &a->base256le[0], &b->base256le[0], bLen);
+  // then copy bits until we reach the end of a (the longer one); `dst` may be `a`
+  if (min(dst->len, a->len) > bLen) {
+    memmove(&dst->base256le[bLen], &a->base256le[bLen], min(dst->len, a->len) - bLen);
   }
 }
 
 size_t bn__sizeof_xor(const bn_* a, const bn_* b) {
+  BL_STAT(a->len + b->len);
   return max(a->len, b->len);
 }
 void bn__xor(bn_* dst, const bn_* a, const bn_* b) {
+  BL_STAT(a->len + b->len);
   // ensure a is the longer argument
   if (a->len < b->len) {
     const bn_* tmp = a; a = b; b = tmp;
   }
-  // iterate until we reach the end of b (the shorter one), `xor`ing bits
-  for (size_t i = 0; i < min(dst->len, b->len); ++i) {
-    dst->base256le[i] = a->base256le[i] ^ b->base256le[i];
-  }
-  // iterate until we raech the end of a (the longer one), copying bits
-  for (size_t i = b->len; i < min(dst->len, a->len); ++i) {
-    dst->base256le[i] = a->base256le[i];
+  // `xor` bits until we reach the end of b (the shorter one)
+  size_t bLen = min(dst->len, b->len);
+  bn__kernels->bitXor(&dst->base256le[0], &a->base256le[0], &b->base256le[0], bLen);
+  // then copy bits until we reach the end of a (the longer one); `dst` may be `a`
+  if (min(dst->len, a->len) > bLen) {
+    memmove(&dst->base256le[bLen], &a->base256le[bLen], min(dst->len, a->len) - bLen);
   }
 }
 
@@ -137,9 +209,15 @@ void bn__xor(bn_* dst, const bn_* a, const bn_* b) {
 ////// Arithmetic //////
 
 size_t bn__sizeof_inc(const bn_* src) {
-  return src->len + 1;
+  BL_STAT(src->len);
+  if (src->len == 0) { return 1; }
+  // `src + 1 ≤ (top + 1)·256^(len - k)`, where `top` is the leading `k` digits, so only a run of 0xFF can carry out
+  if (src->base256le[src->len - 1] != 0xFF) { return src->len; }
+  size_t k = min(src->len, 7);
+  return (src->len - k) + digitLen64(digitsBelow(src, src->len, k) + 1);
 }
 bl_result bn__inc(bn_* dst, const bn_* src) {
+  BL_STAT(src->len);
   uint16_t carry = 1;
   for (size_t i = 0; i < min(dst->len, src->len); ++i) {
     carry += src->base256le[i];
@@ -159,29 +237,37 @@ bl_result bn__inc(bn_* dst, const bn_* src) {
 }
 
 size_t bn__sizeof_add(const bn_* a, const bn_* b) {
-  return (a->len >= b->len ? a->len : b->len) + 1;
+  BL_STAT(a->len + b->len);
+  if (a->len < b->len) {
+    const bn_* tmp = a; a = b; b = tmp;
+  }
+  if (a->len == 0) { return 1; }
+  // `a + b < (topA + topB + 2)·256^(len - k)`, where `topA` and `topB` are the leading `k` digits (or equal to their sum when there are no others),
+  // so the sum needs another digit only if `topA + topB + 1` does; usually, the leading digit alone decides
+  size_t len = a->len;
+  unsigned top = a->base256le[len - 1] + (b->len == len ? b->base256le[len - 1] : 0);
+  if (top != 0xFF) { return len + (top > 0xFF); }
+  size_t k = min(len, 7);
+  return (len - k) + digitLen64(digitsBelow(a, len, k) + digitsBelow(b, len, k) + (len > k));
 }
 bl_result bn__add(bn_* dst, const bn_* a, const bn_* b) {
+  BL_STAT(a->len + b->len);
   // commute so that `a` is at least as long as `b`
   if (a ->len < b->len) {
     const bn_* tmp = a; a = b; b = tmp;
   }
-  uint16_t carry = 0;
   // perform additions when both a and b have digits
-  for (size_t i = 0; i < min(dst->len, b->len); ++i) {
-    carry += a->base256le[i];
-    carry += b->base256le[i];
-    dst->base256le[i] = carry & 0xFF;
-    carry = carry >> 8;
-  }
+  uint16_t carry = bn__kernels->add(&dst->base256le[0], &a->base256le[0], &b->base256le[0], min(dst->len, b->len), 0);
   // overflow if there are digits left in `b`
   if (dst->len < b->len) { return BL_OVERFLOW; }
-  // propagate any carry through the digits of `a`
-  for (size_t i = b->len; i < min(dst->len, a->len); ++i) {
+  // propagate any carry through the digits of `a`, then copy the rest; `dst` may be `a`
+  size_t i = b->len, end = min(dst->len, a->len);
+  for (; i < end && carry != 0; ++i) {
     carry += a->base256le[i];
     dst->base256le[i] = carry & 0xFF;
     carry = carry >> 8;
   }
+  if (i < end) { memmove(&dst->base256le[i], &a->base256le[i], end - i); }
   // overflow if there are any digits left in `a`
   if (dst->len < a->len) { return BL_OVERFLOW; }
   // if there is a final carry, put it in the first digit of `dst` after `a`
@@ -196,9 +282,11 @@ bl_result bn__add(bn_* dst, const bn_* a, const bn_* b) {
 }
 
 size_t bn__sizeof_dec(const bn_* src) {
+  BL_STAT(src->len);
   return src->len;
 }
 bl_result bn__dec(bn_* dst, const bn_* src) {
+  BL_STAT(src->len);
   int16_t borrow = -1;
   for (size_t i = 0; i < min(dst->len, src->len); ++i) {
     borrow += src->base256le[i];
@@ -211,26 +299,24 @@ bl_result bn__dec(bn_* dst, const bn_* src) {
 }
 
 size_t bn__sizeof_sub(const bn_* a, const bn_* b) {
+  BL_STAT(a->len + b->len);
   return a->len;
 }
 bl_result bn__sub(bn_* dst, const bn_* a, const bn_* b) {
+  BL_STAT(a->len + b->len);
   if (b->len > a->len) { dst->len = 0; return BL_OVERFLOW; }
-  int16_t borrow = 0;
   // perform subtractions while both `a` and `b` have digits
-  for (size_t i = 0; i < min(dst->len, b->len); ++i) {
-    borrow += a->base256le[i];
-    borrow -= b->base256le[i];
-    dst->base256le[i] = borrow & 0xFF;
-    borrow = borrow >> 8;
-  }
+  int16_t borrow = -(int16_t)bn__kernels->sub(&dst->base256le[0], &a->base256le[0], &b->base256le[0], min(dst->len, b->len), 0);
   // overflow if there are digits left in `b`
   if (dst->len < b->len) { return BL_OVERFLOW; }
-  // propagate any borrow through the digits of `a`
-  for (size_t i = b->len; i < min(dst->len, a->len); ++i) {
+  // propagate any borrow through the digits of `a`, then copy the rest; `dst` may be `a`
+  size_t i = b->len, end = min(dst->len, a->len);
+  for (; i < end && borrow != 0; ++i) {
     borrow += a->base256le[i];
     dst->base256le[i] = borrow & 0xFF;
     borrow = borrow >> 8;
   }
+  if (i < end) { memmove(&dst->base256le[i], &a->base256le[i], end - i); }
   // if there are digits left in `a`, or there is a remaining borrow, that's an overflow
   if (dst->len < a->len || borrow != 0) {
     dst->len = 0; return BL_OVERFLOW;
@@ -239,12 +325,21 @@ bl_result bn__sub(bn_* dst, const bn_* a, const bn_* b) {
 }
 
 size_t bn__sizeof_mul(const bn_* a, const bn_* b) {
-  return a->len + b->len;
+  BL_STAT(a->len + b->len);
+  if (a->len == 0 || b->len == 0) { return 0; }
+  // the product has `a->len + b->len` or one fewer digits; bound it by the leading three digits of each input,
+  // plus one in the last place for any digits below them: `a·b < topA·topB·256^(len - ka - kb)`,
+  // which only overestimates when that product is just short of a power of 256
+  size_t ka = min(a->len, 3), kb = min(b->len, 3);
+  bool partial = a->len > ka || b->len > kb;
+  uint64_t top = (digitsBelow(a, a->len, ka) + (a->len > ka)) * (digitsBelow(b, b->len, kb) + (b->len > kb));
+  return (a->len - ka) + (b->len - kb) + digitLen64(top - (partial && top != 0));
 }
 bl_result bn__mul(bn_* dst, const bn_* a, const bn_* b) {
+  BL_STAT(a->len + b->len);
   // check the destination is large enough
-  // I'm pessimistic about this so that I can simplify everything else about the algorithm
-  if (dst->len < a->len + b->len) { return BL_OVERFLOW; }
+  // partial sums never exceed the product, so no carry goes past the last digit the product needs
+  if (dst->len < bn__sizeof_mul(a, b)) { return BL_OVERFLOW; }
   for (size_t i = 0; i < a->len; ++i) {
     for (size_t j = 0; j < b->len; ++j) {
       // create a double-width multiply for the two digits
@@ -262,17 +357,151 @@ bl_result bn__mul(bn_* dst, const bn_* a, const bn_* b) {
   return BL_OK;
 }
 
+// Add `x * k` to the `n` digits at `r`, which may be `x`, and return the carry out of them.
+static uint64_t addmulDigits(uint8_t* r, const uint8_t* x, size_t n, uint64_t k) {
+  uint64_t carry = 0;
+  size_t i = 0;
+  // `x[i]·k + carry + r[i]` is at most `2^128 - 1`, so neither addition carries out of `hi`
+  for (; i + 8 <= n; i += 8) {
+    uint64_t hi, w = bn__load64(&r[i]);
+    uint64_t lo = bn__mul64(bn__load64(&x[i]), k, &hi);
+    lo += carry;
+    hi += lo < carry;
+    lo += w;
+    hi += lo < w;
+    bn__store64(&r[i], lo);
+    carry = hi;
+  }
+  if (i < n) {
+    size_t tail = n - i;
+    uint64_t hi, w = bn__loadN(&r[i], tail);
+    uint64_t lo = bn__mul64(bn__loadN(&x[i], tail), k, &hi);
+    lo += carry;
+    hi += lo < carry;
+    lo += w;
+    hi += lo < w;
+    bn__storeN(&r[i], lo, tail);
+    carry = (lo >> (8 * tail)) | (hi << (64 - 8 * tail));
+  }
+  return carry;
+}
+
+// Subtract `x * k` from the `n` digits at `r`, which may be `x`, and return the borrow out of them.
+static uint64_t submulDigits(uint8_t* r, const uint8_t* x, size_t n, uint64_t k) {
+  uint64_t borrow = 0;
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    uint64_t hi, w = bn__load64(&r[i]);
+    uint64_t lo = bn__mul64(bn__load64(&x[i]), k, &hi);
+    lo += borrow;
+    hi += lo < borrow;
+    bn__store64(&r[i], w - lo);
+    borrow = hi + (w < lo);
+  }
+  if (i < n) {
+    size_t tail = n - i;
+    uint64_t mask = (UINT64_C(1) << (8 * tail)) - 1;
+    uint64_t hi, w = bn__loadN(&r[i], tail);
+    uint64_t lo = bn__mul64(bn__loadN(&x[i], tail), k, &hi);
+    lo += borrow;
+    hi += lo < borrow;
+    bn__storeN(&r[i], w - lo, tail);
+    borrow = ((lo >> (8 * tail)) | (hi << (64 - 8 * tail))) + (w < (lo & mask));
+  }
+  return borrow;
+}
+
+// Add the word `carry` to `dst` from digit `at` up, returning false if it carries out of `dst`.
+static bool carryFrom(bn_* dst, size_t at, uint64_t carry) {
+  for (; carry != 0 && at < dst->len; ++at) {
+    unsigned sum = dst->base256le[at] + (carry & 0xFF);
+    dst->base256le[at] = sum & 0xFF;
+    carry = (carry >> 8) + (sum >> 8);
+  }
+  return carry == 0;
+}
+
+// Subtract the word `borrow` from `dst` from digit `at` up, returning false if it borrows out of `dst`.
+static bool borrowFrom(bn_* dst, size_t at, uint64_t borrow) {
+  for (; borrow != 0 && at < dst->len; ++at) {
+    unsigned w = dst->base256le[at], low = borrow & 0xFF;
+    dst->base256le[at] = (w - low) & 0xFF;
+    borrow = (borrow >> 8) + (w < low);
+  }
+  return borrow == 0;
+}
+
+size_t bn__sizeof_addmul_1(const bn_* acc, const bn_* a, uint64_t k) {
+  BL_STAT(acc->len + a->len);
+  if (a->len == 0 || k == 0) { return acc->len; }
+  return max(acc->len, a->len + digitLen64(k)) + 1;
+}
+bl_result bn__addmul_1(bn_* dst, const bn_* a, uint64_t k) {
+  BL_STAT(dst->len + a->len);
+  if (k == 0) { return BL_OK; }
+  size_t n = normLen(a);
+  if (n > dst->len) { return BL_OVERFLOW; }
+  uint64_t carry = addmulDigits(&dst->base256le[0], &a->base256le[0], n, k);
+  return carryFrom(dst, n, carry) ? BL_OK : BL_OVERFLOW;
+}
+
+bl_result bn__submul_1(bn_* dst, const bn_* a, uint64_t k) {
+  BL_STAT(dst->len + a->len);
+  if (k == 0) { return BL_OK; }
+  size_t n = normLen(a);
+  if (n > dst->len) { return BL_OVERFLOW; }
+  uint64_t borrow = submulDigits(&dst->base256le[0], &a->base256le[0], n, k);
+  return borrowFrom(dst, n, borrow) ? BL_OK : BL_OVERFLOW;
+}
+
+size_t bn__sizeof_fma(const bn_* a, const bn_* b, const bn_* c) {
+  BL_STAT(a->len + b->len + c->len);
+  // `c` is measured normalized, so that it can be accumulated into in place
+  size_t prod = bn__sizeof_mul(a, b), cLen = normLen(c);
+  if (prod == 0 || cLen == 0) { return max(prod, cLen); }
+  return max(prod, cLen) + 1;
+}
+bl_result bn__fma(bn_* dst, const bn_* a, const bn_* b, const bn_* c) {
+  BL_STAT(a->len + b->len + c->len);
+  if (dst->len < bn__sizeof_fma(a, b, c)) { return BL_OVERFLOW; }
+  size_t aLen = normLen(a), bLen = normLen(b), cLen = normLen(c);
+  // `dst` may be `c`, whose digits are then already in place
+  memmove(&dst->base256le[0], &c->base256le[0], cLen);
+  memset(&dst->base256le[cLen], 0, dst->len - cLen);
+  // row `j` ends at digit `8j + aLen < aLen + bLen`, which the size check covers, and the sum never carries out of `dst`
+  for (size_t j = 0; 8 * j < bLen; ++j) {
+    uint64_t carry = addmulDigits(&dst->base256le[8 * j], &a->base256le[0], aLen, wordAt(b, j));
+    carryFrom(dst, 8 * j + aLen, carry);
+  }
+  return BL_OK;
+}
+
+// Subtract `b` from `dst` in place, discarding any borrow out of the top digit.
+static void subWrap(bn_* dst, const bn_* b) {
+  size_t n = min(dst->len, b->len);
+  int16_t borrow = -(int16_t)bn__kernels->sub(&dst->base256le[0], &dst->base256le[0], &b->base256le[0], n, 0);
+  for (size_t i = n; i < dst->len && borrow != 0; ++i) {
+    borrow += dst->base256le[i];
+    dst->base256le[i] = borrow & 0xFF;
+    borrow = borrow >> 8;
+  }
+}
+
 bl_result bn__divmod(bn_* q, bn_* r, const bn_* n, const bn_* d) {
+  BL_STAT(n->len + d->len);
   // check the destinations are large enough
-  // I'm pessimistic about this so that I can simplify everything else about the algorithm
-  if (q->len < n->len || r->len < d->len) { return BL_OVERFLOW; }
+  // bits of `q` are only ever set within the quotient, but `r` is pessimistically as wide as `d`, to simplify the algorithm
+  if (q->len < bn__sizeof_div(n, d) || r->len < d->len) { return BL_OVERFLOW; }
 
   for (size_t i = 8*n->len; i > 0; --i) {
     bool nBit = bn__bit(n, i - 1);
+    // when `d` fills the top bit of `r`, shifting can carry a bit out of `r`;
+    // the true remainder is then at least `d`, and the difference fits back into `r`
+    bool carry = r->len != 0 && bn__bit(r, 8*r->len - 1);
     bn__shl(r, 1);
     bn__wrbit(r, 0, nBit);
-    if (bn__cmp(r, d) != BL_LT) {
-      bn__sub(r, r, d);
+    if (carry || bn__cmp(r, d) != BL_LT) {
+      subWrap(r, d);
       bn__wrbit(q, i - 1, true);
     }
   }
@@ -280,15 +509,1640 @@ bl_result bn__divmod(bn_* q, bn_* r, const bn_* n, const bn_* d) {
 }
 
 size_t bn__sizeof_div(const bn_* n, const bn_* d) {
-  return n->len;
+  BL_STAT(n->len + d->len);
+  size_t dLen = d->len;
+  while (dLen != 0 && d->base256le[dLen - 1] == 0) { --dLen; }
+  // when dividing by zero, every bit of the quotient is set
+  if (dLen == 0) { return n->len; }
+  if (n->len < dLen) { return 0; }
+  // the quotient is below `256^(n->len - dLen + 1)`, and below `256^(n->len - dLen)` when `n < d·256^(n->len - dLen)`,
+  // which the leading seven digits of each decide unless they are equal
+  size_t k = min(n->len, 7);
+  bool shorter = digitsBelow(n, n->len, k) < digitsBelow(d, dLen, k);
+  return n->len - dLen + !shorter;
 }
 size_t bn__sizeof_mod(const bn_* n, const bn_* d) {
+  BL_STAT(n->len + d->len);
   return d->len;
 }
 
+////// Wrapping Arithmetic //////
+
+size_t bn__sizeof_wrap(size_t nbits) {
+  BL_STAT(0);
+  return nbits / 8 + (nbits % 8 != 0);
+}
+
+// Clear the bits of `dst` from `nbits` up, after the low words have been written.
+static void truncateBits(bn_* dst, size_t nbits) {
+  size_t n = bn__sizeof_wrap(nbits);
+  if (nbits % 8 != 0) { dst->base256le[n - 1] &= (1u << (nbits % 8)) - 1; }
+  memset(&dst->base256le[n], 0, dst->len - n);
+}
+
+bl_result bn__wrap(bn_* dst, const bn_* src, size_t nbits) {
+  BL_STAT(src->len);
+  size_t n = bn__sizeof_wrap(nbits);
+  if (dst->len < n) { return BL_OVERFLOW; }
+  memmove(&dst->base256le[0], &src->base256le[0], min(n, src->len));
+  if (src->len < n) { memset(&dst->base256le[src->len], 0, n - src->len); }
+  truncateBits(dst, nbits);
+  return BL_OK;
+}
+
+bl_result bn__add_wrap(bn_* dst, const bn_* a, const bn_* b, size_t nbits) {
+  BL_STAT(a->len + b->len);
+  size_t n = bn__sizeof_wrap(nbits);
+  if (dst->len < n) { return BL_OVERFLOW; }
+  uint64_t carry = 0;
+  for (size_t i = 0; 8 * i < n; ++i) {
+    uint64_t x = wordAt(a, i);
+    uint64_t w = x + wordAt(b, i);
+    uint64_t out = w < x;
+    w += carry;
+    carry = out | (w < carry);
+    setWordAt(dst, i, w);
+  }
+  truncateBits(dst, nbits);
+  return BL_OK;
+}
+
+bl_result bn__sub_wrap(bn_* dst, const bn_* a, const bn_* b, size_t nbits) {
+  BL_STAT(a->len + b->len);
+  size_t n = bn__sizeof_wrap(nbits);
+  if (dst->len < n) { return BL_OVERFLOW; }
+  uint64_t borrow = 0;
+  for (size_t i = 0; 8 * i < n; ++i) {
+    uint64_t x = wordAt(a, i), y = wordAt(b, i);
+    uint64_t w = x - y;
+    uint64_t out = x < y;
+    out |= w < borrow;
+    w -= borrow;
+    borrow = out;
+    setWordAt(dst, i, w);
+  }
+  truncateBits(dst, nbits);
+  return BL_OK;
+}
+
+bl_result bn__mul_lo(bn_* dst, const bn_* a, const bn_* b, size_t nbits) {
+  BL_STAT(a->len + b->len);
+  size_t n = bn__sizeof_wrap(nbits);
+  if (dst->len < n) { return BL_OVERFLOW; }
+  size_t nWords = (n + 7) / 8;
+  size_t aWords = min((a->len + 7) / 8, nWords);
+  size_t bWords = min((b->len + 7) / 8, nWords);
+  bn__blank(dst);
+  // schoolbook, but each row stops at the last word kept: about half the products of a full multiply
+  // bits that land past the end of `dst` in its last word are dropped, but they would be truncated anyway
+  for (size_t i = 0; i < aWords; ++i) {
+    uint64_t x = wordAt(a, i);
+    if (x == 0) { continue; }
+    uint64_t carry = 0;
+    for (size_t j = 0; j < min(bWords, nWords - i); ++j) {
+      uint64_t hi;
+      uint64_t lo = bn__mul64(x, wordAt(b, j), &hi);
+      lo += carry;
+      hi += lo < carry;
+      uint64_t w = wordAt(dst, i + j);
+      lo += w;
+      hi += lo < w;
+      setWordAt(dst, i + j, lo);
+      carry = hi;
+    }
+    for (size_t k = i + bWords; carry != 0 && k < nWords; ++k) {
+      uint64_t w = wordAt(dst, k) + carry;
+      carry = w < carry;
+      setWordAt(dst, k, w);
+    }
+  }
+  truncateBits(dst, nbits);
+  return BL_OK;
+}
+
+////// Number Theory //////
+
+// Return the 64 bits of `src` starting at bit `at`.
+static uint64_t bitsAt(const bn_* src, size_t at) {
+  size_t i = at / 64;
+  unsigned sh = at % 64;
+  uint64_t lo = wordAt(src, i);
+  if (sh == 0) { return lo; }
+  return (lo >> sh) | (wordAt(src, i + 1) << (64 - sh));
+}
+
+bl_result bn__divexact(bn_* dst, const bn_* n, const bn_* d) {
+  BL_STAT(n->len + d->len);
+  if (dst->len < n->len) { return BL_OVERFLOW; }
+  // remove the factors of two, so that the (odd) divisor has an inverse modulo 2^64
+  size_t tz = bn__ctz(d);
+  size_t dWords = (bn__nbits(d) - tz + 63) / 64;
+  size_t nWords = (dst->len + 7) / 8;
+  if (dst != n) {
+    memcpy(&dst->base256le[0], &n->base256le[0], n->len);
+  }
+  memset(&dst->base256le[n->len], 0, dst->len - n->len);
+  for (size_t i = 0; i < nWords; ++i) {
+    setWordAt(dst, i, bitsAt(dst, 64 * i + tz));
+  }
+  uint64_t d0 = bitsAt(d, tz);
+  uint64_t inv = d0; // correct to three bits, and each Newton step doubles that
+  for (int i = 0; i < 5; ++i) { inv *= 2 - d0 * inv; }
+  // each quotient word clears the lowest remaining word, and then takes its place
+  for (size_t i = 0; i < nWords; ++i) {
+    uint64_t q = wordAt(dst, i) * inv;
+    if (q == 0) { continue; }
+    uint64_t carry = 0, borrow = 0;
+    for (size_t j = 0; i + j < nWords; ++j) {
+      uint64_t hi = 0;
+      uint64_t lo = j < dWords ? bn__mul64(q, bitsAt(d, 64 * j + tz), &hi) : 0;
+      lo += carry;
+      hi += lo < carry;
+      uint64_t w = wordAt(dst, i + j);
+      uint64_t diff = w - lo - borrow;
+      borrow = w < lo || (w == lo && borrow);
+      setWordAt(dst, i + j, diff);
+      carry = hi;
+      if (j >= dWords && carry == 0 && borrow == 0) { break; }
+    }
+    setWordAt(dst, i, q);
+  }
+  return BL_OK;
+}
+
+size_t bn__sizeof_gcd(const bn_* a, const bn_* b) {
+  BL_STAT(a->len + b->len);
+  size_t aLen = (bn__nbits(a) + 7) / 8;
+  size_t bLen = (bn__nbits(b) + 7) / 8;
+  if (aLen == 0) { return bLen; }
+  if (bLen == 0) { return aLen; }
+  return min(aLen, bLen);
+}
+
+// Work space for GCD is a pair of word arrays, each as long as the longer operand.
+static size_t gcdWords(const bn_* a, const bn_* b) {
+  return (max(a->len, b->len) + 7) / 8;
+}
+
+size_t bn__sizeof_gcd_scratch(const bn_* a, const bn_* b) {
+  BL_STAT(a->len + b->len);
+  // leave room to align the words
+  return 2 * 8 * gcdWords(a, b) + sizeof(uint64_t);
+}
+
+// A natural number as an array of 64-bit words, least significant first, without leading zero words.
+typedef struct limbs {
+  uint64_t* w;
+  size_t n;
+} limbs;
+
+static size_t limbsBitlen(limbs x) {
+  return x.n == 0 ? 0 : 64 * (x.n - 1) + bn__bitlen64(x.w[x.n - 1]);
+}
+
+static void limbsNormalize(limbs* x) {
+  while (x->n != 0 && x->w[x->n - 1] == 0) { --x->n; }
+}
+
+// Return the 64 bits of `x` starting at bit `at`.
+static uint64_t limbsBitsAt(limbs x, size_t at) {
+  size_t i = at / 64;
+  unsigned sh = at % 64;
+  uint64_t lo = i < x.n ? x.w[i] : 0;
+  if (sh == 0) { return lo; }
+  uint64_t hi = i + 1 < x.n ? x.w[i + 1] : 0;
+  return (lo >> sh) | (hi << (64 - sh));
+}
+
+static bl_ord limbsCmp(limbs x, limbs y) {
+  if (x.n != y.n) { return x.n < y.n ? BL_LT : BL_GT; }
+  for (size_t i = x.n; i > 0; --i) {
+    if (x.w[i - 1] != y.w[i - 1]) { return x.w[i - 1] < y.w[i - 1] ? BL_LT : BL_GT; }
+  }
+  return BL_EQ;
+}
+
+static uint64_t gcd64(uint64_t u, uint64_t v) {
+  if (u == 0) { return v; }
+  if (v == 0) { return u; }
+  unsigned k = bn__ctz64(u | v);
+  u = u >> bn__ctz64(u);
+  do {
+    v = v >> bn__ctz64(v);
+    if (u > v) { uint64_t t = u; u = v; v = t; }
+    v -= u;
+  } while (v != 0);
+  return u << k;
+}
+
+// Cofactor magnitudes for the extended GCD of `a` and `b`.
+// With `σ = -1` if `neg` and `+1` otherwise, the invariants are `u ≡ σ·su·a` and `v ≡ -σ·sv·a (mod b)`.
+// The cofactors alternate in sign like this through any sequence of Euclidean steps, so only their magnitudes need arithmetic.
+typedef struct cofactors {
+  limbs su, sv;
+  bool neg;
+} cofactors;
+
+// Replace `u` by `u - (q × v) << s`, which must not be negative.
+static void submulShifted(limbs* u, limbs v, uint64_t q, size_t s) {
+  size_t off = s / 64;
+  unsigned sh = s % 64;
+  uint64_t carry = 0, borrow = 0, prev = 0;
+  for (size_t j = 0; off + j < u->n; ++j) {
+    // the next word of `q × v`, then of that shifted by `sh`
+    uint64_t hi = 0;
+    uint64_t lo = j < v.n ? bn__mul64(q, v.w[j], &hi) : 0;
+    lo += carry;
+    hi += lo < carry;
+    carry = hi;
+    uint64_t p = sh == 0 ? lo : (lo << sh) | (prev >> (64 - sh));
+    prev = lo;
+    uint64_t w = u->w[off + j];
+    u->w[off + j] = w - p - borrow;
+    borrow = w < p || (w == p && borrow);
+    if (j > v.n && carry == 0 && prev == 0 && borrow == 0) { break; }
+  }
+  limbsNormalize(u);
+}
+
+// Replace `u` by `u + (q × v) << s`; `u` must have room for the result.
+static void addmulShifted(limbs* u, limbs v, uint64_t q, size_t s) {
+  size_t off = s / 64;
+  unsigned sh = s % 64;
+  uint64_t carry = 0, sum = 0, prev = 0;
+  for (; u->n < off; ++u->n) { u->w[u->n] = 0; }
+  for (size_t j = 0; j <= v.n + 1 || sum != 0; ++j) {
+    uint64_t hi = 0;
+    uint64_t lo = j < v.n ? bn__mul64(q, v.w[j], &hi) : 0;
+    lo += carry;
+    hi += lo < carry;
+    carry = hi;
+    uint64_t p = sh == 0 ? lo : (lo << sh) | (prev >> (64 - sh));
+    prev = lo;
+    uint64_t w = off + j < u->n ? u->w[off + j] : 0;
+    uint64_t r = w + p;
+    uint64_t c = r < p;
+    r += sum;
+    c += r < sum;
+    u->w[off + j] = r;
+    sum = c;
+    if (off + j >= u->n) { u->n = off + j + 1; }
+  }
+  limbsNormalize(u);
+}
+
+// Reduce `u ≥ v > 0` by a multiple of `v`, using a quotient estimated from their leading words.
+// This removes up to about 31 bits from `u` when it is much larger than `v`.
+static void reduceStep(limbs* u, limbs v, cofactors* cf) {
+  size_t nu = limbsBitlen(*u), nv = limbsBitlen(v);
+  // underestimate the quotient with the top 64 bits of `u` over one more than the top 32 bits of `v`
+  size_t vAt = nv > 32 ? nv - 32 : 0;
+  size_t uAt = nu > vAt + 64 ? nu - 64 : vAt;
+  uint64_t vt = limbsBitsAt(v, vAt) + (vAt != 0);
+  uint64_t ut = limbsBitsAt(*u, uAt);
+  uint64_t q = ut / vt;
+  if (q == 0) { q = 1; }
+  submulShifted(u, v, q, uAt - vAt);
+  if (cf != NULL) { addmulShifted(&cf->su, cf->sv, q, uAt - vAt); }
+}
+
+// Apply `(u, v) ← (a·u + b·v, c·u + d·v)`, where the signs of each pair differ and both results are non-negative.
+static void combine(limbs* u, limbs* v, int64_t a, int64_t b, int64_t c, int64_t d) {
+  // split each result into a positive and negative term
+  bool uFirst = b <= 0, vFirst = d <= 0;
+  uint64_t uPos = uFirst ? a : b, uNeg = uFirst ? -(uint64_t)b : -(uint64_t)a;
+  uint64_t vPos = vFirst ? c : d, vNeg = vFirst ? -(uint64_t)d : -(uint64_t)c;
+  uint64_t uc1 = 0, uc2 = 0, vc1 = 0, vc2 = 0;
+  size_t n = max(u->n, v->n);
+  for (size_t i = 0; i < n; ++i) {
+    uint64_t x = i < u->n ? u->w[i] : 0;
+    uint64_t y = i < v->n ? v->w[i] : 0;
+    uint64_t hi1, hi2, lo1, lo2;
+    lo1 = bn__mul64(uPos, uFirst ? x : y, &hi1);
+    lo1 += uc1; hi1 += lo1 < uc1;
+    lo2 = bn__mul64(uNeg, uFirst ? y : x, &hi2);
+    lo2 += uc2; hi2 += lo2 < uc2;
+    uint64_t uw = lo1 - lo2;
+    uc1 = hi1; uc2 = hi2 + (lo1 < lo2);
+    lo1 = bn__mul64(vPos, vFirst ? x : y, &hi1);
+    lo1 += vc1; hi1 += lo1 < vc1;
+    lo2 = bn__mul64(vNeg, vFirst ? y : x, &hi2);
+    lo2 += vc2; hi2 += lo2 < vc2;
+    uint64_t vw = lo1 - lo2;
+    vc1 = hi1; vc2 = hi2 + (lo1 < lo2);
+    u->w[i] = uw;
+    v->w[i] = vw;
+  }
+  u->n = v->n = n;
+  limbsNormalize(u);
+  limbsNormalize(v);
+}
+
+// Apply `(x, y) ← (a·x + b·y, c·x + d·y)`; both must have room for the results.
+static void combineAdd(limbs* x, limbs* y, uint64_t a, uint64_t b, uint64_t c, uint64_t d) {
+  uint64_t xc = 0, yc = 0;
+  size_t n = max(x->n, y->n);
+  for (size_t i = 0; i < n; ++i) {
+    uint64_t xw = i < x->n ? x->w[i] : 0;
+    uint64_t yw = i < y->n ? y->w[i] : 0;
+    uint64_t hi1, hi2, lo1, lo2;
+    lo1 = bn__mul64(a, xw, &hi1);
+    lo2 = bn__mul64(b, yw, &hi2);
+    lo1 += lo2; hi1 += hi2 + (lo1 < lo2);
+    lo1 += xc; hi1 += lo1 < xc;
+    xc = hi1;
+    uint64_t xr = lo1;
+    lo1 = bn__mul64(c, xw, &hi1);
+    lo2 = bn__mul64(d, yw, &hi2);
+    lo1 += lo2; hi1 += hi2 + (lo1 < lo2);
+    lo1 += yc; hi1 += lo1 < yc;
+    yc = hi1;
+    x->w[i] = xr;
+    y->w[i] = lo1;
+  }
+  x->w[n] = xc;
+  y->w[n] = yc;
+  x->n = y->n = n + 1;
+  limbsNormalize(x);
+  limbsNormalize(y);
+}
+
+// Run Euclid's algorithm on the leading 62 bits of `u ≥ v`, for as long as the quotients are certain to match those of `u` and `v`
+// (Knuth's Algorithm L), then apply the accumulated steps to the full numbers.
+// Return whether any progress was made.
+static bool lehmerStep(limbs* u, limbs* v, cofactors* cf) {
+  size_t nu = limbsBitlen(*u);
+  size_t at = nu > 62 ? nu - 62 : 0;
+  int64_t uh = limbsBitsAt(*u, at) & ((UINT64_C(1) << 62) - 1);
+  int64_t vh = limbsBitsAt(*v, at) & ((UINT64_C(1) << 62) - 1);
+  int64_t a = 1, b = 0, c = 0, d = 1;
+  while (vh + c > 0 && vh + d > 0 && uh + a >= 0 && uh + b >= 0) {
+    int64_t q = (uh + a) / (vh + c);
+    if (q != (uh + b) / (vh + d)) { break; }
+    int64_t t;
+    t = a - q * c; a = c; c = t;
+    t = b - q * d; b = d; d = t;
+    t = uh - q * vh; uh = vh; vh = t;
+  }
+  if (b == 0) { return false; }
+  combine(u, v, a, b, c, d);
+  if (cf != NULL) {
+    // magnitudes add, and the sign of each new cofactor follows from which of its terms is positive
+    bool neg = cf->neg;
+    combineAdd(&cf->su, &cf->sv,
+               a < 0 ? -(uint64_t)a : (uint64_t)a, b < 0 ? -(uint64_t)b : (uint64_t)b,
+               c < 0 ? -(uint64_t)c : (uint64_t)c, d < 0 ? -(uint64_t)d : (uint64_t)d);
+    cf->neg = b <= 0 ? neg : !neg;
+  }
+  return true;
+}
+
+// Run the Euclidean algorithm until `v` is zero, leaving the gcd in `u`.
+// When `cf` is given, track the cofactors of `u` and `v` as well.
+static void euclid(limbs* u, limbs* v, cofactors* cf) {
+  while (true) {
+    if (limbsCmp(*u, *v) == BL_LT) {
+      limbs t = *u; *u = *v; *v = t;
+      if (cf != NULL) {
+        t = cf->su; cf->su = cf->sv; cf->sv = t;
+        cf->neg = !cf->neg;
+      }
+    }
+    if (v->n == 0) { return; }
+    if (u->n == 1 && cf == NULL) {
+      u->w[0] = gcd64(u->w[0], v->w[0]);
+      return;
+    }
+    if (!lehmerStep(u, v, cf)) {
+      reduceStep(u, *v, cf);
+    }
+  }
+}
+
+// Take `n` words from the scratch space, which must already be aligned.
+static limbs carveLimbs(uint8_t** at, size_t n) {
+  limbs out = { (uint64_t*)*at, n };
+  *at += 8 * n;
+  return out;
+}
+
+// Align scratch space for words.
+static uint8_t* alignLimbs(bn_* scratch) {
+  uintptr_t p = (uintptr_t)&scratch->base256le[0];
+  p = (p + sizeof(uint64_t) - 1) / sizeof(uint64_t) * sizeof(uint64_t);
+  return &scratch->base256le[0] + (p - (uintptr_t)&scratch->base256le[0]);
+}
+
+static void loadLimbs(limbs* dst, const bn_* src) {
+  for (size_t i = 0; i < dst->n; ++i) { dst->w[i] = wordAt(src, i); }
+  limbsNormalize(dst);
+}
+
+// Write `src` into `dst`, failing if it does not fit.
+static bl_result storeLimbs(bn_* dst, limbs src) {
+  if (limbsBitlen(src) > 8 * dst->len) { return BL_OVERFLOW; }
+  bn__blank(dst);
+  for (size_t i = 0; i < src.n; ++i) { setWordAt(dst, i, src.w[i]); }
+  return BL_OK;
+}
+
+bl_result bn__gcd(bn_* dst, const bn_* a, const bn_* b, bn_* scratch) {
+  BL_STAT(a->len + b->len);
+  size_t nWords = gcdWords(a, b);
+  if (scratch == NULL || scratch->len < bn__sizeof_gcd_scratch(a, b)) { return BL_OVERFLOW; }
+  uint8_t* at = alignLimbs(scratch);
+  limbs u = carveLimbs(&at, nWords);
+  limbs v = carveLimbs(&at, nWords);
+  loadLimbs(&u, a);
+  loadLimbs(&v, b);
+  euclid(&u, &v, NULL);
+  return storeLimbs(dst, u);
+}
+
+size_t bn__sizeof_gcdext_s(const bn_* a, const bn_* b) {
+  BL_STAT(a->len + b->len);
+  return b->len + 1;
+}
+
+size_t bn__sizeof_gcdext_t(const bn_* a, const bn_* b) {
+  BL_STAT(a->len + b->len);
+  return a->len + 1;
+}
+
+size_t bn__sizeof_gcdext_scratch(const bn_* a, const bn_* b) {
+  BL_STAT(a->len + b->len);
+  // cofactors are bounded by `b`, with a word of room for each step to overshoot before normalizing
+  size_t cfWords = (b->len + 7) / 8 + 2;
+  size_t sLen = bn__sizeof_gcdext_s(a, b);
+  return 2 * 8 * gcdWords(a, b) + 2 * 8 * cfWords + sizeof(uint64_t)
+       + bn__sizeof_carve(sLen) + bn__sizeof_carve(8 * gcdWords(a, b)) + 2 * bn__sizeof_carve(a->len + sLen + 1);
+}
+
+bl_result bn__gcdext(bn_* g, bz_* s, bz_* t, const bn_* a, const bn_* b, bn_* scratch) {
+  BL_STAT(a->len + b->len);
+  if (scratch == NULL || scratch->len < bn__sizeof_gcdext_scratch(a, b)) { return BL_OVERFLOW; }
+  uint8_t* at = alignLimbs(scratch);
+  uint8_t* end = &scratch->base256le[0] + scratch->len;
+  size_t nWords = gcdWords(a, b);
+  size_t cfWords = (b->len + 7) / 8 + 2;
+  limbs u = carveLimbs(&at, nWords);
+  limbs v = carveLimbs(&at, nWords);
+  cofactors cf = { carveLimbs(&at, cfWords), carveLimbs(&at, cfWords), false };
+  loadLimbs(&u, a);
+  loadLimbs(&v, b);
+  bn__blank(s->magnitude);
+  bn__blank(t->magnitude);
+  s->isNeg = t->isNeg = false;
+  if (v.n == 0) {
+    // gcd(a, 0) = a = 1·a + 0·b
+    if (u.n != 0) {
+      if (s->magnitude->len == 0) { return BL_OVERFLOW; }
+      s->magnitude->base256le[0] = 1;
+    }
+    return storeLimbs(g, u);
+  }
+  cf.su.w[0] = 1; cf.su.n = 1;
+  cf.sv.n = 0;
+  euclid(&u, &v, &cf);
+  bl_result err = storeLimbs(g, u);
+  if (err != BL_OK) { return err; }
+  if (cf.su.n == 0) {
+    // `b` divides `a`, so gcd(a, b) = b = 0·a + 1·b
+    if (t->magnitude->len == 0) { return BL_OVERFLOW; }
+    t->magnitude->base256le[0] = 1;
+    return BL_OK;
+  }
+  bn_* sMag = bn__carve(&at, end, bn__sizeof_gcdext_s(a, b));
+  if (sMag == NULL) { return BL_OVERFLOW; }
+  err = storeLimbs(sMag, cf.su);
+  if (err != BL_OK) { return err; }
+  bn__normalize(sMag);
+  err = bn__copy(s->magnitude, sMag);
+  if (err != BL_OK) { return err; }
+  s->isNeg = cf.neg;
+  // `t = (g - s·a) / b`, which is exact and has the opposite sign to `s`
+  bn_* prod = bn__carve(&at, end, a->len + sMag->len + 1);
+  if (prod == NULL) { return BL_OVERFLOW; }
+  bn__blank(prod);
+  err = bn__mul(prod, sMag, a);
+  if (err != BL_OK) { return err; }
+  // a normalized copy of the gcd, so that its length cannot exceed that of the product
+  bn_* gNorm = bn__carve(&at, end, 8 * u.n);
+  if (gNorm == NULL) { return BL_OVERFLOW; }
+  storeLimbs(gNorm, u);
+  bn__normalize(gNorm);
+  err = s->isNeg ? bn__add(prod, prod, gNorm) : bn__sub(prod, prod, gNorm);
+  if (err != BL_OK) { return err; }
+  bn_* quo = bn__carve(&at, end, prod->len);
+  if (quo == NULL) { return BL_OVERFLOW; }
+  bn__divexact(quo, prod, b);
+  bn__normalize(quo);
+  t->isNeg = !s->isNeg;
+  return bn__copy(t->magnitude, quo);
+}
+
+////// Tuning //////
+
+static const bn__thresholds defaultThresholds = { BN__KARATSUBA_WORDS, BN__RADIX_WORDS, BN__RECIP_WORDS };
+
+// Below these, the recursive algorithms would not shrink their subproblems.
+static const bn__thresholds minThresholds = { 4, 2, 2 };
+
+// Above these, a threshold counted in digits (at most 64 to a word) could overflow; they are far beyond any number that fits in memory.
+static const bn__thresholds maxThresholds = { SIZE_MAX / 64, SIZE_MAX / 64, SIZE_MAX / 64 };
+
+static bn__thresholds thresholds = { BN__KARATSUBA_WORDS, BN__RADIX_WORDS, BN__RECIP_WORDS };
+
+static size_t threshold(size_t src, size_t dflt, size_t lo, size_t hi) {
+  return src == 0 ? dflt : min(max(src, lo), hi);
+}
+
+bn__thresholds bn__get_thresholds(void) {
+  return thresholds;
+}
+
+void bn__set_thresholds(bn__thresholds src) {
+  thresholds.karatsubaWords = threshold(src.karatsubaWords, defaultThresholds.karatsubaWords, minThresholds.karatsubaWords, maxThresholds.karatsubaWords);
+  thresholds.radixWords = threshold(src.radixWords, defaultThresholds.radixWords, minThresholds.radixWords, maxThresholds.radixWords);
+  thresholds.recipWords = threshold(src.recipWords, defaultThresholds.recipWords, minThresholds.recipWords, maxThresholds.recipWords);
+}
+
+////// Fast Multiplication //////
+
+// Place `a * b` in the `aLen + bLen` words at `r`, which must not overlap either input.
+static void mulBasecase(uint64_t* r, const uint64_t* a, size_t aLen, const uint64_t* b, size_t bLen) {
+  memset(r, 0, 8 * (aLen + bLen));
+  for (size_t i = 0; i < aLen; ++i) {
+    uint64_t carry = 0;
+    for (size_t j = 0; j < bLen; ++j) {
+      uint64_t hi;
+      uint64_t lo = bn__mul64(a[i], b[j], &hi);
+      lo += carry;
+      hi += lo < carry;
+      lo += r[i + j];
+      hi += lo < r[i + j];
+      r[i + j] = lo;
+      carry = hi;
+    }
+    r[i + bLen] = carry;
+  }
+}
+
+// Place `x + y` in the `xn` words at `r`, where `yn ≤ xn`, and return the carry out.
+static uint64_t addWords(uint64_t* r, const uint64_t* x, size_t xn, const uint64_t* y, size_t yn) {
+  uint64_t carry = 0;
+  for (size_t i = 0; i < xn; ++i) {
+    uint64_t w = x[i] + carry;
+    carry = w < carry;
+    if (i < yn) {
+      w += y[i];
+      carry += w < y[i];
+    }
+    r[i] = w;
+  }
+  return carry;
+}
+
+// Subtract the `xn` words at `x` from the `n` words at `r` in place, where `xn ≤ n`, discarding any borrow out of the top.
+static void subWords(uint64_t* r, size_t n, const uint64_t* x, size_t xn) {
+  uint64_t borrow = 0;
+  for (size_t i = 0; i < n && (i < xn || borrow != 0); ++i) {
+    uint64_t y = i < xn ? x[i] : 0;
+    uint64_t w = r[i] - y;
+    uint64_t out = r[i] < y;
+    out |= w < borrow;
+    r[i] = w - borrow;
+    borrow = out;
+  }
+}
+
+// Return the number of words of scratch space used by `karatsuba` on `n`-word operands.
+// This mirrors the decisions `karatsuba` makes: a forked level needs separate scratch space for each of its products.
+static size_t karatsubaScratch(size_t n, const bl__fork* par) {
+  if (n < thresholds.karatsubaWords) { return 0; }
+  size_t m = n / 2, h = n - m;
+  if (par != NULL && n >= par->minWords) {
+    return 4 * (h + 1) + karatsubaScratch(m, par) + karatsubaScratch(h, par) + karatsubaScratch(h + 1, par);
+  }
+  return 4 * (h + 1) + karatsubaScratch(h + 1, par);
+}
+
+static void karatsuba(uint64_t* r, const uint64_t* a, const uint64_t* b, size_t n, uint64_t* scratch, const bl__fork* par);
+
+typedef struct karatsubaTask {
+  uint64_t* r;
+  const uint64_t* a;
+  const uint64_t* b;
+  size_t n;
+  uint64_t* scratch;
+  const bl__fork* par;
+} karatsubaTask;
+
+static void karatsubaRun(void* arg) {
+  karatsubaTask* t = arg;
+  karatsuba(t->r, t->a, t->b, t->n, t->scratch, t->par);
+}
+
+// Place `a * b` in the `2n` words at `r`, where both inputs have `n` words.
+// With `a = a1·X^m + a0` and `b = b1·X^m + b0`, the middle product `a0·b1 + a1·b0` is `(a0 + a1)(b0 + b1) - a0·b0 - a1·b1`.
+// The three products are independent, so above `par->minWords` they are forked off to run concurrently;
+// they write disjoint memory, so the result is the same however they are scheduled.
+static void karatsuba(uint64_t* r, const uint64_t* a, const uint64_t* b, size_t n, uint64_t* scratch, const bl__fork* par) {
+  if (n < thresholds.karatsubaWords) {
+    mulBasecase(r, a, n, b, n);
+    return;
+  }
+  size_t m = n / 2, h = n - m;
+  uint64_t* sa = scratch;
+  uint64_t* sb = sa + (h + 1);
+  uint64_t* t = sb + (h + 1);
+  uint64_t* rest = t + 2 * (h + 1);
+  sa[h] = addWords(sa, a + m, h, a, m);
+  sb[h] = addWords(sb, b + m, h, b, m);
+  if (par != NULL && n >= par->minWords) {
+    uint64_t* s0 = rest;
+    uint64_t* s2 = s0 + karatsubaScratch(m, par);
+    uint64_t* s1 = s2 + karatsubaScratch(h, par);
+    karatsubaTask hiTask = { r + 2 * m, a + m, b + m, h, s2, par };
+    karatsubaTask midTask = { t, sa, sb, h + 1, s1, par };
+    void* hiJob = par->fork(par->ctx, karatsubaRun, &hiTask);
+    void* midJob = par->fork(par->ctx, karatsubaRun, &midTask);
+    karatsuba(r, a, b, m, s0, par);
+    if (hiJob != NULL) { par->join(par->ctx, hiJob); }
+    if (midJob != NULL) { par->join(par->ctx, midJob); }
+  }
+  else {
+    karatsuba(r, a, b, m, rest, par);
+    karatsuba(r + 2 * m, a + m, b + m, h, rest, par);
+    karatsuba(t, sa, sb, h + 1, rest, par);
+  }
+  subWords(t, 2 * (h + 1), r, 2 * m);
+  subWords(t, 2 * (h + 1), r + 2 * m, 2 * h);
+  // the middle product is less than `2 · X^n`, so its top word is zero and adding it cannot carry out of `r`
+  addWords(r + m, r + m, 2 * n - m, t, 2 * h + 1);
+}
+
+// Return the number of words in `src` once normalized.
+static size_t wordLen(const bn_* src) {
+  size_t len = src->len;
+  while (len != 0 && src->base256le[len - 1] == 0) { --len; }
+  return (len + 7) / 8;
+}
+
+// Return the number of words of scratch space used by `mulWords` on `xn`- and `yn`-word operands.
+static size_t mulWordsScratch(size_t xn, size_t yn, const bl__fork* par) {
+  size_t n = min(xn, yn);
+  if (n < thresholds.karatsubaWords) { return 0; }
+  // a product and zero-padded copy of one chunk
+  return 3 * n + karatsubaScratch(n, par);
+}
+
+// Place `x * y` in the `xn + yn` words at `r`, which must not overlap either input.
+static void mulWords(uint64_t* r, const uint64_t* x, size_t xn, const uint64_t* y, size_t yn, uint64_t* scratch, const bl__fork* par) {
+  if (xn < yn) {
+    const uint64_t* tmp = x; x = y; y = tmp;
+    size_t tmpN = xn; xn = yn; yn = tmpN;
+  }
+  if (yn < thresholds.karatsubaWords) {
+    mulBasecase(r, x, xn, y, yn);
+    return;
+  }
+  // split the longer operand into chunks as long as the shorter, so every product is balanced
+  uint64_t* prod = scratch;
+  uint64_t* pad = prod + 2 * yn;
+  uint64_t* rest = pad + yn;
+  memset(r, 0, 8 * (xn + yn));
+  for (size_t off = 0; off < xn; off += yn) {
+    size_t chunk = min(yn, xn - off);
+    memset(pad, 0, 8 * yn);
+    memcpy(pad, x + off, 8 * chunk);
+    karatsuba(prod, pad, y, yn, rest, par);
+    addWords(r + off, r + off, xn + yn - off, prod, min(2 * yn, xn + yn - off));
+  }
+}
+
+size_t bn__sizeof_karatsuba_scratch(const bn_* a, const bn_* b, const bl__fork* par) {
+  BL_STAT(a->len + b->len);
+  size_t aLen = wordLen(a), bLen = wordLen(b);
+  // the operands and product as words, work space, and alignment
+  size_t nWords = 2 * (aLen + bLen) + mulWordsScratch(aLen, bLen, par);
+  return 8 * nWords + sizeof(uint64_t);
+}
+
+bl_result bn__karatsuba(bn_* dst, const bn_* a, const bn_* b, bn_* scratch, const bl__fork* par) {
+  BL_STAT(a->len + b->len);
+  if (scratch == NULL || scratch->len < bn__sizeof_karatsuba_scratch(a, b, par)) { return BL_OVERFLOW; }
+  uint8_t* at = alignLimbs(scratch);
+  limbs x = carveLimbs(&at, wordLen(a));
+  limbs y = carveLimbs(&at, wordLen(b));
+  limbs r = carveLimbs(&at, x.n + y.n);
+  loadLimbs(&x, a);
+  loadLimbs(&y, b);
+  mulWords(r.w, x.w, x.n, y.w, y.n, (uint64_t*)at, par);
+  limbsNormalize(&r);
+  return storeLimbs(dst, r);
+}
+
+////// Roots //////
+
+// Divide `dst` in place by `d`, returning the remainder.
+static uint32_t divSmall(bn_* dst, uint32_t d) {
+  uint64_t rem = 0;
+  for (size_t i = dst->len; i > 0; --i) {
+    rem = (rem << 8) | dst->base256le[i - 1];
+    dst->base256le[i - 1] = rem / d;
+    rem = rem % d;
+  }
+  return rem;
+}
+
+// Return `log2(m)`, for `m ∈ [1, 2]`, to within a few units in the last place.
+// With `s = (m - 1) / (m + 1) ≤ 1/3`, `ln(m) = 2·(s + s^3/3 + s^5/5 + ...)`, whose terms fall by a factor of at least 9.
+static double log2Frac(double m) {
+  double s = (m - 1) / (m + 1), s2 = s * s, term = s, sum = 0;
+  for (int i = 1; i < 40; i += 2) {
+    sum += term / i;
+    term *= s2;
+  }
+  return 2 * sum / 0.69314718055994530942;
+}
+
+// Return `2^t`, for `t ∈ [0, 1]`, to within a few units in the last place, from the Taylor series of `e^(t·ln 2)`.
+static double exp2Frac(double t) {
+  double x = t * 0.69314718055994530942, term = 1, sum = 1;
+  for (int i = 1; i < 24; ++i) {
+    term *= x / i;
+    sum += term;
+  }
+  return sum;
+}
+
+// Place an overestimate of `⌊n^(1/k)⌋` in `dst`, for `n` of more than `k` bits.
+// The estimate is `2^(log2(n) / k)`, taken from the leading 53 bits of `n`, and is within a few parts in 2^32 of the root.
+static void rootSeed(bn_* dst, const bn_* n, unsigned k) {
+  size_t nbits = bn__nbits(n);
+  // `n < m × 2^(nbits - 1)` for `m ∈ (1, 2]`
+  uint64_t top = nbits > 53 ? bitsAt(n, nbits - 53) : bitsAt(n, 0) << (53 - nbits);
+  double m = (double)(top & ((UINT64_C(1) << 53) - 1)) * 0x1p-52 + 0x1p-52;
+  // the root is less than `y × 2^q`, where `y^k = m × 2^r`
+  size_t q = (nbits - 1) / k, r = (nbits - 1) % k;
+  double y = exp2Frac(((double)r + log2Frac(m)) / k);
+  // pad the estimate to absorb any rounding in the logarithms
+  size_t sh = q > 52 ? q - 52 : 0;
+  uint64_t lead = (uint64_t)(y * (1 + 0x1p-32) * (double)(UINT64_C(1) << (q - sh))) + 2;
+  bn__blank(dst);
+  bn__storeN(&dst->base256le[0], lead, dst->len < 8 ? dst->len : 8);
+  bn__shl(dst, sh);
+}
+
+// Place `a·b` in `*tmp` and exchange it with `*dst`; `a` and `b` may be `*dst`.
+static void mulInto(bn_** dst, bn_** tmp, const bn_* a, const bn_* b, size_t room) {
+  bn_* p = *tmp;
+  p->len = room;
+  bn__blank(p);
+  bn__mul(p, a, b);
+  *tmp = *dst;
+  (*tmp)->len = room;
+  *dst = p;
+  bn__normalize(p);
+}
+
+// Place `x^e` in `*dst`, or return false (leaving a partial power) as soon as it exceeds `limit`.
+// The power is built by squaring and multiplying from the leading bit of `e`, so every partial power is at most `x^e`.
+// Both buffers must have room for `limit->len + x->len` digits; they may be exchanged.
+static bool powBounded(bn_** dst, bn_** tmp, const bn_* x, unsigned e, const bn_* limit) {
+  size_t room = (*dst)->len;
+  size_t limitBits = bn__nbits(limit);
+  bn__blank(*dst);
+  (*dst)->base256le[0] = 1;
+  bn__normalize(*dst);
+  unsigned bit = 1;
+  while (bit <= e / 2) { bit = bit << 1; }
+  bool ok = true;
+  for (; bit != 0 && e != 0; bit = bit >> 1) {
+    // a square of at least `2^(2·nbits - 2)` is sure to exceed the limit, and is not computed
+    size_t nbits = bn__nbits(*dst);
+    if (nbits != 0 && 2 * nbits - 2 >= limitBits) { ok = false; break; }
+    mulInto(dst, tmp, *dst, *dst, room);
+    if (e & bit) { mulInto(dst, tmp, *dst, x, room); }
+    if (bn__cmp(*dst, limit) == BL_GT) { ok = false; break; }
+  }
+  (*dst)->len = room;
+  return ok;
+}
+
+size_t bn__sizeof_iroot(const bn_* n, unsigned k) {
+  BL_STAT(n->len);
+  if (k == 0) { return 0; }
+  return (n->len + k - 1) / k;
+}
+
+size_t bn__sizeof_iroot_rem(const bn_* n, unsigned k) {
+  BL_STAT(n->len);
+  return n->len;
+}
+
+// Digits for the Newton iterates, which may exceed the root by a little.
+static size_t iterDigits(const bn_* n, unsigned k) {
+  return bn__sizeof_iroot(n, k) + 8;
+}
+
+size_t bn__sizeof_iroot_scratch(const bn_* n, unsigned k) {
+  BL_STAT(n->len);
+  size_t xLen = iterDigits(n, k);
+  size_t pLen = n->len + xLen;
+  return bn__sizeof_carve(xLen) + 4 * bn__sizeof_carve(pLen) + bn__sizeof_carve(pLen + 5);
+}
+
+bl_result bn__iroot(bn_* root, bn_* rem, const bn_* n, unsigned k, bn_* scratch) {
+  BL_STAT(n->len);
+  if (k == 0) { return BL_DIVZERO; }
+  if (scratch == NULL || scratch->len < bn__sizeof_iroot_scratch(n, k)) { return BL_OVERFLOW; }
+  uint8_t* at = &scratch->base256le[0];
+  uint8_t* end = at + scratch->len;
+  size_t xLen = iterDigits(n, k);
+  size_t pLen = n->len + xLen;
+  bn_* x = bn__carve(&at, end, xLen);
+  bn_* p = bn__carve(&at, end, pLen);
+  bn_* tmp = bn__carve(&at, end, pLen);
+  bn_* quo = bn__carve(&at, end, pLen);
+  bn_* mod = bn__carve(&at, end, pLen);
+  bn_* acc = bn__carve(&at, end, pLen + 5);
+  bn__blank(x);
+  if (k == 1) {
+    bn__copy(x, n);
+  }
+  else if (bn__nbits(n) <= k) {
+    // `n < 2^k`, so the root of a non-zero `n` is 1
+    if (bn__nbits(n) != 0) { x->base256le[0] = 1; }
+  }
+  else {
+    // Newton's method decreases from any overestimate until it reaches the floor of the root
+    rootSeed(x, n, k);
+    while (true) {
+      // quo = n / x^(k-1), which is zero when the power exceeds `n`
+      bn__blank(quo);
+      if (powBounded(&p, &tmp, x, k - 1, n)) {
+        bn__blank(mod);
+        bn__normalize(p);
+        bn__divmod(quo, mod, n, p);
+        p->len = pLen;
+      }
+      // acc = ((k - 1)·x + quo) / k
+      acc->len = pLen + 5;
+      bn__copy(acc, x);
+      size_t used = xLen;
+      bn__muladd1(acc, &used, k - 1, 0);
+      bn__add(acc, acc, quo);
+      divSmall(acc, k);
+      if (bn__cmp(acc, x) != BL_LT) { break; }
+      bn__normalize(acc);
+      bn__copy(x, acc);
+    }
+  }
+  if (rem != NULL) {
+    // rem = n - x^k, where the power cannot exceed `n`
+    bn__normalize(x);
+    powBounded(&p, &tmp, x, k, n);
+    bn__normalize(p);
+    bl_result err = bn__sub(rem, n, p);
+    if (err != BL_OK) { return err; }
+  }
+  bn__normalize(x);
+  return bn__copy(root, x);
+}
+
+size_t bn__sizeof_isqrt(const bn_* n) {
+  BL_STAT(n->len);
+  return bn__sizeof_iroot(n, 2);
+}
+
+size_t bn__sizeof_isqrt_rem(const bn_* n) {
+  BL_STAT(n->len);
+  return bn__sizeof_iroot_rem(n, 2);
+}
+
+size_t bn__sizeof_isqrt_scratch(const bn_* n) {
+  BL_STAT(n->len);
+  return bn__sizeof_iroot_scratch(n, 2);
+}
+
+bl_result bn__isqrt(bn_* root, bn_* rem, const bn_* n, bn_* scratch) {
+  BL_STAT(n->len);
+  return bn__iroot(root, rem, n, 2, scratch);
+}
+
+////// Serialization //////
+
+// Return the number of digits needed to hold the `nGroups` groups found by walking from `leastSig` by `stride`
+// (forwards for LEB128, backwards for VLQ).
+static size_t sizeofGroups(const uint8_t* leastSig, ptrdiff_t stride, size_t nGroups) {
+  for (size_t i = nGroups; i > 0; --i) {
+    uint8_t group = leastSig[(ptrdiff_t)(i - 1) * stride] & 0x7F;
+    if (group != 0) {
+      size_t nbits = 7 * (i - 1) + bn__bitlen64(group);
+      return nbits / 8 + (nbits % 8 != 0);
+    }
+  }
+  return 0;
+}
+
+static bl_result decodeGroups(bn_* dst, const uint8_t* leastSig, ptrdiff_t stride, size_t nGroups) {
+  bn__blank(dst);
+  for (size_t g = 0; g < nGroups; g += 8) {
+    uint64_t w = 0;
+    for (size_t i = min(nGroups, g + 8); i > g; --i) {
+      w = (w << 7) | (leastSig[(ptrdiff_t)(i - 1) * stride] & 0x7F);
+    }
+    if (bn__store56(dst, g / 8 * 7, w) != BL_OK) { return BL_OVERFLOW; }
+  }
+  return BL_OK;
+}
+
+size_t bn__sizeof_leb128(const bn_* src) {
+  BL_STAT(src->len);
+  size_t nbits = bn__nbits(src);
+  if (nbits == 0) { return 1; }
+  return nbits / 7 + (nbits % 7 != 0);
+}
+
+bl_result bn__leb128_encode(uint8_t* dst, size_t dstLen, const bn_* src) {
+  BL_STAT(src->len);
+  size_t nGroups = bn__sizeof_leb128(src);
+  if (dstLen < nGroups) { return BL_OVERFLOW; }
+  for (size_t g = 0; g < nGroups; g += 8) {
+    uint64_t w = bn__load56(src, g / 8 * 7);
+    for (size_t i = g; i < min(nGroups, g + 8); ++i) {
+      dst[i] = (w & 0x7F) | 0x80;
+      w = w >> 7;
+    }
+  }
+  dst[nGroups - 1] &= 0x7F;
+  return BL_OK;
+}
+
+size_t bn__sizeof_leb128_decode(const uint8_t* src, size_t srcLen) {
+  BL_STAT(srcLen);
+  size_t nGroups = bn__groupsLen(src, srcLen);
+  return sizeofGroups(src, 1, nGroups);
+}
+
+bl_result bn__leb128_decode(bn_* dst, size_t* nRead, const uint8_t* src, size_t srcLen) {
+  BL_STAT(srcLen);
+  size_t nGroups = bn__groupsLen(src, srcLen);
+  if (nGroups == 0) { return BL_SYNTAX; }
+  *nRead = nGroups;
+  return decodeGroups(dst, src, 1, nGroups);
+}
+
+bl_result bn__vlq_encode(uint8_t* dst, size_t dstLen, const bn_* src) {
+  BL_STAT(src->len);
+  size_t nGroups = bn__sizeof_leb128(src);
+  if (dstLen < nGroups) { return BL_OVERFLOW; }
+  for (size_t g = 0; g < nGroups; g += 8) {
+    uint64_t w = bn__load56(src, g / 8 * 7);
+    for (size_t i = g; i < min(nGroups, g + 8); ++i) {
+      dst[nGroups - 1 - i] = (w & 0x7F) | 0x80;
+      w = w >> 7;
+    }
+  }
+  dst[nGroups - 1] &= 0x7F;
+  return BL_OK;
+}
+
+size_t bn__sizeof_vlq_decode(const uint8_t* src, size_t srcLen) {
+  BL_STAT(srcLen);
+  size_t nGroups = bn__groupsLen(src, srcLen);
+  if (nGroups == 0) { return 0; }
+  return sizeofGroups(&src[nGroups - 1], -1, nGroups);
+}
+
+bl_result bn__vlq_decode(bn_* dst, size_t* nRead, const uint8_t* src, size_t srcLen) {
+  BL_STAT(srcLen);
+  size_t nGroups = bn__groupsLen(src, srcLen);
+  if (nGroups == 0) { return BL_SYNTAX; }
+  *nRead = nGroups;
+  return decodeGroups(dst, &src[nGroups - 1], -1, nGroups);
+}
+
+////// Parsing //////
+
+// ceil(log2(radix) * 2^16), indexed by radix
+static const uint32_t log2Radix[37] = {
+  0, 0,
+  65536, 103873, 131072, 152170, 169409, 183983, 196608, 207745, 217706, 226718,
+  234945, 242513, 249519, 256042, 262144, 267876, 273281, 278393, 283242, 287855,
+  292254, 296457, 300481, 304340, 308049, 311617, 315055, 318373, 321578, 324679,
+  327680, 330590, 333412, 336153, 338817
+};
+
+static unsigned digitValue(char c) {
+  if ('0' <= c && c <= '9') { return c - '0'; }
+  if ('a' <= c && c <= 'z') { return c - 'a' + 10; }
+  if ('A' <= c && c <= 'Z') { return c - 'A' + 10; }
+  return UINT_MAX;
+}
+
+void bn__parser_init(bn__parser* p, unsigned radix) {
+  BL_STAT(0);
+  assert(2 <= radix && radix <= 36);
+  p->radix = radix;
+  p->chunkMax = 0;
+  p->chunkScale = 1;
+  while (p->chunkScale <= UINT64_MAX / radix) {
+    p->chunkScale *= radix;
+    p->chunkMax += 1;
+  }
+  p->chunk = 0;
+  p->chunkDigits = 0;
+  p->nDigits = 0;
+  p->used = 0;
+}
+
+size_t bn__sizeof_parser(const bn__parser* p, size_t nMore) {
+  BL_STAT(0);
+  size_t nDigits = p->nDigits + nMore;
+  assert(nDigits <= SIZE_MAX >> 20);
+  size_t nbits = (nDigits * log2Radix[p->radix] + 0xFFFF) >> 16;
+  return nbits / 8 + (nbits % 8 != 0);
+}
+
+bl_result bn__parser_feed(bn__parser* p, bn_* acc, const char* src, size_t srcLen) {
+  BL_STAT(srcLen);
+  if (acc->len < bn__sizeof_parser(p, srcLen)) { return BL_OVERFLOW; }
+  for (size_t i = 0; i < srcLen; ++i) {
+    unsigned d = digitValue(src[i]);
+    if (d >= p->radix) { return BL_SYNTAX; }
+    p->chunk = p->chunk * p->radix + d;
+    p->chunkDigits += 1;
+    if (p->chunkDigits == p->chunkMax) {
+      bl_result err = bn__muladd1(acc, &p->used, p->chunkScale, p->chunk);
+      if (err != BL_OK) { return err; }
+      p->chunk = 0;
+      p->chunkDigits = 0;
+    }
+  }
+  p->nDigits += srcLen;
+  return BL_OK;
+}
+
+bl_result bn__parser_finish(bn__parser* p, bn_* acc) {
+  BL_STAT(0);
+  if (p->nDigits == 0) { return BL_SYNTAX; }
+  if (p->chunkDigits != 0) {
+    uint64_t scale = 1;
+    for (unsigned i = 0; i < p->chunkDigits; ++i) { scale *= p->radix; }
+    bl_result err = bn__muladd1(acc, &p->used, scale, p->chunk);
+    if (err != BL_OK) { return err; }
+    p->chunk = 0;
+    p->chunkDigits = 0;
+  }
+  acc->len = p->used;
+  return BL_OK;
+}
+
+////// Radix Conversion //////
+
+static const char digitChars[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+
+// Return the largest `c` such that `radix^c ≤ limit`, and store `radix^c` in `scale`.
+static unsigned digitsIn(unsigned radix, uint64_t limit, uint64_t* scale) {
+  unsigned c = 0;
+  uint64_t s = 1;
+  while (s <= limit / radix) {
+    s *= radix;
+    c += 1;
+  }
+  *scale = s;
+  return c;
+}
+
+// Return an upper bound on the number of digits needed to write a number of `nbits` bits in `radix`.
+static size_t radixDigits(size_t nbits, unsigned radix) {
+  assert(nbits <= SIZE_MAX >> 17);
+  // `log2Radix` rounds up, so one less rounds down
+  return (nbits * 65536 + log2Radix[radix] - 2) / (log2Radix[radix] - 1);
+}
+
+// Return the number of words that hold any number written with `len` digits in `radix`.
+static size_t radixWords(size_t len, unsigned radix) {
+  assert(len <= SIZE_MAX >> 20);
+  return ((len * log2Radix[radix] + 0xFFFF) >> 16) / 64 + 1;
+}
+
+static size_t wordsNormalize(const uint64_t* x, size_t n) {
+  while (n != 0 && x[n - 1] == 0) { --n; }
+  return n;
+}
+
+static bl_ord cmpWords(const uint64_t* x, size_t xn, const uint64_t* y, size_t yn) {
+  for (size_t i = max(xn, yn); i > 0; --i) {
+    uint64_t a = i <= xn ? x[i - 1] : 0;
+    uint64_t b = i <= yn ? y[i - 1] : 0;
+    if (a != b) { return a < b ? BL_LT : BL_GT; }
+  }
+  return BL_EQ;
+}
+
+// Return whether the `n` words at `x` are greater than `β^e`, where `β = 2^64` and `e < n`.
+static bool abovePow(const uint64_t* x, size_t n, size_t e) {
+  for (size_t i = e + 1; i < n; ++i) {
+    if (x[i] != 0) { return true; }
+  }
+  if (x[e] != 1) { return x[e] > 1; }
+  return wordsNormalize(x, e) != 0;
+}
+
+static void incWords(uint64_t* x, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    if (++x[i] != 0) { break; }
+  }
+}
+
+static void decWords(uint64_t* x, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    if (x[i]-- != 0) { break; }
+  }
+}
+
+// Place `x << s` (for `s < 64`) in the `n` words at `r`, which may be `x`, and return the bits shifted out.
+static uint64_t shlWords(uint64_t* r, const uint64_t* x, size_t n, unsigned s) {
+  uint64_t carry = 0;
+  for (size_t i = 0; i < n; ++i) {
+    uint64_t w = x[i];
+    r[i] = (w << s) | carry;
+    carry = s == 0 ? 0 : w >> (64 - s);
+  }
+  return carry;
+}
+
+// Place `x >> s` (for `s < 64`) in the `n` words at `r`.
+static void shrWords(uint64_t* r, const uint64_t* x, size_t n, unsigned s) {
+  for (size_t i = 0; i < n; ++i) {
+    uint64_t hi = s == 0 || i + 1 == n ? 0 : x[i + 1] << (64 - s);
+    r[i] = (x[i] >> s) | hi;
+  }
+}
+
+static bool forks(const bl__fork* par, size_t n) {
+  return par != NULL && n >= par->minWords;
+}
+
+// Return the number of words of scratch space used by `recip` on an `n`-word divisor.
+static size_t recipScratch(size_t n, const bl__fork* par) {
+  if (n <= thresholds.recipWords) { return n + 1; }
+  size_t h = n / 2 + 1;
+  size_t step = (n + h + 1) + (n + h + 2) + 2 * (2 * n + 1) + mulWordsScratch(n, n + 1, par);
+  return (h + 1) + max(recipScratch(h, par), step);
+}
+
+// Place `⌊β^(2n) / d⌋` in the `n + 1` words at `mu`, where `d` has `n` words and its top bit set.
+static void recip(uint64_t* mu, const uint64_t* d, size_t n, uint64_t* scratch, const bl__fork* par) {
+  if (n <= thresholds.recipWords) {
+    // long division, a bit at a time
+    uint64_t* rem = scratch;
+    memset(rem, 0, 8 * (n + 1));
+    memset(mu, 0, 8 * (n + 1));
+    for (size_t i = 128 * n + 1; i > 0; --i) {
+      size_t bit = i - 1;
+      rem[n] = shlWords(rem, rem, n, 1);
+      rem[0] |= bit == 128 * n;
+      if (cmpWords(rem, n + 1, d, n) != BL_LT) {
+        subWords(rem, n + 1, d, n);
+        mu[bit / 64] |= UINT64_C(1) << (bit % 64);
+      }
+    }
+    return;
+  }
+  // one Newton step from the reciprocal `muH` of the top `h` words of `d`:
+  // `mu = muH·β^l + muH·(β^(n+h) - d·muH) / β^(2h)`, which is then off by at most a few units
+  size_t h = n / 2 + 1, l = n - h;
+  uint64_t* muH = scratch;
+  uint64_t* p = muH + (h + 1);
+  uint64_t* e = p + (n + h + 1);
+  uint64_t* t = e + (n + h + 2);
+  uint64_t* u = t + (2 * n + 1);
+  uint64_t* rest = u + (2 * n + 1);
+  recip(muH, d + l, h, p, par);
+  mulWords(p, d, n, muH, h + 1, rest, par);
+  bool neg = p[n + h] != 0;
+  if (neg) { p[n + h] -= 1; }
+  else {
+    for (size_t i = 0; i < n + h; ++i) { p[i] = ~p[i]; }
+    incWords(p, n + h);
+  }
+  // the error is less than `2β^n`
+  mulWords(e, muH, h + 1, p, n + 1, rest, par);
+  memset(mu, 0, 8 * l);
+  memcpy(mu + l, muH, 8 * (h + 1));
+  if (neg) { subWords(mu, n + 1, e + 2 * h, l + 2); }
+  else { addWords(mu, mu, n + 1, e + 2 * h, l + 2); }
+  // correct the estimate so that `mu·d ≤ β^(2n) < (mu + 1)·d`
+  mulWords(t, d, n, mu, n + 1, rest, par);
+  while (abovePow(t, 2 * n + 1, 2 * n)) {
+    decWords(mu, n + 1);
+    subWords(t, 2 * n + 1, d, n);
+  }
+  for (;;) {
+    addWords(u, t, 2 * n + 1, d, n);
+    if (abovePow(u, 2 * n + 1, 2 * n)) { break; }
+    incWords(mu, n + 1);
+    memcpy(t, u, 8 * (2 * n + 1));
+  }
+}
+
+// An entry in the table of powers `radix^(c·2^k)`, where `radix^c` is the largest power of the radix that fits in a word.
+// When formatting, each power also has a reciprocal, so that dividing by it takes two multiplications.
+typedef struct radixPow {
+  uint64_t* w;
+  size_t n;
+  unsigned shift; // so that the top bit of `w << shift` is set
+  uint64_t* norm; // `w << shift`
+  uint64_t* inv; // `⌊β^(2n) / norm⌋`, in `n + 1` words
+} radixPow;
+
+// Return the number of words of `pows[k]`, or a bound on it if the table is not yet known.
+static size_t powWords(const radixPow* pows, int k) {
+  return pows != NULL ? pows[k].n : (size_t)1 << k;
+}
+
+// Return the least `k` such that numbers of `nDigits` digits are less than `radix^(c·2^(k+1))`.
+static int topLevel(size_t nDigits, unsigned c) {
+  int k = 0;
+  while (((size_t)c << (k + 1)) < nDigits) { ++k; }
+  return k;
+}
+
+// Return the number of words taken by the table of powers up to level `top`, with their reciprocals if `inverse`.
+static size_t powsWords(int top, bool inverse) {
+  size_t out = (top + 1) * ((sizeof(radixPow) + 7) / 8);
+  for (int k = 0; k <= top; ++k) {
+    size_t n = (size_t)1 << k;
+    out += inverse ? 3 * n + 1 : n;
+  }
+  return out;
+}
+
+// Return the number of words of scratch space used by `buildPows` up to level `top`.
+static size_t buildPowsScratch(int top, bool inverse, const bl__fork* par) {
+  size_t n = (size_t)1 << top;
+  size_t out = mulWordsScratch(n / 2, n / 2, par);
+  return inverse ? max(out, recipScratch(n, par)) : out;
+}
+
+// Carve the table of powers up to level `top` from `*at`, squaring each power to find the next.
+static radixPow* buildPows(uint8_t** at, int top, uint64_t scale, bool inverse, uint64_t* scratch, const bl__fork* par) {
+  radixPow* pows = (radixPow*)*at;
+  *at += 8 * (top + 1) * ((sizeof(radixPow) + 7) / 8);
+  for (int k = 0; k <= top; ++k) {
+    size_t cap = (size_t)1 << k;
+    radixPow* p = &pows[k];
+    p->w = carveLimbs(at, cap).w;
+    if (k == 0) {
+      p->w[0] = scale;
+      p->n = 1;
+    }
+    else {
+      const radixPow* prev = &pows[k - 1];
+      mulWords(p->w, prev->w, prev->n, prev->w, prev->n, scratch, par);
+      p->n = wordsNormalize(p->w, 2 * prev->n);
+    }
+    if (inverse) {
+      p->norm = carveLimbs(at, cap).w;
+      p->inv = carveLimbs(at, cap + 1).w;
+      p->shift = 64 - bn__bitlen64(p->w[p->n - 1]);
+      shlWords(p->norm, p->w, p->n, p->shift);
+      recip(p->inv, p->norm, p->n, scratch, par);
+    }
+  }
+  return pows;
+}
+
+// Return the number of words of scratch space used by `divPow` with an `n`-word power.
+static size_t divPowScratch(size_t n, const bl__fork* par) {
+  return (2 * n + 1) + (2 * n + 2) + (2 * n + 1) + mulWordsScratch(n + 1, n + 1, par);
+}
+
+// Divide the `xn` words at `x`, which must be less than `p->w` squared, by `p->w`.
+// The quotient is placed in the `n + 1` words at `q`, and the remainder in the `n` words at `r`.
+// This is Barrett's method: the quotient estimated from the top words of `x` and the reciprocal is short by at most two.
+static void divPow(uint64_t* q, uint64_t* r, const uint64_t* x, size_t xn, const radixPow* p, uint64_t* scratch, const bl__fork* par) {
+  size_t n = p->n;
+  uint64_t* xs = scratch;
+  uint64_t* q2 = xs + (2 * n + 1);
+  uint64_t* t = q2 + (2 * n + 2);
+  uint64_t* rest = t + (2 * n + 1);
+  memset(xs, 0, 8 * (2 * n + 1));
+  xs[xn] = shlWords(xs, x, xn, p->shift);
+  mulWords(q2, xs + (n - 1), n + 1, p->inv, n + 1, rest, par);
+  memcpy(q, q2 + (n + 1), 8 * (n + 1));
+  mulWords(t, q, n + 1, p->norm, n, rest, par);
+  subWords(xs, 2 * n + 1, t, 2 * n + 1);
+  while (cmpWords(xs, 2 * n + 1, p->norm, n) != BL_LT) {
+    subWords(xs, 2 * n + 1, p->norm, n);
+    incWords(q, n + 1);
+  }
+  shrWords(r, xs, n, p->shift);
+}
+
+typedef struct formatting {
+  const radixPow* pows;
+  unsigned radix;
+  unsigned chunkDigits;
+  unsigned smallDigits; // digits peeled off at once by `formatSmall`
+  uint64_t smallScale; // `radix^smallDigits`, which is less than 2^32
+  const bl__fork* par;
+} formatting;
+
+// Return the number of words of scratch space used by `formatNode` at level `k`, on a number of at most `m` words.
+// The base case needs a copy of its number, which is no larger than the radix threshold, nor than the number itself.
+static size_t formatScratch(const radixPow* pows, int k, size_t m, const bl__fork* par) {
+  size_t small = min(m, thresholds.radixWords);
+  if (k < 0) { return small; }
+  size_t n = powWords(pows, k);
+  size_t kids = formatScratch(pows, k - 1, n + 1, par) * (forks(par, n) ? 2 : 1);
+  return max(small, (2 * n + 1) + max(divPowScratch(n, par), kids));
+}
+
+// Write the digits of the `xn` (at most the radix threshold) words at `x` to the characters before `end`,
+// then pad them with zeros to at least `nPad` characters, and return the number of characters written.
+static size_t formatSmall(char* end, const uint64_t* x, size_t xn, size_t nPad, uint64_t* scratch, const formatting* f) {
+  uint64_t* w = scratch;
+  memcpy(w, x, 8 * xn);
+  char* at = end;
+  uint64_t s = f->smallScale;
+  while (xn != 0) {
+    // divide half a word at a time, so that no double-word division is needed
+    uint64_t rem = 0;
+    for (size_t i = xn; i > 0; --i) {
+      uint64_t hi = (rem << 32) | (w[i - 1] >> 32);
+      uint64_t lo = ((hi % s) << 32) | (w[i - 1] & 0xFFFFFFFF);
+      w[i - 1] = ((hi / s) << 32) | (lo / s);
+      rem = lo % s;
+    }
+    xn = wordsNormalize(w, xn);
+    for (unsigned j = 0; j < f->smallDigits && (xn != 0 || rem != 0); ++j) {
+      *--at = digitChars[rem % f->radix];
+      rem = rem / f->radix;
+    }
+  }
+  while ((size_t)(end - at) < nPad) { *--at = '0'; }
+  return end - at;
+}
+
+static size_t formatNode(char* end, const uint64_t* x, size_t xn, int k, bool padded, uint64_t* scratch, const formatting* f);
+
+typedef struct formatTask {
+  char* end;
+  const uint64_t* x;
+  size_t xn;
+  int k;
+  bool padded;
+  uint64_t* scratch;
+  const formatting* f;
+  size_t out;
+} formatTask;
+
+static void formatRun(void* arg) {
+  formatTask* t = arg;
+  t->out = formatNode(t->end, t->x, t->xn, t->k, t->padded, t->scratch, t->f);
+}
+
+// Write the digits of the `xn` words at `x`, which are less than `radix^(c·2^(k+1))`, to the characters before `end`,
+// and return the number of characters written; when `padded`, exactly `c·2^(k+1)` are written, with leading zeros.
+// The number is divided by the `k`th power: the remainder is written padded to `c·2^k` digits, and the quotient before it.
+// The halves write disjoint characters, so above `par->minWords` the high half is forked off.
+static size_t formatNode(char* end, const uint64_t* x, size_t xn, int k, bool padded, uint64_t* scratch, const formatting* f) {
+  size_t nPad = padded ? (size_t)f->chunkDigits << (k + 1) : 0;
+  xn = wordsNormalize(x, xn);
+  if (k < 0 || xn <= thresholds.radixWords) { return formatSmall(end, x, xn, nPad, scratch, f); }
+  const radixPow* p = &f->pows[k];
+  size_t n = p->n;
+  uint64_t* q = scratch;
+  uint64_t* r = q + (n + 1);
+  uint64_t* rest = r + n;
+  divPow(q, r, x, xn, p, rest, f->par);
+  if (!padded && wordsNormalize(q, n + 1) == 0) { return formatNode(end, r, n, k - 1, false, rest, f); }
+  size_t half = (size_t)f->chunkDigits << k;
+  formatTask hi = { end - half, q, n + 1, k - 1, padded, rest, f, 0 };
+  formatTask lo = { end, r, n, k - 1, true, rest, f, 0 };
+  if (forks(f->par, n)) {
+    lo.scratch = rest + formatScratch(f->pows, k - 1, n + 1, f->par);
+    void* job = f->par->fork(f->par->ctx, formatRun, &hi);
+    formatRun(&lo);
+    if (job != NULL) { f->par->join(f->par->ctx, job); }
+  }
+  else {
+    formatRun(&lo);
+    formatRun(&hi);
+  }
+  return hi.out + lo.out;
+}
+
+size_t bn__sizeof_format(const bn_* src, unsigned radix) {
+  BL_STAT(src->len);
+  assert(2 <= radix && radix <= 36);
+  return max(1, radixDigits(bn__nbits(src), radix));
+}
+
+size_t bn__sizeof_format_scratch(const bn_* src, unsigned radix, const bl__fork* par) {
+  BL_STAT(src->len);
+  assert(2 <= radix && radix <= 36);
+  // the number as words, then the table of powers, then work space
+  size_t n = wordLen(src);
+  size_t nWords = n + min(n, thresholds.radixWords);
+  if (n > thresholds.radixWords && (radix & (radix - 1)) != 0) {
+    uint64_t scale;
+    int top = topLevel(radixDigits(bn__nbits(src), radix), digitsIn(radix, UINT64_MAX, &scale));
+    nWords += powsWords(top, true) + max(buildPowsScratch(top, true, par), formatScratch(NULL, top, n, par));
+  }
+  return 8 * nWords + sizeof(uint64_t);
+}
+
+bl_result bn__format(char* dst, size_t dstLen, size_t* nWritten, const bn_* src, unsigned radix, bn_* scratch, const bl__fork* par) {
+  BL_STAT(src->len);
+  size_t len = bn__sizeof_format(src, radix);
+  if (dstLen < len) { return BL_OVERFLOW; }
+  if (scratch == NULL || scratch->len < bn__sizeof_format_scratch(src, radix, par)) { return BL_OVERFLOW; }
+  uint8_t* at = alignLimbs(scratch);
+  limbs x = carveLimbs(&at, wordLen(src));
+  loadLimbs(&x, src);
+  if (x.n == 0) {
+    dst[0] = '0';
+    *nWritten = 1;
+    return BL_OK;
+  }
+  if ((radix & (radix - 1)) == 0) {
+    // every digit is a group of bits
+    unsigned b = bn__ctz64(radix);
+    size_t out = (limbsBitlen(x) + b - 1) / b;
+    for (size_t i = 0; i < out; ++i) {
+      dst[out - 1 - i] = digitChars[limbsBitsAt(x, b * i) & (radix - 1)];
+    }
+    *nWritten = out;
+    return BL_OK;
+  }
+  uint64_t scale;
+  formatting f = { NULL, radix, digitsIn(radix, UINT64_MAX, &scale), 0, 0, par };
+  f.smallDigits = digitsIn(radix, UINT32_MAX, &f.smallScale);
+  int top = -1;
+  uint64_t* work = (uint64_t*)at;
+  if (x.n > thresholds.radixWords) {
+    top = topLevel(len, f.chunkDigits);
+    work = (uint64_t*)(at + 8 * powsWords(top, true));
+    f.pows = buildPows(&at, top, scale, true, work, par);
+  }
+  size_t out = formatNode(dst + len, x.w, x.n, top, false, work, &f);
+  memmove(dst, dst + len - out, out);
+  *nWritten = out;
+  return BL_OK;
+}
+
+typedef struct parsing {
+  const radixPow* pows;
+  unsigned radix;
+  unsigned chunkDigits;
+  const bl__fork* par;
+} parsing;
+
+// Return the number of words of scratch space used by `parseNode` at level `k`.
+static size_t parseScratch(const radixPow* pows, int k, const parsing* p) {
+  if (k < 0) { return 0; }
+  size_t half = radixWords((size_t)p->chunkDigits << k, p->radix);
+  size_t n = powWords(pows, k);
+  size_t kids = parseScratch(pows, k - 1, p) * (forks(p->par, n) ? 2 : 1);
+  return 2 * half + max(kids, (half + n) + mulWordsScratch(half, n, p->par));
+}
+
+// Place the number written by the `len` characters at `str` in the `outN` words at `out`, a chunk of digits at a time.
+static bl_result parseSmall(uint64_t* out, size_t outN, const char* str, size_t len, const parsing* p) {
+  memset(out, 0, 8 * outN);
+  size_t used = 0;
+  for (size_t i = 0; i < len;) {
+    // the first chunk takes the odd digits, so the rest are full
+    size_t m = i == 0 ? (len - 1) % p->chunkDigits + 1 : p->chunkDigits;
+    uint64_t chunk = 0, scale = 1;
+    for (size_t j = i; j < i + m; ++j) {
+      unsigned d = digitValue(str[j]);
+      if (d >= p->radix) { return BL_SYNTAX; }
+      chunk = chunk * p->radix + d;
+      scale *= p->radix;
+    }
+    uint64_t carry = chunk;
+    for (size_t w = 0; w < used; ++w) {
+      uint64_t hi;
+      uint64_t lo = bn__mul64(out[w], scale, &hi);
+      lo += carry;
+      hi += lo < carry;
+      out[w] = lo;
+      carry = hi;
+    }
+    if (carry != 0) { out[used++] = carry; }
+    i += m;
+  }
+  return BL_OK;
+}
+
+static bl_result parseNode(uint64_t* out, size_t outN, const char* str, size_t len, int k, uint64_t* scratch, const parsing* p);
+
+typedef struct parseTask {
+  uint64_t* out;
+  size_t outN;
+  const char* str;
+  size_t len;
+  int k;
+  uint64_t* scratch;
+  const parsing* p;
+  bl_result err;
+} parseTask;
+
+static void parseRun(void* arg) {
+  parseTask* t = arg;
+  t->err = parseNode(t->out, t->outN, t->str, t->len, t->k, t->scratch, t->p);
+}
+
+// Place the number written by the `len ≤ c·2^(k+1)` characters at `str` in the `outN` words at `out`.
+// The last `c·2^k` digits are split off, so that the number is `high·radix^(c·2^k) + low`;
+// the halves are independent, so above `par->minWords` the high half is forked off.
+static bl_result parseNode(uint64_t* out, size_t outN, const char* str, size_t len, int k, uint64_t* scratch, const parsing* p) {
+  while (k >= 0 && ((size_t)p->chunkDigits << k) >= len) { --k; }
+  if (k < 0 || len <= (size_t)p->chunkDigits * thresholds.radixWords) { return parseSmall(out, outN, str, len, p); }
+  const radixPow* pw = &p->pows[k];
+  size_t loLen = (size_t)p->chunkDigits << k, hiLen = len - loLen;
+  size_t hiN = radixWords(hiLen, p->radix), loN = radixWords(loLen, p->radix);
+  uint64_t* hi = scratch;
+  uint64_t* lo = hi + hiN;
+  uint64_t* rest = lo + loN;
+  parseTask hiT = { hi, hiN, str, hiLen, k - 1, rest, p, BL_OK };
+  parseTask loT = { lo, loN, str + hiLen, loLen, k - 1, rest, p, BL_OK };
+  if (forks(p->par, pw->n)) {
+    loT.scratch = rest + parseScratch(p->pows, k - 1, p);
+    void* job = p->par->fork(p->par->ctx, parseRun, &hiT);
+    parseRun(&loT);
+    if (job != NULL) { p->par->join(p->par->ctx, job); }
+  }
+  else {
+    parseRun(&loT);
+    parseRun(&hiT);
+  }
+  if (hiT.err != BL_OK) { return hiT.err; }
+  if (loT.err != BL_OK) { return loT.err; }
+  uint64_t* prod = rest;
+  mulWords(prod, hi, hiN, pw->w, pw->n, prod + (hiN + pw->n), p->par);
+  addWords(prod, prod, hiN + pw->n, lo, wordsNormalize(lo, loN));
+  // the words past `outN` are zero
+  size_t m = min(outN, hiN + pw->n);
+  memcpy(out, prod, 8 * m);
+  memset(out + m, 0, 8 * (outN - m));
+  return BL_OK;
+}
+
+size_t bn__sizeof_parse(size_t len, unsigned radix) {
+  BL_STAT(len);
+  assert(len <= SIZE_MAX >> 20);
+  size_t nbits = (len * log2Radix[radix] + 0xFFFF) >> 16;
+  return nbits / 8 + (nbits % 8 != 0);
+}
+
+size_t bn__sizeof_parse_scratch(size_t len, unsigned radix, const bl__fork* par) {
+  BL_STAT(len);
+  assert(2 <= radix && radix <= 36);
+  // the number as words, then the table of powers, then work space
+  size_t nWords = radixWords(len, radix);
+  uint64_t scale;
+  parsing p = { NULL, radix, digitsIn(radix, UINT64_MAX, &scale), par };
+  if (len > (size_t)p.chunkDigits * thresholds.radixWords) {
+    int top = topLevel(len, p.chunkDigits);
+    nWords += powsWords(top, false) + max(buildPowsScratch(top, false, par), parseScratch(NULL, top, &p));
+  }
+  return 8 * nWords + sizeof(uint64_t);
+}
+
+bl_result bn__parse(bn_* dst, const char* str, size_t len, unsigned radix, bn_* scratch, const bl__fork* par) {
+  BL_STAT(len);
+  if (len == 0) { return BL_SYNTAX; }
+  if (scratch == NULL || scratch->len < bn__sizeof_parse_scratch(len, radix, par)) { return BL_OVERFLOW; }
+  uint8_t* at = alignLimbs(scratch);
+  limbs x = carveLimbs(&at, radixWords(len, radix));
+  uint64_t scale;
+  parsing p = { NULL, radix, digitsIn(radix, UINT64_MAX, &scale), par };
+  int top = -1;
+  uint64_t* work = (uint64_t*)at;
+  if (len > (size_t)p.chunkDigits * thresholds.radixWords) {
+    top = topLevel(len, p.chunkDigits);
+    work = (uint64_t*)(at + 8 * powsWords(top, false));
+    p.pows = buildPows(&at, top, scale, false, work, par);
+  }
+  bl_result err = parseNode(x.w, x.n, str, len, top, work, &p);
+  if (err != BL_OK) { return err; }
+  limbsNormalize(&x);
+  return storeLimbs(dst, x);
+}
+
 ////// Destructive //////
 
 bl_result bn__wrbit(bn_* dst, size_t i, bool val) {
+  BL_STAT(dst->len);
   size_t digit = i / 8;
   size_t bit = i % 8;
   if (digit >= dst->len) { return BL_OVERFLOW; }
@@ -304,6 +2158,7 @@ bl_result bn__wrbit(bn_* dst, size_t i, bool val) {
 }
 
 void bn__shr(bn_* dst, size_t amt) {
+  BL_STAT(dst->len);
   size_t digits = amt / 8; // the number of full digits to shift
   size_t bits = amt % 8;
   // work our way from least-to-most significant so as not to overwrite needed bits
@@ -321,6 +2176,7 @@ void bn__shr(bn_* dst, size_t amt) {
 }
 
 void bn__shl(bn_* dst, size_t amt) {
+  BL_STAT(dst->len);
   size_t digits = amt / 8; // the number of full digits to shift
   size_t bits = amt % 8;
   // work our way from most-to-least significant so as not to overwrite needed bits
@@ -342,6 +2198,7 @@ void bn__shl(bn_* dst, size_t amt) {
 }
 
 void bn__normalize(bn_* dst) {
+  BL_STAT(dst->len);
   while (dst->len != 0) {
     if (dst->base256le[dst->len - 1] == 0) {
       --dst->len;
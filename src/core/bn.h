@@ -47,6 +47,19 @@ bl_result bn__umax(bn_* dst, uintmax_t src);
 // Return whether bit `i` (zero-indexed, little-endian) is set (return one) or not (return zero).
 bool bn__bit(const bn_* src, size_t i);
 
+// Return the number of significant bits in `src` (zero for zero).
+// This function does not require input normalization.
+size_t bn__nbits(const bn_* src);
+
+// Return the number of trailing zero bits in `src` (zero for zero).
+// Shifting right by this amount leaves an odd number.
+// This function does not require input normalization.
+size_t bn__ctz(const bn_* src);
+
+// Return the number of set bits in `src`.
+// This function does not require input normalization.
+size_t bn__popcount(const bn_* src);
+
 // Return if the first number is less than/equal to/greater than the second.
 // This function does not require input normalization.
 bl_ord bn__cmp(const bn_* a, const bn_* b);
@@ -65,6 +78,7 @@ size_t bn__sizeof_xor(const bn_* a, const bn_* b);
 ////// Arithmetic //////
 
 bl_result bn__inc(bn_* dst, const bn_* src);
+// Return the maximum size (in base256 digits) of `src + 1`, which is exact for normalized input unless its leading digits are all 0xFF.
 size_t bn__sizeof_inc(const bn_* src);
 
 // Place the result of `a + b` in `dst`.
@@ -75,6 +89,8 @@ size_t bn__sizeof_inc(const bn_* src);
 // and may be returned if `dst` has less than `bn__sizeof_add(a, b)` space.
 bl_result bn__add(bn_* dst, const bn_* a, const bn_* b);
 // Return the maximum size (in base256 digits) that must be allocated to hold a `bn_` for the result of `a + b`.
+// It is predicted from the leading digits of the inputs, and is exact for normalized inputs
+// unless the leading seven digits of the sum are all 0xFF.
 size_t bn__sizeof_add(const bn_* a, const bn_* b);
 
 bl_result bn__dec(bn_* dst, const bn_* src);
@@ -98,8 +114,32 @@ size_t bn__sizeof_sub(const bn_* a, const bn_* b);
 // and may be returned if `dst` has less than `bn__sizeof_mul(a, b)` space.
 bl_result bn__mul(bn_* dst, const bn_* a, const bn_* b);
 // Return the maximum size (in base256 digits) that must be allocated to hold a `bn_` for the result of `a * b`.
+// It is predicted from the leading digits of the inputs, and is exact for normalized inputs
+// unless the product of their leading three digits is within a few parts in 2^16 of a power of 256.
 size_t bn__sizeof_mul(const bn_* a, const bn_* b);
 
+// Add `a * k` to `dst` in place, a machine word at a time, in a single pass over `a`.
+// This is the step of Horner's rule (`acc = acc * k + d` is `bn__addmul_1(d, acc, k)`) and the row of a schoolbook product.
+// The destination keeps its length, and may be `a`; inputs need not be normalized, and the output is not normalized.
+// `BL_OVERFLOW` is returned when the sum does not fit in `dst`, in which case the contents of `dst` are undefined.
+bl_result bn__addmul_1(bn_* dst, const bn_* a, uint64_t k);
+// Return the maximum size (in base256 digits) of `acc + a * k`.
+size_t bn__sizeof_addmul_1(const bn_* acc, const bn_* a, uint64_t k);
+
+// Subtract `a * k` from `dst` in place, as `bn__addmul_1`.
+// `BL_OVERFLOW` is returned when `a * k > dst`, in which case the contents of `dst` are undefined.
+bl_result bn__submul_1(bn_* dst, const bn_* a, uint64_t k);
+
+// Place the result of `a * b + c` in `dst`.
+// Each word of `b` adds one row `a * b[j]` to a copy of `c` with `bn__addmul_1`, so there is no separate pass to add `c`.
+// This is schoolbook multiplication; for long operands, `bn__karatsuba` followed by `bn__add` is faster.
+// The destination need not be blank, and may be `c`, but must not overlap `a` or `b`.
+// Inputs need not be normalized, and the output is not normalized.
+// `BL_OVERFLOW` is returned if `dst` has less than `bn__sizeof_fma(a, b, c)` digits.
+bl_result bn__fma(bn_* dst, const bn_* a, const bn_* b, const bn_* c);
+// Return the maximum size (in base256 digits) of `a * b + c`.
+size_t bn__sizeof_fma(const bn_* a, const bn_* b, const bn_* c);
+
 // Place the result of `n / d` in `q` and `n % d` in `r`.
 // The destinations _must_ be provided blank.
 // Inputs need not be normalized (but the algorithm will complete faster if they are), and the output is not normalized.
@@ -115,10 +155,267 @@ size_t bn__sizeof_mul(const bn_* a, const bn_* b);
 //   and this library's namign conventions will stay consistend with that.
 bl_result bn__divmod(bn_* q, bn_* r, const bn_* n, const bn_* d);
 // Return the maximum size (in base256 digits) that must be allocated to hold a `bn_` for the result of `a / b`.
+// It is exact for normalized `a` unless the leading seven digits of `a` and `b` are equal.
 size_t bn__sizeof_div(const bn_* n, const bn_* d);
 // Return the maximum size (in base256 digits) that must be allocated to hold a `bn_` for the result of `a % b`.
 size_t bn__sizeof_mod(const bn_* n, const bn_* d);
 
+////// Wrapping Arithmetic //////
+
+// These compute only the low `nbits` bits of their results (that is, modulo `2^nbits`),
+// as the unsigned arithmetic of a fixed-width target type does.
+// No work is spent on the bits that would be thrown away; in particular, `bn__mul_lo` skips the upper half of the products.
+// The destination need not be blank, but must have at least `bn__sizeof_wrap(nbits)` digits (otherwise `BL_OVERFLOW` is returned);
+// any digits past those are zeroed.
+// Inputs need not be normalized, and the output is not normalized.
+
+// Return the number of base256 digits that hold `nbits` bits.
+size_t bn__sizeof_wrap(size_t nbits);
+
+// Place `src mod 2^nbits` in `dst`, which may be `src`.
+bl_result bn__wrap(bn_* dst, const bn_* src, size_t nbits);
+
+// Place `(a + b) mod 2^nbits` in `dst`, which may be either input.
+bl_result bn__add_wrap(bn_* dst, const bn_* a, const bn_* b, size_t nbits);
+
+// Place `(a - b) mod 2^nbits` in `dst`, which may be either input.
+bl_result bn__sub_wrap(bn_* dst, const bn_* a, const bn_* b, size_t nbits);
+
+// Place `(a * b) mod 2^nbits` in `dst`, which must not overlap either input.
+bl_result bn__mul_lo(bn_* dst, const bn_* a, const bn_* b, size_t nbits);
+
+////// Number Theory //////
+
+// Place `n / d` in `dst`, where `d` is known to divide `n` exactly (the result is undefined otherwise).
+// This is much faster than `bn__divmod`, taking time proportional to the product of the lengths of the quotient and divisor.
+// The destination may be `n` itself, and must have at least `n->len` digits.
+// Inputs need not be normalized, and the output is not normalized.
+// `d` must not be zero.
+bl_result bn__divexact(bn_* dst, const bn_* n, const bn_* d);
+
+// Return the maximum size (in base256 digits) of `gcd(a, b)`.
+size_t bn__sizeof_gcd(const bn_* a, const bn_* b);
+// Return the number of base256 digits of scratch space needed to compute `gcd(a, b)`.
+size_t bn__sizeof_gcd_scratch(const bn_* a, const bn_* b);
+
+// Place the greatest common divisor of `a` and `b` in `dst` (where `gcd(0, 0) = 0`).
+// Single-word operands use binary GCD, and longer ones Lehmer's algorithm,
+// which does the work of many Euclidean steps with a few word operations and one pass over the operands.
+// Inputs need not be normalized, and the output is not normalized.
+// `BL_OVERFLOW` is returned if `dst` or `scratch` is too small.
+bl_result bn__gcd(bn_* dst, const bn_* a, const bn_* b, bn_* scratch);
+
+// Return the maximum size (in base256 digits) of the magnitude of the cofactor `s` of `a` in `bn__gcdext(g, s, t, a, b)`.
+size_t bn__sizeof_gcdext_s(const bn_* a, const bn_* b);
+// Return the maximum size (in base256 digits) of the magnitude of the cofactor `t` of `b` in `bn__gcdext(g, s, t, a, b)`.
+size_t bn__sizeof_gcdext_t(const bn_* a, const bn_* b);
+// Return the number of base256 digits of scratch space needed to compute `bn__gcdext(g, s, t, a, b)`.
+size_t bn__sizeof_gcdext_scratch(const bn_* a, const bn_* b);
+
+// Place `gcd(a, b)` in `g` and cofactors in `s` and `t` such that `g = s·a + t·b` (Bézout's identity).
+// The cofactors are the minimal ones found by the Euclidean algorithm: `|s| ≤ b / 2g` and `|t| ≤ a / 2g` unless either is zero or one.
+// The same Lehmer steps as `bn__gcd` are used, and `s` is tracked alongside them; `t` is then recovered with one exact division.
+// Inputs need not be normalized, and the outputs are not normalized.
+// `BL_OVERFLOW` is returned if any output or `scratch` is too small.
+struct bz_;
+bl_result bn__gcdext(bn_* g, struct bz_* s, struct bz_* t, const bn_* a, const bn_* b, bn_* scratch);
+
+
+////// Tuning //////
+
+// The sizes, in 64-bit words, at which the core switches to its asymptotically faster algorithms.
+// Their defaults are compiled in from `core/thresholds.h`, which `./BUILD.sh tune` fits to the build machine.
+typedef struct bn__thresholds {
+  size_t karatsubaWords; // multiplication: schoolbook below, Karatsuba at and above
+  size_t radixWords; // parsing and formatting: a chunk at a time up to, divide and conquer above
+  size_t recipWords; // reciprocals for formatting: bit by bit up to, Newton's method above
+} bn__thresholds;
+
+// Return the thresholds currently in effect.
+bn__thresholds bn__get_thresholds(void);
+
+// Replace the thresholds, so that each deployment host can be tuned without recompiling.
+// A zero field restores its compiled-in default, fields too small for the algorithms to recurse are raised,
+// and fields too large to count in digits are lowered.
+// Scratch sizes depend on the thresholds, so call this only while no other thread is using the core,
+// and not between querying a scratch size and using it.
+void bn__set_thresholds(bn__thresholds src);
+
+////// Kernels //////
+
+// The innermost loops of addition, subtraction, the bitwise operations and `bn__popcount` have several implementations:
+// the portable one (`"portable"`), which is the reference for the others,
+// and on x86-64 with GCC or Clang, `"avx2"` (ADX carry chains, AVX2 bitwise operations and POPCNT) and `"avx512"`.
+// The fastest the CPU supports is chosen at startup; the results are the same whichever is used.
+
+// Return the name of the implementation in use.
+const char* bn__get_kernels(void);
+
+// Return the name of the `i`th implementation built into the library, or `NULL` if there are not that many.
+// The CPU may not support all of them.
+const char* bn__kernels_name(size_t i);
+
+// Switch to the named implementation, returning false (and changing nothing) if it is unknown or the CPU does not support it.
+// Call this only while no other thread is using the core.
+bool bn__set_kernels(const char* name);
+
+////// Fast Multiplication //////
+
+// Callers who want huge products computed on several threads supply a way to run tasks concurrently;
+// the core never creates threads (or allocates) itself.
+// `fork` starts `task(arg)`, possibly on another thread, and returns a handle to pass to `join`,
+// or `NULL` if it has already run `task` to completion.
+// `join` waits for the task to complete.
+// Operands shorter than `minWords` 64-bit words are never split across tasks.
+typedef struct bl__fork {
+  void* (*fork)(void* ctx, void (*task)(void*), void* arg);
+  void (*join)(void* ctx, void* handle);
+  void* ctx;
+  size_t minWords;
+} bl__fork;
+
+// Return the number of base256 digits of scratch space needed to compute `bn__karatsuba(dst, a, b, scratch, par)`.
+size_t bn__sizeof_karatsuba_scratch(const bn_* a, const bn_* b, const bl__fork* par);
+
+// Place the result of `a * b` in `dst`, using Karatsuba's method above a threshold and word-at-a-time schoolbook below.
+// When `par` is not `NULL`, the independent sub-products of large operands are forked as tasks;
+// the result is identical to the serial (`par == NULL`) one.
+// The destination need not be blank, and needs at most `bn__sizeof_mul(a, b)` digits.
+// Inputs need not be normalized, and the output is not normalized.
+// `BL_OVERFLOW` is returned if `dst` or `scratch` is too small.
+bl_result bn__karatsuba(bn_* dst, const bn_* a, const bn_* b, bn_* scratch, const bl__fork* par);
+
+////// Roots //////
+
+// Return the maximum size (in base256 digits) of `⌊n^(1/k)⌋`.
+size_t bn__sizeof_iroot(const bn_* n, unsigned k);
+// Return the maximum size (in base256 digits) of `n - ⌊n^(1/k)⌋^k`.
+size_t bn__sizeof_iroot_rem(const bn_* n, unsigned k);
+// Return the number of base256 digits of scratch space needed to compute `⌊n^(1/k)⌋`.
+size_t bn__sizeof_iroot_scratch(const bn_* n, unsigned k);
+
+// Place `⌊n^(1/k)⌋` in `root`, and (unless `rem` is `NULL`) `n - root^k` in `rem`.
+// `n` is a perfect `k`th power exactly when the remainder is zero.
+// This is Newton's method, seeded from a floating-point estimate of the leading bits of `n`,
+// so only a few steps are needed after the first, each one power (by squaring) and one division.
+// When `k` is at least the number of bits of a non-zero `n`, the root is 1, and is returned without any steps.
+// Inputs need not be normalized, and the outputs are not normalized.
+// `BL_DIVZERO` is returned when `k` is zero, and `BL_OVERFLOW` if any output or `scratch` is too small.
+bl_result bn__iroot(bn_* root, bn_* rem, const bn_* n, unsigned k, bn_* scratch);
+
+// As the `iroot` functions, with `k = 2`.
+size_t bn__sizeof_isqrt(const bn_* n);
+size_t bn__sizeof_isqrt_rem(const bn_* n);
+size_t bn__sizeof_isqrt_scratch(const bn_* n);
+bl_result bn__isqrt(bn_* root, bn_* rem, const bn_* n, bn_* scratch);
+
+
+////// Serialization //////
+
+// LEB128 stores seven bits per byte, least significant group first, and sets the high bit of every byte but the last.
+// VLQ is the same, except that the most significant group comes first.
+// Both encodings of a number have the same length, and never use more groups than needed (zero is encoded as one zero byte).
+// The decoders accept redundant leading zero groups.
+
+// Return the exact number of bytes in the LEB128 (or VLQ) encoding of `src`.
+// The input need not be normalized.
+size_t bn__sizeof_leb128(const bn_* src);
+
+// Write the LEB128 encoding of `src` into the first `bn__sizeof_leb128(src)` bytes of `dst`.
+// `BL_OVERFLOW` is returned when `dstLen` is too small, in which case the contents of `dst` are undefined.
+bl_result bn__leb128_encode(uint8_t* dst, size_t dstLen, const bn_* src);
+
+// Return the exact number of base256 digits needed to hold the number LEB128-encoded at the start of `src`.
+// If `src` does not contain a complete encoding, zero is returned.
+size_t bn__sizeof_leb128_decode(const uint8_t* src, size_t srcLen);
+
+// Read a LEB128-encoded number from the start of `src` into `dst`, and store the number of bytes it occupied into `nRead`.
+// The destination need not be blank; the output is not normalized.
+// `BL_SYNTAX` is returned if `src` ends before the encoding does,
+// and `BL_OVERFLOW` when the number does not fit into `dst`; in both cases the contents of `dst` are undefined.
+bl_result bn__leb128_decode(bn_* dst, size_t* nRead, const uint8_t* src, size_t srcLen);
+
+// As `bn__leb128_encode`, but in VLQ format; `bn__sizeof_leb128` gives the size of the encoding.
+bl_result bn__vlq_encode(uint8_t* dst, size_t dstLen, const bn_* src);
+
+// As `bn__sizeof_leb128_decode`, but in VLQ format.
+size_t bn__sizeof_vlq_decode(const uint8_t* src, size_t srcLen);
+
+// As `bn__leb128_decode`, but in VLQ format.
+bl_result bn__vlq_decode(bn_* dst, size_t* nRead, const uint8_t* src, size_t srcLen);
+
+
+////// Parsing //////
+
+// The parser converts digits written in radix 2–36 into a number as they arrive, so the text of a large literal
+// never needs to be held in memory all at once.
+// Digits are gathered into a machine word until it is full, and only then folded into the accumulated number,
+// so the number is traversed once per word of digits rather than once per digit.
+// Letters (of either case) stand for the digits ten and above.
+
+typedef struct bn__parser {
+  unsigned radix;
+  unsigned chunkMax; // the number of digits that fit in a chunk
+  uint64_t chunkScale; // radix^chunkMax
+  uint64_t chunk; // digits not yet folded into the accumulator
+  unsigned chunkDigits;
+  size_t nDigits; // digits fed so far
+  size_t used; // digits of the accumulator holding its (normalized) value
+} bn__parser;
+
+// Prepare the parser to read a number in the given radix, which must be in 2–36.
+void bn__parser_init(bn__parser* p, unsigned radix);
+
+// Return the number of base256 digits the accumulator must have for the parser to be fed `nMore` more characters.
+size_t bn__sizeof_parser(const bn__parser* p, size_t nMore);
+
+// Feed characters to the parser, accumulating the number parsed so far into `acc`.
+// The same accumulator must be passed to every call, though it may be moved and grown in between;
+// only its first `p->used` digits are significant.
+// `BL_SYNTAX` is returned if a character is not a digit in the radix,
+// and `BL_OVERFLOW` if the accumulator has less than `bn__sizeof_parser(p, srcLen)` digits;
+// in both cases the state of the parser is undefined.
+bl_result bn__parser_feed(bn__parser* p, bn_* acc, const char* src, size_t srcLen);
+
+// Fold any remaining digits into the accumulator, and set its length to the result, which _is_ normalized.
+// `BL_SYNTAX` is returned if no digits were fed.
+bl_result bn__parser_finish(bn__parser* p, bn_* acc);
+
+////// Radix Conversion //////
+
+// Whole numbers are converted in one call by divide and conquer, which is subquadratic:
+// the digits are split at a power `radix^(c·2^k)` (where `radix^c` is the largest power of the radix that fits in a word),
+// and the halves converted independently.
+// The powers are computed once per conversion, by repeated squaring, and shared by every level of the recursion.
+// Parsing multiplies the high half by the power, and formatting divides by it using a precomputed reciprocal,
+// so both run at the speed of Karatsuba multiplication.
+// When `par` is not `NULL`, the halves of huge numbers are forked as tasks (see `bl__fork`);
+// the results do not depend on `par`.
+
+// Return the maximum size (in base256 digits) of a number written with `len` digits in `radix`.
+size_t bn__sizeof_parse(size_t len, unsigned radix);
+// Return the number of base256 digits of scratch space needed to compute `bn__parse(…, str, len, radix, scratch, par)`.
+size_t bn__sizeof_parse_scratch(size_t len, unsigned radix, const bl__fork* par);
+
+// Place the number written by the `len` characters at `str` in radix 2–36, most significant digit first, in `dst`.
+// Letters (of either case) stand for the digits ten and above.
+// The destination need not be blank, and the output is not normalized.
+// `BL_SYNTAX` is returned if there are no characters or any is not a digit in the radix,
+// and `BL_OVERFLOW` if `dst` or `scratch` is too small.
+bl_result bn__parse(bn_* dst, const char* str, size_t len, unsigned radix, bn_* scratch, const bl__fork* par);
+
+// Return the maximum number of characters needed to write `src` in `radix`.
+// This function does not require input normalization.
+size_t bn__sizeof_format(const bn_* src, unsigned radix);
+// Return the number of base256 digits of scratch space needed to compute `bn__format(…, src, radix, scratch, par)`.
+size_t bn__sizeof_format_scratch(const bn_* src, unsigned radix, const bl__fork* par);
+
+// Write `src` in radix 2–36 to the start of `dst`, most significant digit first, without a terminating nul,
+// and store the number of characters written in `nWritten`.
+// Lowercase letters stand for the digits ten and above, and zero is written as `0`.
+// `BL_OVERFLOW` is returned if `dstLen` is less than `bn__sizeof_format(src, radix)` or `scratch` is too small.
+bl_result bn__format(char* dst, size_t dstLen, size_t* nWritten, const bn_* src, unsigned radix, bn_* scratch, const bl__fork* par);
+
 
 ////// Destructive Operations //////
 
@@ -0,0 +1,59 @@
+#include "core/bq.h"
+#include "core/limb.h"
+
+////// Reduction //////
+
+size_t bq__sizeof_reduce_scratch(bq_ src) {
+  return bn__sizeof_carve(bn__sizeof_gcd(src.num.magnitude, src.den))
+       + bn__sizeof_carve(bn__sizeof_gcd_scratch(src.num.magnitude, src.den));
+}
+
+bl_result bq__reduce(bq_ x, bn_* scratch) {
+  if (scratch == NULL) { return BL_OVERFLOW; }
+  uint8_t* at = &scratch->base256le[0];
+  uint8_t* end = at + scratch->len;
+  bn_* g = bn__carve(&at, end, bn__sizeof_gcd(x.num.magnitude, x.den));
+  bn_* work = bn__carve(&at, end, bn__sizeof_gcd_scratch(x.num.magnitude, x.den));
+  if (g == NULL || work == NULL) { return BL_OVERFLOW; }
+  bl_result err = bn__gcd(g, x.num.magnitude, x.den, work);
+  if (err != BL_OK) { return err; }
+  // the gcd of anything with one is one, which leaves nothing to do
+  if (bn__nbits(g) <= 1) { return BL_OK; }
+  bn__divexact(x.num.magnitude, x.num.magnitude, g);
+  bn__divexact(x.den, x.den, g);
+  return BL_OK;
+}
+
+////// Queries //////
+
+size_t bq__sizeof_cmp_scratch(bq_ a, bq_ b) {
+  return bn__sizeof_carve(a.num.magnitude->len + b.den->len)
+       + bn__sizeof_carve(b.num.magnitude->len + a.den->len);
+}
+
+bl_result bq__cmp(bl_ord* dst, bq_ a, bq_ b, bn_* scratch) {
+  bool aZero = bn__nbits(a.num.magnitude) == 0;
+  bool bZero = bn__nbits(b.num.magnitude) == 0;
+  int aSign = aZero ? 0 : a.num.isNeg ? -1 : 1;
+  int bSign = bZero ? 0 : b.num.isNeg ? -1 : 1;
+  if (aSign != bSign || aSign == 0) {
+    *dst = aSign < bSign ? BL_LT : aSign > bSign ? BL_GT : BL_EQ;
+    return BL_OK;
+  }
+  // the denominators are positive, so compare a.num × b.den against b.num × a.den
+  if (scratch == NULL) { return BL_OVERFLOW; }
+  uint8_t* at = &scratch->base256le[0];
+  uint8_t* end = at + scratch->len;
+  bn_* x = bn__carve(&at, end, a.num.magnitude->len + b.den->len);
+  bn_* y = bn__carve(&at, end, b.num.magnitude->len + a.den->len);
+  if (x == NULL || y == NULL) { return BL_OVERFLOW; }
+  bn__blank(x);
+  bn__blank(y);
+  bl_result err = bn__mul(x, a.num.magnitude, b.den);
+  if (err != BL_OK) { return err; }
+  err = bn__mul(y, b.num.magnitude, a.den);
+  if (err != BL_OK) { return err; }
+  bl_ord ord = bn__cmp(x, y);
+  *dst = aSign < 0 ? (bl_ord)-ord : ord;
+  return BL_OK;
+}
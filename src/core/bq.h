@@ -0,0 +1,34 @@
+#ifndef BIGLIT_CORE_BQ
+#define BIGLIT_CORE_BQ
+
+// This is the core interface for rationals ℚ.
+// A `bq_` stands for `num / den`, where the denominator is non-zero, but the fraction need not be in lowest terms:
+// reducing is the most expensive part of rational arithmetic, so it is left to the layer above to decide when it is worth doing.
+// As with the rest of the core, these functions do not allocate;
+// work space is passed in by the caller, whose size can be queried beforehand.
+
+#include "core/bq_type.h"
+
+////// Reduction //////
+
+// Return the number of base256 digits of scratch space needed to reduce `src`.
+size_t bq__sizeof_reduce_scratch(bq_ src);
+
+// Divide the numerator and denominator of `x` by their greatest common divisor, in place.
+// Zero becomes `0/1`.
+// Inputs need not be normalized, and the outputs are not normalized.
+// `BL_OVERFLOW` is returned if the scratch is too small, in which case `x` is unchanged.
+bl_result bq__reduce(bq_ x, bn_* scratch);
+
+////// Queries //////
+
+// Return the number of base256 digits of scratch space needed to compare `a` and `b`.
+size_t bq__sizeof_cmp_scratch(bq_ a, bq_ b);
+
+// Place the ordering of `a` and `b` in `dst`.
+// Neither input need be reduced or normalized.
+// `BL_OVERFLOW` is returned if the scratch is too small.
+bl_result bq__cmp(bl_ord* dst, bq_ a, bq_ b, bn_* scratch);
+
+
+#endif
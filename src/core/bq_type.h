@@ -0,0 +1,13 @@
+#ifndef BIGLIT_CORE_BQ_TYPE
+#define BIGLIT_CORE_BQ_TYPE
+
+#include "core/bz_type.h"
+
+
+typedef struct bq_ {
+  bz_ num;
+  bn_* den;
+} bq_;
+
+
+#endif
@@ -0,0 +1,467 @@
+#include "core/br.h"
+#include "core/limb.h"
+#include "core/pow5.h"
+
+#include <string.h>
+
+static inline size_t min(size_t a, size_t b) {
+  return a < b ? a : b;
+}
+
+static inline size_t max(size_t a, size_t b) {
+  return a > b ? a : b;
+}
+
+// Describes an IEEE binary interchange format, in the terms used by Eisel–Lemire.
+typedef struct format {
+  unsigned explicitBits; // bits of significand stored (i.e. not counting the hidden bit)
+  int minExponent; // the negated exponent bias
+  int infinitePower; // the biased exponent of infinity
+  int minRoundToEven; // powers of ten in this range can produce exact ties
+  int maxRoundToEven;
+  int minDecimal; // w × 10^q is surely zero when its (decimal) exponent is below this
+  int maxDecimal; // w × 10^q is surely infinite when its (decimal) exponent is above this
+} format;
+
+static const format binary64 = { 52, -1023, 0x7FF, -4, 23, -325, 309 };
+static const format binary32 = { 23, -127, 0xFF, -17, 10, -47, 39 };
+
+// A significand with explicit bits only, and a biased exponent; i.e. the fields of the IEEE encoding.
+typedef struct adjusted {
+  uint64_t mantissa;
+  int64_t power2;
+} adjusted;
+
+static uint64_t encode(const format* f, adjusted a) {
+  return a.mantissa | (uint64_t)a.power2 << f->explicitBits;
+}
+
+static adjusted infinity(const format* f) {
+  adjusted out = { 0, f->infinitePower };
+  return out;
+}
+
+static adjusted zero(void) {
+  adjusted out = { 0, 0 };
+  return out;
+}
+
+////// Eisel–Lemire //////
+
+// Return floor(log2(10^q)) + 63, valid for |q| ≤ 342 or so.
+static int64_t power(int64_t q) {
+  return (((152170 + 65536) * q) >> 16) + 63;
+}
+
+// Round `w × 2^s × 10^q` where `w ≠ 0` and `q` is within the table.
+// The result is exact when `s = 0`; otherwise, ties are resolved as if `w × 2^s` were exact.
+static adjusted eiselLemire(const format* f, int64_t q, uint64_t w, size_t s) {
+  const uint64_t* pow5 = br__pow5[q - BR__POW5_MIN];
+  unsigned lz = 64 - bn__bitlen64(w);
+  w = w << lz;
+  // approximate the top 128 bits of w × 5^q, only looking at the low half of 5^q when it could matter
+  uint64_t precisionMask = UINT64_MAX >> (f->explicitBits + 3);
+  uint64_t lo, hi;
+  lo = bn__mul64(w, pow5[0], &hi);
+  if ((hi & precisionMask) == precisionMask) {
+    uint64_t hi2;
+    bn__mul64(w, pow5[1], &hi2);
+    lo += hi2;
+    if (hi2 > lo) { hi += 1; }
+  }
+  unsigned upperbit = hi >> 63;
+  unsigned shift = upperbit + 64 - f->explicitBits - 3;
+  adjusted out;
+  out.mantissa = hi >> shift;
+  out.power2 = power(q) + upperbit - lz + (int64_t)s - f->minExponent;
+  if (out.power2 <= 0) {
+    // subnormal: no ties are possible here
+    if (-out.power2 + 1 >= 64) { return zero(); }
+    out.mantissa = out.mantissa >> (-out.power2 + 1);
+    out.mantissa += out.mantissa & 1;
+    out.mantissa = out.mantissa >> 1;
+    out.power2 = out.mantissa < (UINT64_C(1) << f->explicitBits) ? 0 : 1;
+    return out;
+  }
+  // an exact tie must round to even, rather than up
+  if (lo <= 1 && f->minRoundToEven <= q && q <= f->maxRoundToEven && (out.mantissa & 3) == 1) {
+    if ((out.mantissa << shift) == hi) {
+      out.mantissa &= ~(uint64_t)1;
+    }
+  }
+  out.mantissa += out.mantissa & 1;
+  out.mantissa = out.mantissa >> 1;
+  if (out.mantissa >= (UINT64_C(2) << f->explicitBits)) {
+    out.mantissa = UINT64_C(1) << f->explicitBits;
+    out.power2 += 1;
+  }
+  out.mantissa &= ~(UINT64_C(1) << f->explicitBits);
+  if (out.power2 >= f->infinitePower) { return infinity(f); }
+  return out;
+}
+
+////// Exact Rounding //////
+
+// Return the top `n ≤ 64` of the `nbits` significant bits of `src`, and report whether any lower bits are set.
+static uint64_t topBits(const bn_* src, size_t nbits, unsigned n, bool* sticky) {
+  if (nbits <= n) {
+    *sticky = false;
+    return bn__loadN(&src->base256le[0], min(8, src->len));
+  }
+  size_t start = nbits - n;
+  size_t byte = start / 8;
+  unsigned bit = start % 8;
+  uint64_t lo = bn__loadN(&src->base256le[byte], min(8, src->len - byte));
+  uint64_t hi = byte + 8 < src->len ? src->base256le[byte + 8] : 0;
+  uint64_t out = bit == 0 ? lo : (lo >> bit) | (hi << (64 - bit));
+  if (n < 64) { out &= (UINT64_C(1) << n) - 1; }
+  *sticky = (lo & ((UINT64_C(1) << bit) - 1)) != 0;
+  for (size_t i = byte; !*sticky && i > 0; --i) {
+    *sticky = src->base256le[i - 1] != 0;
+  }
+  return out;
+}
+
+// Round `(m + δ) × 2^e` where `m` has its top bit set, and `0 ≤ δ < 1` is non-zero exactly when `sticky`.
+static adjusted roundExact(const format* f, uint64_t m, int64_t e, bool sticky) {
+  unsigned p = f->explicitBits + 1;
+  int64_t biased = e + 63 - f->minExponent;
+  if (biased >= f->infinitePower) { return infinity(f); }
+  int64_t shift = 64 - p + (biased >= 1 ? 0 : 1 - biased);
+  if (shift > 64) { return zero(); }
+  uint64_t kept, rem, half;
+  if (shift == 64) {
+    kept = 0; rem = m; half = UINT64_C(1) << 63;
+  }
+  else {
+    kept = m >> shift;
+    rem = m & ((UINT64_C(1) << shift) - 1);
+    half = UINT64_C(1) << (shift - 1);
+  }
+  if (rem > half || (rem == half && (sticky || (kept & 1)))) { kept += 1; }
+  // a carry out of the significand bumps the exponent, including from subnormal to normal
+  uint64_t bits = biased >= 1 ? ((uint64_t)(biased - 1) << f->explicitBits) + kept : kept;
+  adjusted out = { bits & ((UINT64_C(1) << f->explicitBits) - 1), bits >> f->explicitBits };
+  if (out.power2 >= f->infinitePower) { return infinity(f); }
+  return out;
+}
+
+////// Scratch Space //////
+
+// ceil(log2(5) * 2^16)
+#define LOG2_5 152170
+
+static size_t sizeofPow5(uintmax_t a) {
+  return (a * LOG2_5 + 0xFFFF) / 0x10000 / 8 + 1;
+}
+
+// Set `dst` to 5^a and normalize it.
+static bl_result pow5(bn_* dst, uintmax_t a) {
+  size_t used = 1;
+  dst->base256le[0] = 1;
+  while (a != 0) {
+    unsigned step = a < 27 ? a : 27; // 5^27 is the largest power of five in a word
+    uint64_t k = 1;
+    for (unsigned i = 0; i < step; ++i) { k *= 5; }
+    bl_result err = bn__muladd1(dst, &used, k, 0);
+    if (err != BL_OK) { return err; }
+    a -= step;
+  }
+  dst->len = used;
+  return BL_OK;
+}
+
+////// Conversion //////
+
+typedef enum { DECIDED, TABLE, EXACT } strategy;
+
+// Work out how the conversion will proceed, deciding the result outright if it is zero or infinite.
+static strategy plan(const format* f, size_t nbits, intmax_t q, adjusted* out) {
+  if (nbits == 0) { *out = zero(); return DECIDED; }
+  // bound log10(w) with floor/ceil of (nbits - 1)·log10(2) and nbits·log10(2)
+  assert(nbits <= SIZE_MAX / 30103);
+  intmax_t loDigits = (nbits - 1) * 30103 / 100000;
+  intmax_t hiDigits = (nbits * 30103 + 99999) / 100000;
+  if (q < f->minDecimal - hiDigits) { *out = zero(); return DECIDED; }
+  if (q > f->maxDecimal - loDigits) { *out = infinity(f); return DECIDED; }
+  if (BR__POW5_MIN <= q && q <= BR__POW5_MAX) { return TABLE; }
+  return EXACT;
+}
+
+static size_t sizeofScratch(const format* f, const bn_* w, intmax_t q) {
+  adjusted ignore;
+  if (plan(f, bn__nbits(w), q, &ignore) == DECIDED) { return 0; }
+  uintmax_t a = q < 0 ? -(uintmax_t)q : (uintmax_t)q;
+  size_t pow5Len = sizeofPow5(a);
+  if (q >= 0) {
+    return bn__sizeof_carve(pow5Len) + bn__sizeof_carve(w->len + pow5Len);
+  }
+  else {
+    // the numerator is shifted by at most 65 bits more than the power of five
+    size_t numLen = w->len + pow5Len + 10;
+    return bn__sizeof_carve(pow5Len) + 2 * bn__sizeof_carve(numLen) + bn__sizeof_carve(pow5Len);
+  }
+}
+
+size_t br__sizeof_decimal_scratch(const bn_* w, intmax_t q) {
+  return max(sizeofScratch(&binary64, w, q), sizeofScratch(&binary32, w, q));
+}
+
+static bl_result exact(adjusted* out, const format* f, const bn_* w, intmax_t q, bn_* scratch) {
+  if (scratch == NULL) { return BL_OVERFLOW; }
+  uint8_t* at = &scratch->base256le[0];
+  uint8_t* end = at + scratch->len;
+  uintmax_t a = q < 0 ? -(uintmax_t)q : (uintmax_t)q;
+  bn_* d = bn__carve(&at, end, sizeofPow5(a));
+  if (d == NULL || pow5(d, a) != BL_OK) { return BL_OVERFLOW; }
+  const bn_* x; // an integer whose top bits are those of w × 10^q
+  int64_t e; // w × 10^q ≈ x × 2^e
+  bool sticky = false;
+  if (q >= 0) {
+    bn_* prod = bn__carve(&at, end, w->len + d->len);
+    if (prod == NULL) { return BL_OVERFLOW; }
+    bn__blank(prod);
+    bl_result err = bn__mul(prod, w, d);
+    if (err != BL_OK) { return err; }
+    x = prod;
+    e = q;
+  }
+  else {
+    // w × 10^q = (w × 2^k / 5^-q) × 2^(q - k), where k is chosen so the quotient has at least 65 bits
+    size_t wBits = bn__nbits(w);
+    size_t k = 65 + bn__nbits(d);
+    k = k > wBits ? k - wBits : 0;
+    bn_* num = bn__carve(&at, end, w->len + k / 8 + 1);
+    if (num == NULL) { return BL_OVERFLOW; }
+    bl_result err = bn__copy(num, w);
+    if (err != BL_OK) { return err; }
+    bn__shl(num, k);
+    bn_* quo = bn__carve(&at, end, num->len);
+    bn_* rem = bn__carve(&at, end, d->len);
+    if (quo == NULL || rem == NULL) { return BL_OVERFLOW; }
+    bn__blank(quo);
+    bn__blank(rem);
+    err = bn__divmod(quo, rem, num, d);
+    if (err != BL_OK) { return err; }
+    sticky = bn__nbits(rem) != 0;
+    x = quo;
+    e = q - (int64_t)k;
+  }
+  size_t nbits = bn__nbits(x);
+  bool lower;
+  uint64_t m = topBits(x, nbits, 64, &lower);
+  m = m << (nbits < 64 ? 64 - nbits : 0);
+  e += nbits > 64 ? (int64_t)(nbits - 64) : -(int64_t)(64 - nbits);
+  *out = roundExact(f, m, e, sticky || lower);
+  return BL_OK;
+}
+
+static bl_result decimal(uint64_t* dst, const format* f, const bn_* w, intmax_t q, bn_* scratch) {
+  size_t nbits = bn__nbits(w);
+  adjusted out;
+  switch (plan(f, nbits, q, &out)) {
+    case DECIDED: {
+      *dst = encode(f, out);
+      return BL_OK;
+    }
+    case TABLE: {
+      bool sticky;
+      // leave room so that adding one to a truncated significand cannot overflow
+      unsigned n = nbits <= 64 ? 64 : 63;
+      uint64_t top = topBits(w, nbits, n, &sticky);
+      size_t s = nbits > n ? nbits - n : 0;
+      out = eiselLemire(f, q, top, s);
+      if (!sticky) {
+        *dst = encode(f, out);
+        return BL_OK;
+      }
+      adjusted up = eiselLemire(f, q, top + 1, s);
+      if (out.mantissa == up.mantissa && out.power2 == up.power2) {
+        *dst = encode(f, out);
+        return BL_OK;
+      }
+    } // fallthrough
+    case EXACT: {
+      bl_result err = exact(&out, f, w, q, scratch);
+      if (err != BL_OK) { return err; }
+      *dst = encode(f, out);
+      return BL_OK;
+    }
+  }
+  assert(false && "unreachable");
+  return BL_OK;
+}
+
+bl_result br__decimal_binary64(uint64_t* dst, const bn_* w, intmax_t q, bn_* scratch) {
+  return decimal(dst, &binary64, w, q, scratch);
+}
+
+bl_result br__decimal_binary32(uint32_t* dst, const bn_* w, intmax_t q, bn_* scratch) {
+  uint64_t bits;
+  bl_result err = decimal(&bits, &binary32, w, q, scratch);
+  *dst = bits;
+  return err;
+}
+
+////// Rounding //////
+
+// The parameters of an IEEE binary interchange format.
+typedef struct ieee {
+  unsigned width; // bytes in the encoding
+  unsigned precision; // significand bits, including the hidden bit
+  intmax_t emax; // also the exponent bias
+} ieee;
+
+static const ieee formats[] = {
+  [BR_BINARY16] = { 2, 11, 15 },
+  [BR_BINARY32] = { 4, 24, 127 },
+  [BR_BINARY64] = { 8, 53, 1023 },
+  [BR_BINARY128] = { 16, 113, 16383 },
+};
+
+size_t br__sizeof_format(br_format_ fmt) {
+  return formats[fmt].width;
+}
+
+unsigned br__precision(br_format_ fmt) {
+  return formats[fmt].precision;
+}
+
+// Significands of binary128 take more than one word.
+typedef struct u128 {
+  uint64_t hi, lo;
+} u128;
+
+static bool u128_bit(u128 a, unsigned i) {
+  return i < 64 ? (a.lo >> i) & 1 : (a.hi >> (i - 64)) & 1;
+}
+
+static u128 u128_setbit(u128 a, unsigned i) {
+  if (i < 64) { a.lo |= UINT64_C(1) << i; }
+  else { a.hi |= UINT64_C(1) << (i - 64); }
+  return a;
+}
+
+static u128 u128_clearbit(u128 a, unsigned i) {
+  if (i < 64) { a.lo &= ~(UINT64_C(1) << i); }
+  else { a.hi &= ~(UINT64_C(1) << (i - 64)); }
+  return a;
+}
+
+// Return bit `i` of `src`, where bits outside the digits (including at negative indices) are zero.
+static bool bitAt(const bn_* src, intmax_t i) {
+  if (i < 0 || (uintmax_t)i / 8 >= src->len) { return false; }
+  return (src->base256le[i / 8] >> (i % 8)) & 1;
+}
+
+// Return whether any of the bits of `src` below bit `i` are set.
+static bool anyBelow(const bn_* src, intmax_t i) {
+  if (i <= 0) { return false; }
+  size_t nBytes = min((uintmax_t)i / 8, src->len);
+  for (size_t j = 0; j < nBytes; ++j) {
+    if (src->base256le[j] != 0) { return true; }
+  }
+  if (nBytes == src->len || i % 8 == 0) { return false; }
+  return (src->base256le[nBytes] & ((1u << (i % 8)) - 1)) != 0;
+}
+
+static void emit(uint8_t* dst, const ieee* f, u128 bits) {
+  for (unsigned i = 0; i < f->width; ++i) {
+    dst[i] = (i < 8 ? bits.lo >> (8 * i) : bits.hi >> (8 * (i - 8))) & 0xFF;
+  }
+}
+
+// Encode from the sign, biased exponent and significand (whose hidden bit is ignored).
+static void pack(uint8_t* dst, const ieee* f, bool isNeg, intmax_t biased, u128 mant) {
+  unsigned p = f->precision;
+  u128 bits = u128_clearbit(mant, p - 1);
+  for (unsigned i = 0; biased >> i != 0; ++i) {
+    if ((biased >> i) & 1) { bits = u128_setbit(bits, p - 1 + i); }
+  }
+  if (isNeg) { bits = u128_setbit(bits, 8 * f->width - 1); }
+  emit(dst, f, bits);
+}
+
+// Whether rounding `mode` moves numbers with the given sign away from zero when they are not representable.
+static bool awayFromZero(br_rounding_ mode, bool isNeg) {
+  return (mode == BR_TOWARD_POSITIVE && !isNeg) || (mode == BR_TOWARD_NEGATIVE && isNeg);
+}
+
+void br__nonfinite(uint8_t* dst, br_format_ fmt, bool isNeg, bool isNan) {
+  const ieee* f = &formats[fmt];
+  u128 mant = { 0, 0 };
+  if (isNan) { mant = u128_setbit(mant, f->precision - 2); }
+  pack(dst, f, isNeg, 2 * f->emax + 1, mant);
+}
+
+// Round a number too large for the format: either to infinity, or to the largest finite number.
+static void overflow(uint8_t* dst, br_format_ fmt, br_rounding_ mode, bool isNeg) {
+  const ieee* f = &formats[fmt];
+  if (mode == BR_NEAREST_EVEN || mode == BR_NEAREST_AWAY || awayFromZero(mode, isNeg)) {
+    br__nonfinite(dst, fmt, isNeg, false);
+    return;
+  }
+  u128 mant = { 0, 0 };
+  for (unsigned i = 0; i < f->precision; ++i) { mant = u128_setbit(mant, i); }
+  pack(dst, f, isNeg, 2 * f->emax, mant);
+}
+
+void br__round(uint8_t* dst, br_format_ fmt, br_rounding_ mode, bool isNeg, const bn_* sig, intmax_t exp, bool sticky) {
+  const ieee* f = &formats[fmt];
+  intmax_t p = f->precision;
+  intmax_t emin = 1 - f->emax;
+  u128 mant = { 0, 0 };
+  size_t nbits = bn__nbits(sig);
+  if (nbits == 0 && !sticky) {
+    pack(dst, f, isNeg, 0, mant);
+    return;
+  }
+  assert(nbits - 1 <= INTMAX_MAX / 2);
+  // the value lies in [2^top, 2^(top+1)), but only compute `top` when that cannot overflow
+  bool huge = exp > f->emax;
+  bool tiny = exp < -(INTMAX_MAX / 2);
+  intmax_t top = huge || tiny ? 0 : exp + (intmax_t)(nbits - 1);
+  if (huge || top > f->emax) {
+    overflow(dst, fmt, mode, isNeg);
+    return;
+  }
+  if (tiny || top < emin - p - 1) {
+    // below half the smallest subnormal, so there are no ties
+    if (awayFromZero(mode, isNeg)) { mant.lo = 1; }
+    pack(dst, f, isNeg, 0, mant);
+    return;
+  }
+  // `lsb` is the exponent of the last place of the result, and `cut` the index of the corresponding bit of `sig`
+  intmax_t lsb = top - (p - 1) > emin - (p - 1) ? top - (p - 1) : emin - (p - 1);
+  intmax_t cut = lsb - exp;
+  assert(!sticky || cut >= 1);
+  for (intmax_t i = 0; i < p; ++i) {
+    if (bitAt(sig, cut + i)) { mant = u128_setbit(mant, i); }
+  }
+  bool half = bitAt(sig, cut - 1);
+  bool rest = sticky || anyBelow(sig, cut - 1);
+  bool up = false;
+  switch (mode) {
+    case BR_NEAREST_EVEN: up = half && (rest || u128_bit(mant, 0)); break;
+    case BR_NEAREST_AWAY: up = half; break;
+    case BR_TOWARD_ZERO: up = false; break;
+    case BR_TOWARD_POSITIVE:
+    case BR_TOWARD_NEGATIVE: up = (half || rest) && awayFromZero(mode, isNeg); break;
+  }
+  if (up) {
+    mant.lo += 1;
+    mant.hi += mant.lo == 0;
+    if (u128_bit(mant, p)) {
+      mant = u128_clearbit(mant, p);
+      mant = u128_setbit(mant, p - 1);
+      lsb += 1;
+      if (lsb + (p - 1) > f->emax) {
+        overflow(dst, fmt, mode, isNeg);
+        return;
+      }
+    }
+  }
+  // a significand without its top bit set can only be subnormal (or zero)
+  intmax_t biased = u128_bit(mant, p - 1) ? lsb + (p - 1) + f->emax : 0;
+  pack(dst, f, isNeg, biased, mant);
+}
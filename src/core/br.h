@@ -0,0 +1,73 @@
+#ifndef BIGLIT_CORE_BR
+#define BIGLIT_CORE_BR
+
+// This is the core interface for floating-point reals ℝ.
+// As with the rest of the core, its functions do not allocate;
+// work space that may be needed is passed in by the caller, whose size can be queried beforehand.
+
+#include "core/bn.h"
+
+////// Decimal Conversion //////
+
+// These functions round a decimal number `w × 10^q` to the nearest IEEE binary64 or binary32, ties to even.
+// This is how float literals are read: the digits of the literal (ignoring the decimal point) form `w`,
+// and the exponent of the literal, less the number of digits after the point, is `q`.
+// Results are given as the bits of their IEEE encoding, so they do not depend on the host's floating point.
+// Numbers too large for the format become infinity, and those too small become zero.
+//
+// When `w` fits in 64 bits, the result is computed with the Eisel–Lemire algorithm
+// from a 128-bit approximation of `5^q`, which is always exact.
+// Longer significands are truncated to their top 63 bits, and the result is known whenever
+// the truncation and its successor round the same way, which is nearly always.
+// Otherwise (or if `q` is outside ±342, but the result is neither zero nor infinite),
+// the result is decided by exact arithmetic on natural numbers, which needs scratch space.
+
+// Return the number of base256 digits of scratch space that converting `w × 10^q` may need.
+// This is zero if the result can be decided without exact arithmetic.
+size_t br__sizeof_decimal_scratch(const bn_* w, intmax_t q);
+
+// Place the bits of the binary64 nearest to `w × 10^q` in `dst`.
+// The input need not be normalized.
+// The scratch may be `NULL`; if it is, or if it has less than `br__sizeof_decimal_scratch(w, q)` digits,
+// `BL_OVERFLOW` may be returned, in which case the contents of `dst` are undefined.
+bl_result br__decimal_binary64(uint64_t* dst, const bn_* w, intmax_t q, bn_* scratch);
+
+// As `br__decimal_binary64`, but for binary32.
+bl_result br__decimal_binary32(uint32_t* dst, const bn_* w, intmax_t q, bn_* scratch);
+
+////// Rounding //////
+
+// The IEEE binary interchange formats.
+typedef enum {
+  BR_BINARY16,
+  BR_BINARY32,
+  BR_BINARY64,
+  BR_BINARY128
+} br_format_;
+
+// The IEEE rounding-direction attributes.
+typedef enum {
+  BR_NEAREST_EVEN,
+  BR_NEAREST_AWAY,
+  BR_TOWARD_ZERO,
+  BR_TOWARD_POSITIVE,
+  BR_TOWARD_NEGATIVE
+} br_rounding_;
+
+// Return the number of bytes in the encoding of `fmt`.
+size_t br__sizeof_format(br_format_ fmt);
+
+// Return the number of significand bits (including the hidden bit) of `fmt`.
+unsigned br__precision(br_format_ fmt);
+
+// Write the IEEE encoding of `±sig × 2^exp` rounded to `fmt` into `dst`, least-significant byte first.
+// When `sticky` is set, the value is instead taken to lie strictly between `sig × 2^exp` and `(sig + 1) × 2^exp`,
+// as for a quotient with a non-zero remainder; `sig` must then have more bits than `br__precision(fmt)`.
+// This takes time linear in the length of `sig`, and does not require input normalization.
+void br__round(uint8_t* dst, br_format_ fmt, br_rounding_ mode, bool isNeg, const bn_* sig, intmax_t exp, bool sticky);
+
+// Write the IEEE encoding of an infinity, or of a quiet NaN, into `dst`, least-significant byte first.
+void br__nonfinite(uint8_t* dst, br_format_ fmt, bool isNeg, bool isNan);
+
+
+#endif
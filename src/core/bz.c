@@ -1,8 +1,356 @@
 #include "core/bz.h"
+#include "core/limb.h"
+#include "stats.h"
+
+#include <string.h>
 
 void bz__normalize(bz_ dst) {
+  BL_STAT(dst.magnitude->len);
   bn__normalize(dst.magnitude);
   if (dst.magnitude->len == 0) {
     dst.isNeg = false;
   }
 }
+
+////// Two's Complement //////
+
+// Bitwise operations and fixed-width encodings see a number through its infinite two's-complement representation.
+// Negative magnitudes are negated a word at a time as they are read (and results as they are written),
+// carrying the `+1` of the negation along, so no complement is ever materialized.
+
+// Return the `i`th 64-bit word of `src`, with digits past the end read as zero.
+static uint64_t wordAt(const bn_* src, size_t i) {
+  size_t at = 8 * i;
+  if (at >= src->len) { return 0; }
+  if (src->len - at >= 8) { return bn__load64(&src->base256le[at]); }
+  return bn__loadN(&src->base256le[at], src->len - at);
+}
+
+// Write the `i`th 64-bit word of `dst`, failing if any non-zero digits fall past the end.
+static bl_result setWordAt(bn_* dst, size_t i, uint64_t w) {
+  size_t at = 8 * i;
+  size_t room = at >= dst->len ? 0 : dst->len - at < 8 ? dst->len - at : 8;
+  if (room < 8 && (w >> (8 * room)) != 0) { return BL_OVERFLOW; }
+  if (room == 8) { bn__store64(&dst->base256le[at], w); }
+  else if (room != 0) { bn__storeN(&dst->base256le[at], w, room); }
+  return BL_OK;
+}
+
+// Return whether the first `nWords` words of `src` are all zero.
+static bool zeroBelow(const bn_* src, size_t nWords) {
+  for (size_t i = 0; i < nWords; ++i) {
+    if (wordAt(src, i) != 0) { return false; }
+  }
+  return true;
+}
+
+// Return whether `src` is strictly negative; a negative zero is not.
+static bool isNegative(bz_ src) {
+  return src.isNeg && !zeroBelow(src.magnitude, (src.magnitude->len + 7) / 8);
+}
+
+// The words of a number's two's-complement representation, read in increasing order.
+typedef struct twos {
+  const bn_* m;
+  bool isNeg;
+  uint64_t carry;
+} twos;
+
+static twos twosOf(bz_ src) {
+  twos out = { .m = src.magnitude, .isNeg = src.isNeg, .carry = src.isNeg };
+  return out;
+}
+
+// Return the `i`th word; this must be called for consecutive `i`.
+static uint64_t twosNext(twos* s, size_t i) {
+  uint64_t w = wordAt(s->m, i);
+  if (!s->isNeg) { return w; }
+  w = ~w + s->carry;
+  s->carry = s->carry && w == 0;
+  return w;
+}
+
+// Write the `i`th word of a two's-complement result into the magnitude of `dst`.
+// This must be called for each `i` in turn, starting with `*carry` equal to `dst->isNeg`.
+static bl_result untwosNext(bz_* dst, uint64_t* carry, size_t i, uint64_t w) {
+  if (dst->isNeg) {
+    w = ~w + *carry;
+    *carry = *carry && w == 0;
+  }
+  return setWordAt(dst->magnitude, i, w);
+}
+
+// Zero the digits of `dst` from word `i` onward.
+static void blankFrom(bn_* dst, size_t i) {
+  if (8 * i < dst->len) { memset(&dst->base256le[8 * i], 0, dst->len - 8 * i); }
+}
+
+size_t bz__twos_bits(bz_ src) {
+  BL_STAT(src.magnitude->len);
+  const bn_* m = src.magnitude;
+  size_t len = m->len;
+  while (len != 0 && m->base256le[len - 1] == 0) { --len; }
+  if (len == 0) { return 0; }
+  // a non-negative number needs room for its bits and a clear sign bit
+  // a negative one needs room for the bits of `|src| - 1` and a set sign bit,
+  //   which is one fewer than `|src|` exactly when `|src|` is a power of two
+  size_t nbits = 8 * (len - 1) + bn__bitlen64(m->base256le[len - 1]);
+  if (src.isNeg) {
+    bool pow2 = (m->base256le[len - 1] & (m->base256le[len - 1] - 1)) == 0;
+    for (size_t i = 0; pow2 && i < len - 1; ++i) {
+      pow2 = m->base256le[i] == 0;
+    }
+    if (pow2) { nbits -= 1; }
+  }
+  return nbits + 1;
+}
+
+bool bz__bit(bz_ src, size_t i) {
+  BL_STAT(src.magnitude->len);
+  const bn_* m = src.magnitude;
+  bool bit = i / 8 < m->len && (m->base256le[i / 8] >> (i % 8)) & 1;
+  if (!src.isNeg) { return bit; }
+  // bit `i` of `~m + 1` is flipped by the carry exactly when every bit of `m` below it is clear
+  bool carry = true;
+  for (size_t j = 0; carry && j < i / 8 && j < m->len; ++j) {
+    carry = m->base256le[j] == 0;
+  }
+  if (carry && i / 8 < m->len) {
+    carry = (m->base256le[i / 8] & ((1u << (i % 8)) - 1)) == 0;
+  }
+  return !bit != carry;
+}
+
+typedef enum { AND, OR, XOR } bitop;
+
+static uint64_t applyOp(bitop op, uint64_t x, uint64_t y) {
+  switch (op) {
+    case AND: return x & y;
+    case OR: return x | y;
+    case XOR: return x ^ y;
+  }
+  return 0;
+}
+
+static bl_result bitwise(bz_* dst, bz_ a, bz_ b, bitop op) {
+  bool aNeg = isNegative(a), bNeg = isNegative(b);
+  dst->isNeg = applyOp(op, aNeg, bNeg);
+  twos x = twosOf(a), y = twosOf(b);
+  uint64_t carry = dst->isNeg;
+  // one word past the longer input is all copies of the sign bit
+  size_t nWords = (a.magnitude->len > b.magnitude->len ? a.magnitude->len : b.magnitude->len) / 8 + 1;
+  for (size_t i = 0; i < nWords; ++i) {
+    uint64_t w = applyOp(op, twosNext(&x, i), twosNext(&y, i));
+    if (untwosNext(dst, &carry, i, w) != BL_OK) { return BL_OVERFLOW; }
+  }
+  blankFrom(dst->magnitude, nWords);
+  return BL_OK;
+}
+
+size_t bz__sizeof_bitwise(bz_ a, bz_ b) {
+  BL_STAT(a.magnitude->len + b.magnitude->len);
+  return (a.magnitude->len > b.magnitude->len ? a.magnitude->len : b.magnitude->len) + 1;
+}
+
+bl_result bz__and(bz_* dst, bz_ a, bz_ b) {
+  BL_STAT(a.magnitude->len + b.magnitude->len);
+  return bitwise(dst, a, b, AND);
+}
+
+bl_result bz__or(bz_* dst, bz_ a, bz_ b) {
+  BL_STAT(a.magnitude->len + b.magnitude->len);
+  return bitwise(dst, a, b, OR);
+}
+
+bl_result bz__xor(bz_* dst, bz_ a, bz_ b) {
+  BL_STAT(a.magnitude->len + b.magnitude->len);
+  return bitwise(dst, a, b, XOR);
+}
+
+size_t bz__sizeof_not(bz_ a) {
+  BL_STAT(a.magnitude->len);
+  return a.magnitude->len + 1;
+}
+
+bl_result bz__not(bz_* dst, bz_ a) {
+  BL_STAT(a.magnitude->len);
+  dst->isNeg = !isNegative(a);
+  twos x = twosOf(a);
+  uint64_t carry = dst->isNeg;
+  size_t nWords = a.magnitude->len / 8 + 1;
+  for (size_t i = 0; i < nWords; ++i) {
+    if (untwosNext(dst, &carry, i, ~twosNext(&x, i)) != BL_OK) { return BL_OVERFLOW; }
+  }
+  blankFrom(dst->magnitude, nWords);
+  return BL_OK;
+}
+
+size_t bz__sizeof_shr(bz_ a, size_t amt) {
+  BL_STAT(a.magnitude->len);
+  size_t len = a.magnitude->len;
+  return (amt / 8 < len ? len - amt / 8 : 0) + 1;
+}
+
+bl_result bz__shr(bz_* dst, bz_ a, size_t amt) {
+  BL_STAT(a.magnitude->len);
+  size_t len = a.magnitude->len;
+  size_t skip = amt / 64;
+  unsigned sh = amt % 64;
+  dst->isNeg = isNegative(a);
+  twos x = twosOf(a);
+  // the negation's carry into the first word kept is set only if every word shifted out is zero
+  x.carry = x.carry && zeroBelow(a.magnitude, skip);
+  uint64_t carry = dst->isNeg;
+  // words up to and including the first that is all copies of the sign bit
+  size_t nWords = (8 * len > amt ? (8 * len - amt) / 64 : 0) + 1;
+  uint64_t lo = twosNext(&x, skip);
+  for (size_t i = 0; i < nWords; ++i) {
+    uint64_t hi = twosNext(&x, skip + i + 1);
+    uint64_t w = sh == 0 ? lo : (lo >> sh) | (hi << (64 - sh));
+    if (untwosNext(dst, &carry, i, w) != BL_OK) { return BL_OVERFLOW; }
+    lo = hi;
+  }
+  blankFrom(dst->magnitude, nWords);
+  return BL_OK;
+}
+
+size_t bz__sizeof_wrap(size_t nbits) {
+  BL_STAT(0);
+  return nbits / 8 + (nbits % 8 != 0);
+}
+
+bl_result bz__wrap(bn_* dst, bz_ src, size_t nbits) {
+  BL_STAT(src.magnitude->len);
+  size_t n = bz__sizeof_wrap(nbits);
+  if (dst->len < n) { return BL_OVERFLOW; }
+  twos x = twosOf(src);
+  size_t nWords = (n + 7) / 8;
+  for (size_t i = 0; i < nWords; ++i) {
+    uint64_t w = twosNext(&x, i);
+    // the last word may run past the end of `dst`; it is truncated just below anyway
+    size_t room = 8 * i + 8 <= dst->len ? 8 : dst->len - 8 * i;
+    if (room == 8) { bn__store64(&dst->base256le[8 * i], w); }
+    else { bn__storeN(&dst->base256le[8 * i], w, room); }
+  }
+  if (nbits % 8 != 0) { dst->base256le[n - 1] &= (1u << (nbits % 8)) - 1; }
+  memset(&dst->base256le[n], 0, dst->len - n);
+  return BL_OK;
+}
+
+bl_result bz__wrap_signed(bz_* dst, bz_ src, size_t nbits) {
+  BL_STAT(src.magnitude->len);
+  twos x = twosOf(src);
+  size_t nWords = (nbits + 63) / 64;
+  // the sign of the result is bit `nbits - 1` of `src`, which is read before the low words are negated
+  dst->isNeg = nbits != 0 && bz__bit(src, nbits - 1);
+  uint64_t carry = dst->isNeg;
+  for (size_t i = 0; i < nWords; ++i) {
+    uint64_t w = twosNext(&x, i);
+    // sign-extend the top word from bit `nbits - 1`
+    if (i == nWords - 1 && nbits % 64 != 0) {
+      uint64_t high = ~UINT64_C(0) << (nbits % 64);
+      w = dst->isNeg ? w | high : w & ~high;
+    }
+    if (untwosNext(dst, &carry, i, w) != BL_OK) { return BL_OVERFLOW; }
+  }
+  blankFrom(dst->magnitude, nWords);
+  return BL_OK;
+}
+
+bl_result bz__twos_encode(uint8_t* dst, size_t width, bz_ src) {
+  BL_STAT(src.magnitude->len);
+  twos x = twosOf(src);
+  size_t i = 0;
+  for (; 8 * i + 8 <= width; ++i) {
+    bn__store64(&dst[8 * i], twosNext(&x, i));
+  }
+  if (8 * i < width) {
+    bn__storeN(&dst[8 * i], twosNext(&x, i), width - 8 * i);
+  }
+  return bz__twos_bits(src) <= 8 * width ? BL_OK : BL_OVERFLOW;
+}
+
+bl_result bz__twos_decode(bz_* dst, const uint8_t* src, size_t width) {
+  BL_STAT(width);
+  dst->isNeg = width != 0 && (src[width - 1] & 0x80);
+  uint64_t carry = dst->isNeg;
+  size_t i = 0;
+  for (; 8 * i + 8 <= width; ++i) {
+    if (untwosNext(dst, &carry, i, bn__load64(&src[8 * i])) != BL_OK) { return BL_OVERFLOW; }
+  }
+  if (8 * i < width) {
+    size_t n = width - 8 * i;
+    uint64_t w = bn__loadN(&src[8 * i], n);
+    // sign-extend the final partial word before negating
+    if (dst->isNeg) { w |= ~UINT64_C(0) << (8 * n); }
+    if (untwosNext(dst, &carry, i++, w) != BL_OK) { return BL_OVERFLOW; }
+  }
+  blankFrom(dst->magnitude, i);
+  return BL_OK;
+}
+
+////// Serialization //////
+
+size_t bz__sizeof_sleb128(bz_ src) {
+  BL_STAT(src.magnitude->len);
+  // zero still takes a group
+  size_t nbits = bz__twos_bits(src);
+  if (nbits == 0) { return 1; }
+  return nbits / 7 + (nbits % 7 != 0);
+}
+
+bl_result bz__sleb128_encode(uint8_t* dst, size_t dstLen, bz_ src) {
+  BL_STAT(src.magnitude->len);
+  size_t nGroups = bz__sizeof_sleb128(src);
+  if (dstLen < nGroups) { return BL_OVERFLOW; }
+  uint64_t carry = src.isNeg ? 1 : 0;
+  for (size_t g = 0; g < nGroups; g += 8) {
+    uint64_t w = bn__load56(src.magnitude, g / 8 * 7);
+    if (src.isNeg) {
+      w = (~w & BN__MASK56) + carry;
+      carry = w >> 56;
+      w &= BN__MASK56;
+    }
+    for (size_t i = g; i < nGroups && i < g + 8; ++i) {
+      dst[i] = (w & 0x7F) | 0x80;
+      w = w >> 7;
+    }
+  }
+  dst[nGroups - 1] &= 0x7F;
+  return BL_OK;
+}
+
+size_t bz__sizeof_sleb128_decode(const uint8_t* src, size_t srcLen) {
+  BL_STAT(srcLen);
+  size_t nGroups = bn__groupsLen(src, srcLen);
+  // the magnitude of an n-bit two's complement number fits in n bits
+  return (7 * nGroups) / 8 + ((7 * nGroups) % 8 != 0);
+}
+
+bl_result bz__sleb128_decode(bz_* dst, size_t* nRead, const uint8_t* src, size_t srcLen) {
+  BL_STAT(srcLen);
+  size_t nGroups = bn__groupsLen(src, srcLen);
+  if (nGroups == 0) { return BL_SYNTAX; }
+  *nRead = nGroups;
+  bool isNeg = src[nGroups - 1] & 0x40;
+  bn_* m = dst->magnitude;
+  memset(&m->base256le[0], 0, m->len);
+  uint64_t carry = isNeg ? 1 : 0;
+  for (size_t g = 0; g < nGroups; g += 8) {
+    size_t end = nGroups < g + 8 ? nGroups : g + 8;
+    uint64_t w = 0;
+    for (size_t i = end; i > g; --i) {
+      w = (w << 7) | (src[i - 1] & 0x7F);
+    }
+    if (isNeg) {
+      // sign-extend the final partial chunk before negating
+      w |= ~((UINT64_C(1) << (7 * (end - g))) - 1) & BN__MASK56;
+      w = (~w & BN__MASK56) + carry;
+      carry = w >> 56;
+      w &= BN__MASK56;
+    }
+    if (bn__store56(m, g / 8 * 7, w) != BL_OK) { return BL_OVERFLOW; }
+  }
+  dst->isNeg = isNeg;
+  return BL_OK;
+}
@@ -6,5 +6,86 @@
 
 void bz__normalize(bz_ dst);
 
+////// Two's Complement //////
+
+// These functions treat integers as their infinite two's-complement representation, as most programmers expect.
+// Negative magnitudes are negated a word at a time on the fly, so no complement is ever materialized.
+// Inputs need not be normalized, and a negative zero is treated as zero.
+// Output magnitudes are not normalized; when `BL_OVERFLOW` is returned, the contents of the output are undefined.
+
+// Return the number of bits (including the sign bit) in the shortest two's-complement representation of `src`.
+// Zero needs no bits at all.
+size_t bz__twos_bits(bz_ src);
+
+// Return bit `i` of the two's-complement representation of `src`.
+bool bz__bit(bz_ src, size_t i);
+
+// Place the bitwise and/or/xor of `a` and `b` in `dst`.
+// `BL_OVERFLOW` is returned when the magnitude of `dst` is too small.
+bl_result bz__and(bz_* dst, bz_ a, bz_ b);
+bl_result bz__or(bz_* dst, bz_ a, bz_ b);
+bl_result bz__xor(bz_* dst, bz_ a, bz_ b);
+// Return the maximum size (in base256 digits) of the magnitude of the bitwise and/or/xor of `a` and `b`.
+size_t bz__sizeof_bitwise(bz_ a, bz_ b);
+
+// Place the bitwise complement of `a` (that is, `-a - 1`) in `dst`.
+// `BL_OVERFLOW` is returned when the magnitude of `dst` is too small.
+bl_result bz__not(bz_* dst, bz_ a);
+size_t bz__sizeof_not(bz_ a);
+
+// Place the arithmetic right shift of `a` by `amt` bits (that is, `floor(a / 2^amt)`) in `dst`.
+// Left shifts need no special treatment: shifting the magnitude left is already `a * 2^amt`.
+// `BL_OVERFLOW` is returned when the magnitude of `dst` is too small.
+bl_result bz__shr(bz_* dst, bz_ a, size_t amt);
+size_t bz__sizeof_shr(bz_ a, size_t amt);
+
+// Return the number of base256 digits needed by the results of `bz__wrap` and `bz__wrap_signed`.
+size_t bz__sizeof_wrap(size_t nbits);
+
+// Place `src mod 2^nbits` in `dst`: the low `nbits` bits of its two's-complement representation,
+// which is how an unsigned `nbits`-bit target type would hold it.
+// `BL_OVERFLOW` is returned when `dst` has fewer than `bz__sizeof_wrap(nbits)` digits; any digits past those are zeroed.
+bl_result bz__wrap(bn_* dst, bz_ src, size_t nbits);
+
+// Place the number congruent to `src` modulo `2^nbits` in `[-2^(nbits-1), 2^(nbits-1))` in `dst`,
+// which is how a signed `nbits`-bit two's-complement target type would hold it.
+// Combined with the wrapping kernels of `bn_`, this emulates fixed-width signed arithmetic.
+// `BL_OVERFLOW` is returned when the magnitude of `dst` has too few digits; `bz__sizeof_wrap(nbits)` is always enough.
+bl_result bz__wrap_signed(bz_* dst, bz_ src, size_t nbits);
+
+// Write the low `width` bytes of the two's-complement representation of `src` to `dst`, least significant first.
+// `BL_OVERFLOW` is returned when `src` does not fit in `width` bytes; the (wrapped) low bytes are still written.
+bl_result bz__twos_encode(uint8_t* dst, size_t width, bz_ src);
+
+// Read the `width`-byte two's-complement number at `src` (least significant first) into `dst`.
+// The magnitude needs at most `width` base256 digits; `BL_OVERFLOW` is returned when it has fewer.
+bl_result bz__twos_decode(bz_* dst, const uint8_t* src, size_t width);
+
+////// Serialization //////
+
+// Signed LEB128 stores the infinite two's-complement representation of a number seven bits per byte,
+// least significant group first, and stops as soon as the remaining groups would be copies of the sign bit.
+// The magnitude is negated on the fly, so no two's-complement copy is ever materialized.
+
+// Return the exact number of bytes in the signed LEB128 encoding of `src`.
+// The magnitude need not be normalized.
+size_t bz__sizeof_sleb128(bz_ src);
+
+// Write the signed LEB128 encoding of `src` into the first `bz__sizeof_sleb128(src)` bytes of `dst`.
+// `BL_OVERFLOW` is returned when `dstLen` is too small, in which case the contents of `dst` are undefined.
+bl_result bz__sleb128_encode(uint8_t* dst, size_t dstLen, bz_ src);
+
+// Return the number of base256 digits that must be allocated for the magnitude of the number
+// signed-LEB128-encoded at the start of `src`.
+// If `src` does not contain a complete encoding, zero is returned.
+size_t bz__sizeof_sleb128_decode(const uint8_t* src, size_t srcLen);
+
+// Read a signed-LEB128-encoded number from the start of `src` into `dst`,
+// and store the number of bytes it occupied into `nRead`.
+// The magnitude of the destination need not be blank; it is not normalized.
+// `BL_SYNTAX` is returned if `src` ends before the encoding does,
+// and `BL_OVERFLOW` when the magnitude does not fit into `dst`; in both cases the contents of `dst` are undefined.
+bl_result bz__sleb128_decode(bz_* dst, size_t* nRead, const uint8_t* src, size_t srcLen);
+
 
 #endif
@@ -0,0 +1,48 @@
+#include "core/compact.h"
+
+#include <string.h>
+
+#define NEG 0x01
+#define OUT_OF_LINE 0x80
+
+// Return the number of digits in `src` once normalized.
+static size_t normLen(const bn_* src) {
+  size_t len = src->len;
+  while (len != 0 && src->base256le[len - 1] == 0) { --len; }
+  return len;
+}
+
+bool bl__compact_fits(const bn_* src) {
+  return normLen(src) <= BL__COMPACT_INLINE;
+}
+
+bl_result bl__compact_inline(bl__compact* dst, bool isNeg, const bn_* src) {
+  size_t len = normLen(src);
+  if (len > BL__COMPACT_INLINE) { return BL_OVERFLOW; }
+  memset(dst, 0, sizeof(bl__compact));
+  dst->small.header = (len << 1) | (isNeg && len != 0 ? NEG : 0);
+  memcpy(dst->small.digits, src->base256le, len);
+  return BL_OK;
+}
+
+void bl__compact_outOfLine(bl__compact* dst, bool isNeg, bn_* src) {
+  memset(dst, 0, sizeof(bl__compact));
+  dst->large.header = OUT_OF_LINE | (isNeg ? NEG : 0);
+  dst->large.magnitude = src;
+}
+
+bool bl__compact_isOutOfLine(const bl__compact* src) {
+  return (src->header & OUT_OF_LINE) != 0;
+}
+
+bool bl__compact_isNeg(const bl__compact* src) {
+  return (src->header & NEG) != 0;
+}
+
+const bn_* bl__compact_magnitude(const bl__compact* src, bl__compactView* buf) {
+  if (bl__compact_isOutOfLine(src)) { return src->large.magnitude; }
+  size_t len = (src->small.header >> 1) & 0x0F;
+  buf->magnitude.len = len;
+  memcpy(buf->magnitude.base256le, src->small.digits, len);
+  return &buf->magnitude;
+}
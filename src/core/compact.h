@@ -0,0 +1,66 @@
+#ifndef BIGLIT_CORE_COMPACT
+#define BIGLIT_CORE_COMPACT
+
+// This is the core interface for compact integers: 16-byte handles meant for holding millions of (mostly small) literals.
+// A `bz_` costs a sign, a pointer, and a separately allocated `bn_` with a full `size_t` length,
+// whereas a compact handle folds the sign and a short length into a single header byte,
+// and holds the digits of any integer below 2^120 in the handle itself.
+// Larger magnitudes are held out-of-line as an ordinary `bn_`, so that the core kernels apply to them in place.
+// This header only deals with the layout of a handle; obtaining and releasing out-of-line magnitudes is left to the layer above.
+//
+// The header byte is laid out as:
+//
+//   bit  | meaning
+//   -----+--------------------------------------------------------------
+//      0 | the integer is negative (never set for zero)
+//    1-4 | the number of inline digits, when bit 7 is clear
+//      7 | the magnitude is out-of-line, and `large.magnitude` points at it
+//
+// Inline digits are normalized, and the unused ones are zero, so two inline handles are equal exactly when their bytes are.
+// A handle of all zero bytes is zero.
+
+#include "core/bz_type.h"
+
+#define BL__COMPACT_INLINE 15
+
+typedef union bl__compact {
+  uint8_t header;
+  struct {
+    uint8_t header;
+    uint8_t digits[BL__COMPACT_INLINE];
+  } small;
+  struct {
+    uint8_t header;
+    bn_* magnitude;
+  } large;
+} bl__compact;
+
+// Storage for a `bn_` viewing the magnitude of an inline handle.
+typedef union bl__compactView {
+  bn_ magnitude;
+  uint8_t mem[sizeof(bn_) + BL__COMPACT_INLINE];
+} bl__compactView;
+
+// Return whether the magnitude `src` fits inline.
+// This function does not require input normalization.
+bool bl__compact_fits(const bn_* src);
+
+// Place `src`, made negative if `isNeg`, inline in `dst`.
+// The magnitude is normalized, and a zero is never negative.
+// `BL_OVERFLOW` is returned if the magnitude does not fit inline (see `bl__compact_fits`).
+bl_result bl__compact_inline(bl__compact* dst, bool isNeg, const bn_* src);
+
+// Make `dst` refer to the out-of-line magnitude `src`, made negative if `isNeg`.
+// The handle borrows `src` for as long as it is in use; `src` should be normalized, and not fit inline.
+void bl__compact_outOfLine(bl__compact* dst, bool isNeg, bn_* src);
+
+// Return whether the magnitude of `src` is held out-of-line.
+bool bl__compact_isOutOfLine(const bl__compact* src);
+
+bool bl__compact_isNeg(const bl__compact* src);
+
+// Return the magnitude of `src`.
+// It is either the out-of-line magnitude, or a normalized copy of the inline digits placed in `buf`.
+const bn_* bl__compact_magnitude(const bl__compact* src, bl__compactView* buf);
+
+#endif
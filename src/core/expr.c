@@ -0,0 +1,350 @@
+#include "core/expr.h"
+#include "core/bz.h"
+
+#include <string.h>
+
+static inline size_t max(size_t a, size_t b) {
+  return a > b ? a : b;
+}
+
+#define NONE SIZE_MAX
+
+// Bounds past this are refused, so that the sum of a few of them cannot overflow.
+#define BOUND_MAX (SIZE_MAX / 8)
+
+static const bn_ empty = { .len = 0 };
+
+static bool isUnary(bl__exprOp op) {
+  return op == BL__EXPR_NEG || op == BL__EXPR_NOT || op == BL__EXPR_SHL || op == BL__EXPR_SHR;
+}
+
+static bool isBinary(bl__exprOp op) {
+  return (BL__EXPR_ADD <= op && op <= BL__EXPR_MOD) || (BL__EXPR_AND <= op && op <= BL__EXPR_XOR);
+}
+
+static bool isZero(const bn_* src) {
+  return bn__nbits(src) == 0;
+}
+
+// Return the bytes of arena taken by a buffer of `nDigits` digits, rounded so that the next buffer is aligned like a `bn_`.
+static size_t slotBytes(size_t nDigits) {
+  return (sizeof(bn_) + nDigits + sizeof(bn_) - 1) / sizeof(bn_) * sizeof(bn_);
+}
+
+// Return the operand of the sum or difference `i` that is a product fused into it, or `NONE`.
+static size_t fusedOperand(const bl__exprStep steps[], const bl__exprNode nodes[], size_t i) {
+  if (nodes[i].op != BL__EXPR_ADD && nodes[i].op != BL__EXPR_SUB) { return NONE; }
+  if (steps[nodes[i].a].fusedInto == i) { return nodes[i].a; }
+  if (steps[nodes[i].b].fusedInto == i) { return nodes[i].b; }
+  return NONE;
+}
+
+////// Planning //////
+
+// Work out which nodes the result depends on, how many nodes read each, and which products to fuse.
+static void planUses(bl__exprStep steps[], const bl__exprNode nodes[], size_t n) {
+  steps[n - 1].live = true;
+  for (size_t i = n; i > 0; --i) {
+    const bl__exprNode* node = &nodes[i - 1];
+    if (!steps[i - 1].live || node->op == BL__EXPR_LEAF) { continue; }
+    steps[node->a].live = true;
+    steps[node->a].uses += 1;
+    if (isBinary(node->op)) {
+      steps[node->b].live = true;
+      steps[node->b].uses += 1;
+    }
+  }
+  for (size_t i = 0; i < n; ++i) {
+    const bl__exprNode* node = &nodes[i];
+    if (!steps[i].live || (node->op != BL__EXPR_ADD && node->op != BL__EXPR_SUB)) { continue; }
+    // only one operand of a sum is fused, and only a product no other node reads
+    size_t cands[2] = { node->a, node->b };
+    for (int k = 0; k < 2; ++k) {
+      size_t m = cands[k];
+      if (nodes[m].op == BL__EXPR_MUL && steps[m].uses == 1 && node->a != node->b) {
+        steps[m].fusedInto = i;
+        break;
+      }
+    }
+  }
+  // the operands of a fused product are read when the sum is evaluated
+  for (size_t i = 0; i < n; ++i) {
+    const bl__exprNode* node = &nodes[i];
+    if (!steps[i].live || node->op == BL__EXPR_LEAF) { continue; }
+    size_t at = steps[i].fusedInto != NONE ? steps[i].fusedInto : i;
+    steps[node->a].lastUse = max(steps[node->a].lastUse, at);
+    if (isBinary(node->op)) { steps[node->b].lastUse = max(steps[node->b].lastUse, at); }
+  }
+  steps[n - 1].lastUse = NONE;
+}
+
+// Bound the digits of the value of node `i`, and of the temporary space it needs.
+static bl_result planBounds(bl__exprStep steps[], const bl__exprNode nodes[], size_t i) {
+  const bl__exprNode* node = &nodes[i];
+  bl__exprStep* step = &steps[i];
+  size_t la = node->op == BL__EXPR_LEAF ? 0 : steps[node->a].nDigits;
+  size_t lb = isBinary(node->op) ? steps[node->b].nDigits : 0;
+  switch (node->op) {
+    case BL__EXPR_LEAF: step->nDigits = node->leaf.magnitude->len; break;
+    case BL__EXPR_NEG: step->nDigits = la; break;
+    case BL__EXPR_NOT: step->nDigits = la + 1; break;
+    case BL__EXPR_ADD:
+    case BL__EXPR_SUB: {
+      size_t m = fusedOperand(steps, nodes, i);
+      if (m == NONE) {
+        step->nDigits = max(la, lb) + 1;
+      }
+      else {
+        // the product may need to be formed on its own, when its sign differs from the other operand's
+        size_t lp = steps[nodes[m].a].nDigits + steps[nodes[m].b].nDigits;
+        size_t lc = m == node->a ? lb : la;
+        step->nDigits = max(lp, lc) + 1;
+        step->tmpDigits = lp;
+      }
+    } break;
+    case BL__EXPR_MUL: step->nDigits = la + lb; break;
+    case BL__EXPR_DIV: {
+      // a Euclidean quotient rounds away from zero for negative dividends, and the divisor may be as small as one
+      step->nDigits = la + 1;
+      step->tmpDigits = lb;
+    } break;
+    case BL__EXPR_MOD: {
+      step->nDigits = lb;
+      step->tmpDigits = max(la, lb) + 1;
+    } break;
+    case BL__EXPR_SHL: {
+      if (node->amt / 8 > BOUND_MAX) { return BL_OVERFLOW; }
+      step->nDigits = la + node->amt / 8 + 1;
+    } break;
+    case BL__EXPR_SHR: step->nDigits = (node->amt / 8 < la ? la - node->amt / 8 : 0) + 1; break;
+    case BL__EXPR_AND:
+    case BL__EXPR_OR:
+    case BL__EXPR_XOR: step->nDigits = max(la, lb) + 1; break;
+  }
+  if (step->nDigits > BOUND_MAX || step->tmpDigits > BOUND_MAX) { return BL_OVERFLOW; }
+  return BL_OK;
+}
+
+// A buffer in the arena, as recorded by the step that holds it.
+typedef struct slot {
+  size_t* at;
+  size_t* cap;
+  bool* moved;
+} slot;
+
+// Return the buffer of step `j` (or its temporary space if `tmp`) if it is free by the time node `i` is evaluated.
+static bool freeSlot(slot* dst, bl__exprStep steps[], size_t j, bool tmp, size_t i) {
+  bl__exprStep* step = &steps[j];
+  if (tmp) {
+    *dst = (slot){ &step->tmpAt, &step->tmpCap, &step->tmpMoved };
+    return step->tmpAt != NONE && !step->tmpMoved && j < i;
+  }
+  *dst = (slot){ &step->at, &step->cap, &step->moved };
+  return step->at != NONE && !step->moved && step->lastUse < i;
+}
+
+// Find a buffer of at least `nDigits` digits for node `i`, and store its place in `at` and `cap`.
+// The smallest free buffer that fits is taken over, or else the free buffer at the end of the arena is grown,
+// or else a new one is added with its capacity rounded up to a power of two.
+static bl_result take(size_t* at, size_t* cap, bl__exprStep steps[], size_t i, size_t nDigits, size_t* arenaLen) {
+  slot best = { NULL, NULL, NULL }, last = { NULL, NULL, NULL };
+  for (size_t j = 0; j < i; ++j) {
+    for (int tmp = 0; tmp < 2; ++tmp) {
+      slot s;
+      if (!freeSlot(&s, steps, j, tmp, i)) { continue; }
+      if (*s.cap >= nDigits && (best.at == NULL || *s.cap < *best.cap)) { best = s; }
+      if (*s.at + slotBytes(*s.cap) == *arenaLen) { last = s; }
+    }
+  }
+  if (best.at == NULL && last.at != NULL) {
+    if (slotBytes(nDigits) > SIZE_MAX - *last.at) { return BL_OVERFLOW; }
+    *last.cap = nDigits;
+    *arenaLen = *last.at + slotBytes(nDigits);
+    best = last;
+  }
+  if (best.at != NULL) {
+    *best.moved = true;
+    *at = *best.at;
+    *cap = *best.cap;
+    return BL_OK;
+  }
+  // a new buffer has room to spare, so that it can be taken over as the intermediates of a chain grow
+  size_t room = 8;
+  while (room < nDigits) { room *= 2; }
+  if (slotBytes(room) > SIZE_MAX - *arenaLen) { return BL_OVERFLOW; }
+  *at = *arenaLen;
+  *cap = room;
+  *arenaLen += slotBytes(room);
+  return BL_OK;
+}
+
+bl_result bl__expr_plan(bl__exprStep steps[], size_t* arenaLen, const bl__exprNode nodes[], size_t n) {
+  if (n == 0) { return BL_SYNTAX; }
+  for (size_t i = 0; i < n; ++i) {
+    const bl__exprNode* node = &nodes[i];
+    if (node->op == BL__EXPR_LEAF) {}
+    else if (isUnary(node->op)) { if (node->a >= i) { return BL_SYNTAX; } }
+    else if (isBinary(node->op)) { if (node->a >= i || node->b >= i) { return BL_SYNTAX; } }
+    else { return BL_SYNTAX; }
+    steps[i] = (bl__exprStep){ .lastUse = 0, .fusedInto = NONE, .at = NONE, .tmpAt = NONE };
+  }
+  planUses(steps, nodes, n);
+  size_t len = 0;
+  for (size_t i = 0; i < n; ++i) {
+    if (!steps[i].live) { continue; }
+    bl_result err = planBounds(steps, nodes, i);
+    if (err != BL_OK) { return err; }
+    if (nodes[i].op == BL__EXPR_LEAF || steps[i].fusedInto != NONE) { continue; }
+    // the buffer is taken before the temporary space, so they are never the same
+    err = take(&steps[i].at, &steps[i].cap, steps, i, steps[i].nDigits, &len);
+    if (err != BL_OK) { return err; }
+    bool needsTmp = nodes[i].op == BL__EXPR_DIV || nodes[i].op == BL__EXPR_MOD || fusedOperand(steps, nodes, i) != NONE;
+    if (needsTmp) {
+      err = take(&steps[i].tmpAt, &steps[i].tmpCap, steps, i, steps[i].tmpDigits, &len);
+      if (err != BL_OK) { return err; }
+    }
+  }
+  *arenaLen = len;
+  return BL_OK;
+}
+
+////// Evaluation //////
+
+// Return the blank buffer of `nDigits` digits at offset `at` in the arena.
+static bn_* buffer(uint8_t* arena, size_t at, size_t nDigits) {
+  bn_* out = (bn_*)(arena + at);
+  out->len = nDigits;
+  bn__blank(out);
+  return out;
+}
+
+// Place `x + y` in `dst`, using the blank buffer `out`.
+static bl_result addSigned(bz_* dst, bn_* out, bz_ x, bz_ y) {
+  dst->magnitude = out;
+  if (x.isNeg == y.isNeg) {
+    dst->isNeg = x.isNeg;
+    return bn__add(out, x.magnitude, y.magnitude);
+  }
+  switch (bn__cmp(x.magnitude, y.magnitude)) {
+    case BL_GT: dst->isNeg = x.isNeg; return bn__sub(out, x.magnitude, y.magnitude);
+    case BL_LT: dst->isNeg = y.isNeg; return bn__sub(out, y.magnitude, x.magnitude);
+    case BL_EQ: break;
+  }
+  dst->isNeg = false;
+  out->len = 0;
+  return BL_OK;
+}
+
+// Evaluate the sum or difference `i`, whose operand `m` is a fused product.
+static bl_result evalFused(bz_* dst, bn_* out, bn_* tmp, const bl__exprStep steps[], const bl__exprNode nodes[], size_t i, size_t m) {
+  const bl__exprNode* node = &nodes[i];
+  bz_ p = steps[nodes[m].a].value, q = steps[nodes[m].b].value;
+  bz_ c = steps[m == node->a ? node->b : node->a].value;
+  bool pNeg = p.isNeg ^ q.isNeg;
+  // the second operand of a difference is negated
+  if (node->op == BL__EXPR_SUB) {
+    if (m == node->b) { pNeg = !pNeg; }
+    else { c.isNeg = !c.isNeg; }
+  }
+  bool pZero = isZero(p.magnitude) || isZero(q.magnitude);
+  if (pZero || isZero(c.magnitude) || pNeg == c.isNeg) {
+    dst->isNeg = pZero ? c.isNeg : pNeg;
+    dst->magnitude = out;
+    return bn__fma(out, p.magnitude, q.magnitude, c.magnitude);
+  }
+  bl_result err = bn__fma(tmp, p.magnitude, q.magnitude, &empty);
+  if (err != BL_OK) { return err; }
+  bn__normalize(tmp);
+  bz_ prod = { .isNeg = pNeg, .magnitude = tmp };
+  return addSigned(dst, out, prod, c);
+}
+
+// Evaluate the Euclidean quotient or remainder `i` into the buffer `out` and temporary space `tmp`.
+static bl_result evalDivmod(bz_* dst, bn_* out, bn_* tmp, const bl__exprStep steps[], const bl__exprNode nodes[], size_t i) {
+  bz_ x = steps[nodes[i].a].value, y = steps[nodes[i].b].value;
+  if (isZero(y.magnitude)) { return BL_DIVZERO; }
+  bool isDiv = nodes[i].op == BL__EXPR_DIV;
+  bn_* q = isDiv ? out : tmp;
+  bn_* r = isDiv ? tmp : out;
+  bl_result err = bn__divmod(q, r, x.magnitude, y.magnitude);
+  if (err != BL_OK) { return err; }
+  // with a non-zero remainder, a negative dividend rounds the quotient away from zero, and the remainder up from `r - |y|`
+  bool adjust = x.isNeg && !isZero(r);
+  dst->magnitude = out;
+  if (isDiv) {
+    dst->isNeg = x.isNeg ^ y.isNeg;
+    // the top digit of `q` is spare, so nothing carries out of it
+    return adjust ? bn__inc(q, q) : BL_OK;
+  }
+  dst->isNeg = false;
+  if (!adjust) { return BL_OK; }
+  bn__normalize(r);
+  tmp->len = steps[i].tmpDigits;
+  bn__blank(tmp);
+  err = bn__sub(tmp, y.magnitude, r);
+  if (err != BL_OK) { return err; }
+  bn__normalize(tmp);
+  out->len = steps[i].nDigits;
+  return bn__copy(out, tmp);
+}
+
+// Evaluate node `i` (which is neither a leaf nor fused) into the buffer `out` and temporary space `tmp`.
+static bl_result evalNode(bz_* dst, bn_* out, bn_* tmp, const bl__exprStep steps[], const bl__exprNode nodes[], size_t i) {
+  const bl__exprNode* node = &nodes[i];
+  bz_ x = steps[node->a].value;
+  bz_ y = isBinary(node->op) ? steps[node->b].value : x;
+  dst->magnitude = out;
+  switch (node->op) {
+    case BL__EXPR_LEAF: return BL_OK;
+    case BL__EXPR_NEG: dst->isNeg = !x.isNeg; return bn__copy(out, x.magnitude);
+    case BL__EXPR_NOT: return bz__not(dst, x);
+    case BL__EXPR_ADD:
+    case BL__EXPR_SUB: {
+      size_t m = fusedOperand(steps, nodes, i);
+      if (m != NONE) { return evalFused(dst, out, tmp, steps, nodes, i, m); }
+      if (node->op == BL__EXPR_SUB) { y.isNeg = !y.isNeg; }
+      return addSigned(dst, out, x, y);
+    }
+    case BL__EXPR_MUL: dst->isNeg = x.isNeg ^ y.isNeg; return bn__fma(out, x.magnitude, y.magnitude, &empty);
+    case BL__EXPR_DIV:
+    case BL__EXPR_MOD: return evalDivmod(dst, out, tmp, steps, nodes, i);
+    case BL__EXPR_SHL: {
+      dst->isNeg = x.isNeg;
+      bl_result err = bn__copy(out, x.magnitude);
+      bn__shl(out, node->amt);
+      return err;
+    }
+    case BL__EXPR_SHR: return bz__shr(dst, x, node->amt);
+    case BL__EXPR_AND: return bz__and(dst, x, y);
+    case BL__EXPR_OR: return bz__or(dst, x, y);
+    case BL__EXPR_XOR: return bz__xor(dst, x, y);
+  }
+  return BL_SYNTAX;
+}
+
+bl_result bl__expr_eval(bz_* dst, bl__exprStep steps[], const bl__exprNode nodes[], size_t n, uint8_t* arena, size_t arenaLen) {
+  for (size_t i = 0; i < n; ++i) {
+    bl__exprStep* step = &steps[i];
+    if (!step->live || step->fusedInto != NONE) { continue; }
+    if (nodes[i].op == BL__EXPR_LEAF) {
+      if (nodes[i].leaf.magnitude->len > step->nDigits) { return BL_OVERFLOW; }
+      step->value = nodes[i].leaf;
+      continue;
+    }
+    if (step->at > arenaLen || slotBytes(step->cap) > arenaLen - step->at) { return BL_OVERFLOW; }
+    bn_* out = buffer(arena, step->at, step->nDigits);
+    bn_* tmp = NULL;
+    if (step->tmpAt != NONE) {
+      if (step->tmpAt > arenaLen || slotBytes(step->tmpCap) > arenaLen - step->tmpAt) { return BL_OVERFLOW; }
+      tmp = buffer(arena, step->tmpAt, step->tmpDigits);
+    }
+    bz_ value;
+    bl_result err = evalNode(&value, out, tmp, steps, nodes, i);
+    if (err != BL_OK) { return err; }
+    bn__normalize(value.magnitude);
+    if (value.magnitude->len == 0) { value.isNeg = false; }
+    step->value = value;
+  }
+  *dst = steps[n - 1].value;
+  return BL_OK;
+}
@@ -0,0 +1,75 @@
+#ifndef BIGLIT_CORE_EXPR
+#define BIGLIT_CORE_EXPR
+
+// This is the core interface for folding constant expressions over ℤ, such as `(a*b + c) % d << 3`,
+// without a separate allocation for each intermediate result.
+// An expression is an array of nodes in which every operand is an earlier node, so that it may share subexpressions (a DAG),
+// and the last node is the result.
+//
+// Evaluation happens in two steps, much as a compiler allocates registers:
+//   * `bl__expr_plan` bounds the size of every intermediate from the sizes of the leaves,
+//     works out the last node to read each one, and assigns it a buffer in a single arena,
+//     reusing the buffers of intermediates that are no longer needed (the smallest that fits, or else the last one, grown),
+//     and rounding the capacity of new buffers up to a power of two so that they can be reused as intermediates grow;
+//   * `bl__expr_eval` runs the core kernels into those buffers, and so needs no memory besides the arena.
+// The plan depends only on the shape of the expression and the lengths of the leaves,
+// so it may be reused to evaluate the same expression over leaves that are no longer.
+// Planning takes time quadratic in the number of nodes, which is meant for the expressions found in source code.
+//
+// Nodes that the result does not depend on are neither planned nor evaluated.
+// A product read only by a sum or difference is not materialized: it is fused into that node as a multiply-add (see `bn__fma`).
+// Division and remainder are Euclidean, as in `basic/bz.h`, and shifts are by constant amounts.
+
+#include "core/bz_type.h"
+
+typedef enum bl__exprOp {
+  BL__EXPR_LEAF, // `leaf`
+  BL__EXPR_NEG, // `-a`
+  BL__EXPR_NOT, // `~a`, that is, `-a - 1`
+  BL__EXPR_ADD, // `a + b`
+  BL__EXPR_SUB, // `a - b`
+  BL__EXPR_MUL, // `a * b`
+  BL__EXPR_DIV, // `a div b`
+  BL__EXPR_MOD, // `a mod b`
+  BL__EXPR_SHL, // `a * 2^amt`
+  BL__EXPR_SHR, // `floor(a / 2^amt)`
+  BL__EXPR_AND, // `a & b` (in two's complement)
+  BL__EXPR_OR, // `a | b`
+  BL__EXPR_XOR // `a ^ b`
+} bl__exprOp;
+
+typedef struct bl__exprNode {
+  bl__exprOp op;
+  bz_ leaf; // the value of a leaf, which is borrowed; its magnitude must be normalized
+  size_t a, b; // the indices of the operands, which must be earlier nodes (`b` is unused by unary operations)
+  size_t amt; // the amount of a shift
+} bl__exprNode;
+
+// The plan of one node, filled in by `bl__expr_plan`; callers only provide the memory.
+typedef struct bl__exprStep {
+  size_t nDigits; // bound on the digits of the magnitude of the node's value
+  size_t tmpDigits; // digits of temporary space needed while evaluating the node
+  size_t uses; // the number of nodes reading this one
+  size_t lastUse; // the last node to read this one (`SIZE_MAX` for the result)
+  size_t fusedInto; // the node that evaluates this one as part of itself, or `SIZE_MAX`
+  size_t at, cap; // offset in bytes and capacity in digits of the node's buffer in the arena (`at` is `SIZE_MAX` for none)
+  size_t tmpAt, tmpCap; // likewise for its temporary space
+  bool live; // whether the result depends on the node
+  bool moved, tmpMoved; // whether a later node has taken over the buffer or temporary space
+  bz_ value; // the node's value, filled in by `bl__expr_eval`
+} bl__exprStep;
+
+// Plan the evaluation of the `n` nodes into `steps` (which must have room for `n`),
+// and store the number of bytes of arena the evaluation needs in `arenaLen`.
+// `BL_SYNTAX` is returned if there are no nodes, a node has an unknown operation, or an operand is not an earlier node,
+// and `BL_OVERFLOW` if an intermediate could be too large to address.
+bl_result bl__expr_plan(bl__exprStep steps[], size_t* arenaLen, const bl__exprNode nodes[], size_t n);
+
+// Evaluate the `n` nodes as planned in `steps`, in the `arenaLen` bytes at `arena` (which should be aligned like a `bn_`),
+// and store the value of the last node in `dst`.
+// The magnitude of the result points into the arena (or is that of a leaf), and _is_ normalized.
+// `BL_DIVZERO` is returned if a divisor is zero, and `BL_OVERFLOW` if the arena is smaller than planned or a leaf longer;
+// in both cases `dst` is unchanged.
+bl_result bl__expr_eval(bz_* dst, bl__exprStep steps[], const bl__exprNode nodes[], size_t n, uint8_t* arena, size_t arenaLen);
+
+#endif
@@ -0,0 +1,227 @@
+#include "core/kernels.h"
+#include "core/limb.h"
+
+#include <string.h>
+
+// On x86-64, GCC and Clang can compile individual functions for instruction set extensions the build does not target,
+// and report which extensions the CPU running the program has;
+// everywhere else, only the portable kernels are built.
+#if defined(__GNUC__) && defined(__x86_64__)
+#define BN__X86_KERNELS 1
+#include <immintrin.h>
+#else
+#define BN__X86_KERNELS 0
+#endif
+
+////// Portable //////
+
+// These are the reference implementations, which work a word at a time without assuming endianness or alignment.
+
+static bool always(void) {
+  return true;
+}
+
+static unsigned addPortable(uint8_t* r, const uint8_t* a, const uint8_t* b, size_t n, unsigned carry) {
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    uint64_t x = bn__load64(a + i);
+    uint64_t s = x + bn__load64(b + i);
+    unsigned out = s < x;
+    s += carry;
+    out += s < carry;
+    bn__store64(r + i, s);
+    carry = out;
+  }
+  for (; i < n; ++i) {
+    unsigned s = a[i] + b[i] + carry;
+    r[i] = s & 0xFF;
+    carry = s >> 8;
+  }
+  return carry;
+}
+
+static unsigned subPortable(uint8_t* r, const uint8_t* a, const uint8_t* b, size_t n, unsigned borrow) {
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    uint64_t x = bn__load64(a + i), y = bn__load64(b + i);
+    uint64_t d = x - y;
+    unsigned out = x < y;
+    out += d < borrow;
+    bn__store64(r + i, d - borrow);
+    borrow = out;
+  }
+  for (; i < n; ++i) {
+    unsigned d = a[i] - b[i] - borrow;
+    r[i] = d & 0xFF;
+    borrow = (d >> 8) & 1;
+  }
+  return borrow;
+}
+
+#define BITWISE_PORTABLE(name, op) \
+  static void name(uint8_t* r, const uint8_t* a, const uint8_t* b, size_t n) { \
+    size_t i = 0; \
+    for (; i + 8 <= n; i += 8) { bn__store64(r + i, bn__load64(a + i) op bn__load64(b + i)); } \
+    for (; i < n; ++i) { r[i] = a[i] op b[i]; } \
+  }
+
+BITWISE_PORTABLE(andPortable, &)
+BITWISE_PORTABLE(orPortable, |)
+BITWISE_PORTABLE(xorPortable, ^)
+
+static unsigned popcount64(uint64_t w) {
+  w = w - ((w >> 1) & UINT64_C(0x5555555555555555));
+  w = (w & UINT64_C(0x3333333333333333)) + ((w >> 2) & UINT64_C(0x3333333333333333));
+  w = (w + (w >> 4)) & UINT64_C(0x0F0F0F0F0F0F0F0F);
+  return (w * UINT64_C(0x0101010101010101)) >> 56;
+}
+
+static size_t popcountPortable(const uint8_t* src, size_t n) {
+  size_t out = 0, i = 0;
+  for (; i + 8 <= n; i += 8) { out += popcount64(bn__load64(src + i)); }
+  for (; i < n; ++i) { out += popcount64(src[i]); }
+  return out;
+}
+
+////// x86-64 //////
+
+#if BN__X86_KERNELS
+
+// Digits are little-endian, as is the CPU, so words are loaded and stored directly.
+
+static bool hasAvx2(void) {
+  return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("adx") && __builtin_cpu_supports("popcnt");
+}
+
+static bool hasAvx512(void) {
+  return hasAvx2() && __builtin_cpu_supports("avx512f");
+}
+
+// The carry flag is threaded straight through the chain, rather than recomputed from comparisons.
+__attribute__((target("adx")))
+static unsigned addAdx(uint8_t* r, const uint8_t* a, const uint8_t* b, size_t n, unsigned carry) {
+  unsigned char c = carry;
+  size_t i = 0;
+  for (; i + 32 <= n; i += 32) {
+    unsigned long long s0, s1, s2, s3;
+    c = _addcarryx_u64(c, bn__load64(a + i), bn__load64(b + i), &s0);
+    c = _addcarryx_u64(c, bn__load64(a + i + 8), bn__load64(b + i + 8), &s1);
+    c = _addcarryx_u64(c, bn__load64(a + i + 16), bn__load64(b + i + 16), &s2);
+    c = _addcarryx_u64(c, bn__load64(a + i + 24), bn__load64(b + i + 24), &s3);
+    memcpy(r + i, &s0, 8);
+    memcpy(r + i + 8, &s1, 8);
+    memcpy(r + i + 16, &s2, 8);
+    memcpy(r + i + 24, &s3, 8);
+  }
+  return addPortable(r + i, a + i, b + i, n - i, c);
+}
+
+__attribute__((target("adx")))
+static unsigned subAdx(uint8_t* r, const uint8_t* a, const uint8_t* b, size_t n, unsigned borrow) {
+  unsigned char c = borrow;
+  size_t i = 0;
+  for (; i + 32 <= n; i += 32) {
+    unsigned long long d0, d1, d2, d3;
+    c = _subborrow_u64(c, bn__load64(a + i), bn__load64(b + i), &d0);
+    c = _subborrow_u64(c, bn__load64(a + i + 8), bn__load64(b + i + 8), &d1);
+    c = _subborrow_u64(c, bn__load64(a + i + 16), bn__load64(b + i + 16), &d2);
+    c = _subborrow_u64(c, bn__load64(a + i + 24), bn__load64(b + i + 24), &d3);
+    memcpy(r + i, &d0, 8);
+    memcpy(r + i + 8, &d1, 8);
+    memcpy(r + i + 16, &d2, 8);
+    memcpy(r + i + 24, &d3, 8);
+  }
+  return subPortable(r + i, a + i, b + i, n - i, c);
+}
+
+#define BITWISE_AVX2(name, intrinsic, tail) \
+  __attribute__((target("avx2"))) \
+  static void name(uint8_t* r, const uint8_t* a, const uint8_t* b, size_t n) { \
+    size_t i = 0; \
+    for (; i + 32 <= n; i += 32) { \
+      __m256i x = _mm256_loadu_si256((const __m256i*)(a + i)); \
+      __m256i y = _mm256_loadu_si256((const __m256i*)(b + i)); \
+      _mm256_storeu_si256((__m256i*)(r + i), intrinsic(x, y)); \
+    } \
+    tail(r + i, a + i, b + i, n - i); \
+  }
+
+BITWISE_AVX2(andAvx2, _mm256_and_si256, andPortable)
+BITWISE_AVX2(orAvx2, _mm256_or_si256, orPortable)
+BITWISE_AVX2(xorAvx2, _mm256_xor_si256, xorPortable)
+
+#define BITWISE_AVX512(name, intrinsic, tail) \
+  __attribute__((target("avx512f"))) \
+  static void name(uint8_t* r, const uint8_t* a, const uint8_t* b, size_t n) { \
+    size_t i = 0; \
+    for (; i + 64 <= n; i += 64) { \
+      __m512i x = _mm512_loadu_si512(a + i); \
+      __m512i y = _mm512_loadu_si512(b + i); \
+      _mm512_storeu_si512(r + i, intrinsic(x, y)); \
+    } \
+    tail(r + i, a + i, b + i, n - i); \
+  }
+
+BITWISE_AVX512(andAvx512, _mm512_and_si512, andAvx2)
+BITWISE_AVX512(orAvx512, _mm512_or_si512, orAvx2)
+BITWISE_AVX512(xorAvx512, _mm512_xor_si512, xorAvx2)
+
+__attribute__((target("popcnt")))
+static size_t popcountPopcnt(const uint8_t* src, size_t n) {
+  size_t out = 0, i = 0;
+  for (; i + 8 <= n; i += 8) {
+    unsigned long long w;
+    memcpy(&w, src + i, 8);
+    out += __builtin_popcountll(w);
+  }
+  return out + popcountPortable(src + i, n - i);
+}
+
+#endif
+
+////// Dispatch //////
+
+// Sets are listed from slowest to fastest; the portable set comes first, and works everywhere.
+static const bn__kernelSet kernelSets[] = {
+  { "portable", always, addPortable, subPortable, andPortable, orPortable, xorPortable, popcountPortable },
+#if BN__X86_KERNELS
+  { "avx2", hasAvx2, addAdx, subAdx, andAvx2, orAvx2, xorAvx2, popcountPopcnt },
+  { "avx512", hasAvx512, addAdx, subAdx, andAvx512, orAvx512, xorAvx512, popcountPopcnt },
+#endif
+};
+
+#define N_KERNEL_SETS (sizeof(kernelSets) / sizeof(kernelSets[0]))
+
+const bn__kernelSet* bn__kernels = &kernelSets[0];
+
+#if BN__X86_KERNELS
+// Choose the fastest supported set before `main`, so that no call ever pays for the choice.
+__attribute__((constructor))
+static void chooseKernels(void) {
+  __builtin_cpu_init();
+  for (size_t i = N_KERNEL_SETS; i > 0; --i) {
+    if (kernelSets[i - 1].supported()) {
+      bn__kernels = &kernelSets[i - 1];
+      return;
+    }
+  }
+}
+#endif
+
+const char* bn__get_kernels(void) {
+  return bn__kernels->name;
+}
+
+const char* bn__kernels_name(size_t i) {
+  return i < N_KERNEL_SETS ? kernelSets[i].name : NULL;
+}
+
+bool bn__set_kernels(const char* name) {
+  for (size_t i = 0; i < N_KERNEL_SETS; ++i) {
+    if (strcmp(kernelSets[i].name, name) == 0 && kernelSets[i].supported()) {
+      bn__kernels = &kernelSets[i];
+      return true;
+    }
+  }
+  return false;
+}
@@ -0,0 +1,32 @@
+#ifndef BIGLIT_CORE_KERNELS
+#define BIGLIT_CORE_KERNELS
+
+// This header is private to the core translation units.
+// The innermost loops over digits have a portable implementation, and faster ones for some CPUs.
+// `bn__kernels` points at the fastest set the host supports, chosen once at startup;
+// `bn__set_kernels` (see `core/bn.h`) switches sets, e.g. so that tests can check each against the portable one.
+//
+// Every kernel works on `n` digits, reading and writing them in order,
+// so `r` may be the same array as `a` or `b`, but must not otherwise overlap them.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct bn__kernelSet {
+  const char* name;
+  bool (*supported)(void);
+  // Place `a + b + carry` in `r`, returning the carry out of the top digit.
+  unsigned (*add)(uint8_t* r, const uint8_t* a, const uint8_t* b, size_t n, unsigned carry);
+  // Place `a - b - borrow` in `r`, returning the borrow out of the top digit.
+  unsigned (*sub)(uint8_t* r, const uint8_t* a, const uint8_t* b, size_t n, unsigned borrow);
+  void (*bitAnd)(uint8_t* r, const uint8_t* a, const uint8_t* b, size_t n);
+  void (*bitOr)(uint8_t* r, const uint8_t* a, const uint8_t* b, size_t n);
+  void (*bitXor)(uint8_t* r, const uint8_t* a, const uint8_t* b, size_t n);
+  // Return the number of set bits.
+  size_t (*popcount)(const uint8_t* src, size_t n);
+} bn__kernelSet;
+
+extern const bn__kernelSet* bn__kernels;
+
+#endif
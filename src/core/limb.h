@@ -0,0 +1,177 @@
+#ifndef BIGLIT_CORE_LIMB
+#define BIGLIT_CORE_LIMB
+
+// This header is private to the core translation units.
+// Numbers are stored as base256 little-endian digits, but several kernels are much faster
+// when they can work on a machine word at a time.
+// These helpers load and store words from/to digit arrays without assuming anything about
+// the alignment of the digits or the endianness of the host;
+// compilers recognize the shift-and-or pattern and emit a single load/store on little-endian targets.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "core/bn.h"
+
+// Read `n ≤ 8` digits starting at `src` into the low bits of a word.
+static inline uint64_t bn__loadN(const uint8_t* src, size_t n) {
+  uint64_t out = 0;
+  for (size_t i = n; i > 0; --i) {
+    out = (out << 8) | src[i - 1];
+  }
+  return out;
+}
+
+// Write the low `n ≤ 8` bytes of `w` as digits starting at `dst`.
+static inline void bn__storeN(uint8_t* dst, uint64_t w, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    dst[i] = w & 0xFF;
+    w = w >> 8;
+  }
+}
+
+static inline uint64_t bn__load64(const uint8_t* src) {
+  return (uint64_t)src[0]
+       | (uint64_t)src[1] << 8
+       | (uint64_t)src[2] << 16
+       | (uint64_t)src[3] << 24
+       | (uint64_t)src[4] << 32
+       | (uint64_t)src[5] << 40
+       | (uint64_t)src[6] << 48
+       | (uint64_t)src[7] << 56;
+}
+
+static inline void bn__store64(uint8_t* dst, uint64_t w) {
+  dst[0] = w & 0xFF;
+  dst[1] = (w >> 8) & 0xFF;
+  dst[2] = (w >> 16) & 0xFF;
+  dst[3] = (w >> 24) & 0xFF;
+  dst[4] = (w >> 32) & 0xFF;
+  dst[5] = (w >> 40) & 0xFF;
+  dst[6] = (w >> 48) & 0xFF;
+  dst[7] = (w >> 56) & 0xFF;
+}
+
+// Number of significant bits in `w` (zero for zero).
+static inline unsigned bn__bitlen64(uint64_t w) {
+#if defined(__GNUC__)
+  return w == 0 ? 0 : 64 - __builtin_clzll(w);
+#else
+  unsigned out = 0;
+  while (w != 0) { ++out; w = w >> 1; }
+  return out;
+#endif
+}
+
+// Number of trailing zero bits in `w`, which must be non-zero.
+static inline unsigned bn__ctz64(uint64_t w) {
+#if defined(__GNUC__)
+  return __builtin_ctzll(w);
+#else
+  unsigned out = 0;
+  while (!(w & 1)) { ++out; w = w >> 1; }
+  return out;
+#endif
+}
+
+// Return the low word of `a * b`, and place the high word in `hi`.
+static inline uint64_t bn__mul64(uint64_t a, uint64_t b, uint64_t* hi) {
+#if defined(__SIZEOF_INT128__)
+  __extension__ typedef unsigned __int128 u128;
+  u128 p = (u128)a * b;
+  *hi = p >> 64;
+  return (uint64_t)p;
+#else
+  uint64_t aLo = a & 0xFFFFFFFF, aHi = a >> 32;
+  uint64_t bLo = b & 0xFFFFFFFF, bHi = b >> 32;
+  uint64_t ll = aLo * bLo, lh = aLo * bHi, hl = aHi * bLo, hh = aHi * bHi;
+  uint64_t mid = (ll >> 32) + (lh & 0xFFFFFFFF) + (hl & 0xFFFFFFFF);
+  *hi = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+  return (mid << 32) | (ll & 0xFFFFFFFF);
+#endif
+}
+
+////// Word-at-a-time kernels //////
+
+// Replace the `*used` digits of `acc` with `acc * k + c`, a word at a time.
+static inline bl_result bn__muladd1(bn_* acc, size_t* used, uint64_t k, uint64_t c) {
+  uint8_t* digits = &acc->base256le[0];
+  size_t n = *used;
+  uint64_t carry = c;
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    uint64_t hi;
+    uint64_t lo = bn__mul64(bn__load64(&digits[i]), k, &hi);
+    lo += carry;
+    hi += lo < carry;
+    bn__store64(&digits[i], lo);
+    carry = hi;
+  }
+  if (i < n) {
+    size_t tail = n - i;
+    uint64_t hi;
+    uint64_t lo = bn__mul64(bn__loadN(&digits[i], tail), k, &hi);
+    lo += carry;
+    hi += lo < carry;
+    bn__storeN(&digits[i], lo, tail);
+    carry = (lo >> (8 * tail)) | (hi << (64 - 8 * tail));
+  }
+  for (; carry != 0; carry = carry >> 8) {
+    if (n >= acc->len) { return BL_OVERFLOW; }
+    digits[n++] = carry & 0xFF;
+  }
+  *used = n;
+  return BL_OK;
+}
+
+////// Scratch Space //////
+
+// Functions that need several temporary numbers take a single `bn_` of scratch space from the caller, and carve it up.
+
+// Return the scratch digits used by carving out a `bn_` with `nDigits` digits (including room to align it).
+static inline size_t bn__sizeof_carve(size_t nDigits) {
+  return sizeof(bn_) + nDigits + sizeof(bn_);
+}
+
+// Take a `bn_` with `nDigits` digits from the scratch space, or return `NULL` if there is not enough left.
+static inline bn_* bn__carve(uint8_t** at, uint8_t* end, size_t nDigits) {
+  uintptr_t p = (uintptr_t)*at;
+  p = (p + sizeof(bn_) - 1) / sizeof(bn_) * sizeof(bn_);
+  uint8_t* start = *at + (p - (uintptr_t)*at);
+  if (start > end || (size_t)(end - start) < sizeof(bn_) + nDigits) { return NULL; }
+  *at = start + sizeof(bn_) + nDigits;
+  bn_* out = (bn_*)start;
+  out->len = nDigits;
+  return out;
+}
+
+////// Seven-bit groups //////
+
+// Seven bytes of digits hold exactly eight of the seven-bit groups used by LEB128 and VLQ,
+// so serialization moves between the two representations 56 bits at a time.
+#define BN__MASK56 ((UINT64_C(1) << 56) - 1)
+
+// Load the 56 bits starting at digit `i`, treating digits past the end of `src` as zero.
+static inline uint64_t bn__load56(const bn_* src, size_t i) {
+  if (i >= src->len) { return 0; }
+  if (src->len - i >= 8) { return bn__load64(&src->base256le[i]) & BN__MASK56; }
+  return bn__loadN(&src->base256le[i], src->len - i < 7 ? src->len - i : 7);
+}
+
+// Store the 56 bits of `w` starting at digit `i`, failing if any set bits fall past the end of `dst`.
+static inline bl_result bn__store56(bn_* dst, size_t i, uint64_t w) {
+  size_t room = i >= dst->len ? 0 : dst->len - i < 7 ? dst->len - i : 7;
+  if ((w >> (8 * room)) != 0) { return BL_OVERFLOW; }
+  if (room != 0) { bn__storeN(&dst->base256le[i], w, room); }
+  return BL_OK;
+}
+
+// Return the number of bytes up to and including the first without a continuation bit, or zero if there is none.
+static inline size_t bn__groupsLen(const uint8_t* src, size_t srcLen) {
+  for (size_t i = 0; i < srcLen; ++i) {
+    if (!(src[i] & 0x80)) { return i + 1; }
+  }
+  return 0;
+}
+
+#endif
@@ -0,0 +1,89 @@
+#include "core/pool.h"
+
+#include <string.h>
+
+static const uint8_t magic[8] = { 'B', 'L', 'P', 'O', 'O', 'L', 0, BL__POOL_VERSION };
+static const uint32_t byteOrderMark = 0x01020304;
+
+// Return the number of digits in `src` once normalized.
+static size_t normLen(const bn_* src) {
+  size_t len = src->len;
+  while (len != 0 && src->base256le[len - 1] == 0) { --len; }
+  return len;
+}
+
+static size_t alignUp(size_t n) {
+  return (n + BL__POOL_ALIGN - 1) / BL__POOL_ALIGN * BL__POOL_ALIGN;
+}
+
+static size_t sizeofEntry(const bn_* src) {
+  return alignUp(sizeof(bn_) + normLen(src));
+}
+
+size_t bl__sizeof_pool(const bz_* entries, size_t n) {
+  size_t out = BL__POOL_HEADER + 8 * n;
+  for (size_t i = 0; i < n; ++i) {
+    out += sizeofEntry(entries[i].magnitude);
+  }
+  return out;
+}
+
+bl_result bl__pool_write(uint8_t* dst, size_t dstLen, const bz_* entries, size_t n) {
+  if (dstLen < bl__sizeof_pool(entries, n)) { return BL_OVERFLOW; }
+  // header
+  memset(dst, 0, BL__POOL_HEADER);
+  memcpy(&dst[0], magic, sizeof(magic));
+  memcpy(&dst[8], &byteOrderMark, sizeof(byteOrderMark));
+  dst[12] = sizeof(size_t);
+  uint64_t count = n;
+  memcpy(&dst[16], &count, sizeof(count));
+  // index and entries
+  size_t at = BL__POOL_HEADER + 8 * n;
+  for (size_t i = 0; i < n; ++i) {
+    const bn_* src = entries[i].magnitude;
+    size_t len = normLen(src);
+    uint64_t slot = at | (entries[i].isNeg && len != 0);
+    memcpy(&dst[BL__POOL_HEADER + 8 * i], &slot, sizeof(slot));
+    memcpy(&dst[at], &len, sizeof(len));
+    memcpy(&dst[at + sizeof(bn_)], &src->base256le[0], len);
+    size_t padded = sizeofEntry(src);
+    memset(&dst[at + sizeof(bn_) + len], 0, padded - sizeof(bn_) - len);
+    at += padded;
+  }
+  return BL_OK;
+}
+
+bl_result bl__pool_open(bl__pool* pool, const uint8_t* src, size_t srcLen) {
+  if (srcLen < BL__POOL_HEADER) { return BL_SYNTAX; }
+  if (memcmp(&src[0], magic, sizeof(magic)) != 0) { return BL_SYNTAX; }
+  uint32_t bom;
+  memcpy(&bom, &src[8], sizeof(bom));
+  if (bom != byteOrderMark || src[12] != sizeof(size_t)) { return BL_SYNTAX; }
+  uint64_t count;
+  memcpy(&count, &src[16], sizeof(count));
+  if (count > (srcLen - BL__POOL_HEADER) / 8) { return BL_SYNTAX; }
+  pool->base = src;
+  pool->size = srcLen;
+  pool->count = count;
+  return BL_OK;
+}
+
+static uint64_t slot(const bl__pool* pool, size_t i) {
+  uint64_t out;
+  memcpy(&out, &pool->base[BL__POOL_HEADER + 8 * i], sizeof(out));
+  return out;
+}
+
+const bn_* bl__pool_get(const bl__pool* pool, size_t i) {
+  if (i >= pool->count) { return NULL; }
+  uint64_t at = slot(pool, i) & ~(uint64_t)1;
+  if (at % BL__POOL_ALIGN != 0 || at > pool->size || pool->size - at < sizeof(bn_)) { return NULL; }
+  const bn_* out = (const bn_*)&pool->base[at];
+  if (out->len > pool->size - at - sizeof(bn_)) { return NULL; }
+  return out;
+}
+
+bool bl__pool_isNeg(const bl__pool* pool, size_t i) {
+  if (i >= pool->count) { return false; }
+  return slot(pool, i) & 1;
+}
@@ -0,0 +1,59 @@
+#ifndef BIGLIT_CORE_POOL
+#define BIGLIT_CORE_POOL
+
+// This is the core interface for constant pools: files holding many numbers at once,
+// laid out so that a loader can hand out pointers to the numbers in place, without copying or allocating.
+// This header only deals with the layout of a pool in memory; getting the bytes to and from disk
+// (e.g. with `mmap`) is left to the layer above.
+//
+// The layout is native to the machine that writes it, since every entry is stored exactly as a `bn_` is in memory.
+// It is meant for caches that are read back by the same build of the same program;
+// a pool written on a machine with a different byte order or `size_t` is rejected rather than converted.
+//
+//   offset | size       | contents
+//   -------+------------+---------------------------------------------------------
+//        0 | 8          | magic `BLPOOL` followed by a zero byte and the format version
+//        8 | 4          | the `uint32_t` 0x01020304, in native byte order
+//       12 | 1          | `sizeof(size_t)`
+//       13 | 3          | zero padding
+//       16 | 8          | the number of entries, as a `uint64_t`
+//       24 | 8 × count  | the index: for each entry, the `uint64_t` offset of its `bn_`, with the low bit set if it is negative
+//      ... |            | the entries, each a `bn_` aligned to `BL__POOL_ALIGN`
+
+#include "core/bz_type.h"
+
+#define BL__POOL_VERSION 1
+#define BL__POOL_ALIGN 8
+#define BL__POOL_HEADER 24
+
+typedef struct bl__pool {
+  const uint8_t* base;
+  size_t size;
+  size_t count;
+} bl__pool;
+
+// Return the exact number of bytes needed to store the `n` entries as a pool.
+// Natural numbers can be stored as non-negative integers.
+size_t bl__sizeof_pool(const bz_* entries, size_t n);
+
+// Lay out a pool holding the `n` entries in `dst`, which should be aligned to `BL__POOL_ALIGN`.
+// Entries are stored normalized, whether or not their inputs are.
+// `BL_OVERFLOW` is returned if `dstLen` is less than `bl__sizeof_pool(entries, n)`,
+// in which case the contents of `dst` are undefined.
+bl_result bl__pool_write(uint8_t* dst, size_t dstLen, const bz_* entries, size_t n);
+
+// Check the header of a pool laid out in `src`, which must be aligned to `BL__POOL_ALIGN`, and fill in `pool`.
+// `BL_SYNTAX` is returned if the header is missing, was written by an incompatible machine, or its index does not fit.
+// The entries themselves are only checked as they are accessed, so opening takes constant time.
+bl_result bl__pool_open(bl__pool* pool, const uint8_t* src, size_t srcLen);
+
+// Return a pointer to the magnitude of entry `i`, which points into the pool's memory.
+// `NULL` is returned if `i` is out of range or the entry does not fit within the pool.
+const bn_* bl__pool_get(const bl__pool* pool, size_t i);
+
+// Return whether entry `i` is negative.
+// Out-of-range entries are not negative.
+bool bl__pool_isNeg(const bl__pool* pool, size_t i);
+
+
+#endif
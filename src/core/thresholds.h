@@ -0,0 +1,30 @@
+#ifndef BIGLIT_CORE_THRESHOLDS
+#define BIGLIT_CORE_THRESHOLDS
+
+// Crossover points between the algorithms of the core, in 64-bit words.
+// These are the defaults of `bn__get_thresholds`, which may be changed at runtime with `bn__set_thresholds`.
+//
+// `./BUILD.sh tune` measures them on the build machine and writes `build/tune/tuned_thresholds.h`;
+// while that file exists, the build defines `BL_TUNED` and compiles against it instead.
+// The values below are portable defaults, which are good on most 64-bit machines.
+
+#ifdef BL_TUNED
+#include "tuned_thresholds.h"
+#endif
+
+// Below this many words, operands are multiplied by schoolbook; above it, Karatsuba's three half-size products win.
+#ifndef BN__KARATSUBA_WORDS
+#define BN__KARATSUBA_WORDS 32
+#endif
+
+// Below this many words, numbers are converted a chunk of digits at a time; above it, by divide and conquer.
+#ifndef BN__RADIX_WORDS
+#define BN__RADIX_WORDS 32
+#endif
+
+// Below this many words, reciprocals are found a bit at a time; above it, by Newton's method.
+#ifndef BN__RECIP_WORDS
+#define BN__RECIP_WORDS 16
+#endif
+
+#endif
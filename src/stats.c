@@ -0,0 +1,106 @@
+#include "stats.h"
+
+#include <time.h>
+
+#ifdef BL_STATS
+
+// Every entry point adds its site to this list the first time it is called, and no site is ever removed.
+static _Atomic(bl__statSite*) sites = NULL;
+
+// The calls of instrumented functions this thread is in, innermost first.
+static _Thread_local bl__statFrame* frames = NULL;
+
+static uint64_t now(void) {
+  struct timespec t;
+  timespec_get(&t, TIME_UTC);
+  return (uint64_t)t.tv_sec * 1000000000 + t.tv_nsec;
+}
+
+void bl__stat_enter(bl__statFrame* frame, bl__statSite* site, uint64_t nDigits) {
+  if (!atomic_exchange_explicit(&site->registered, true, memory_order_relaxed)) {
+    site->next = atomic_load_explicit(&sites, memory_order_relaxed);
+    while (!atomic_compare_exchange_weak_explicit(&sites, &site->next, site, memory_order_release, memory_order_relaxed)) {}
+  }
+  atomic_fetch_add_explicit(&site->calls, 1, memory_order_relaxed);
+  atomic_fetch_add_explicit(&site->inputDigits, nDigits, memory_order_relaxed);
+  frame->site = site;
+  frame->prev = frames;
+  frame->outermost = true;
+  for (bl__statFrame* f = frames; f != NULL; f = f->prev) {
+    if (f->site == site) {
+      frame->outermost = false;
+      break;
+    }
+  }
+  frames = frame;
+  frame->start = frame->outermost ? now() : 0;
+}
+
+void bl__stat_exit(bl__statFrame* frame) {
+  if (frame->outermost) {
+    atomic_fetch_add_explicit(&frame->site->ns, now() - frame->start, memory_order_relaxed);
+  }
+  frames = frame->prev;
+}
+
+void bl__stat_alloc(size_t nBytes) {
+  for (bl__statFrame* f = frames; f != NULL; f = f->prev) {
+    if (!f->outermost) { continue; }
+    atomic_fetch_add_explicit(&f->site->allocs, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&f->site->allocBytes, nBytes, memory_order_relaxed);
+  }
+}
+
+size_t bl_statsSnapshot(bl_stat* dst, size_t cap) {
+  size_t n = 0;
+  for (bl__statSite* s = atomic_load_explicit(&sites, memory_order_acquire); s != NULL; s = s->next, ++n) {
+    if (n >= cap) { continue; }
+    dst[n] = (bl_stat){
+      .name = s->name,
+      .calls = atomic_load_explicit(&s->calls, memory_order_relaxed),
+      .inputDigits = atomic_load_explicit(&s->inputDigits, memory_order_relaxed),
+      .ns = atomic_load_explicit(&s->ns, memory_order_relaxed),
+      .allocs = atomic_load_explicit(&s->allocs, memory_order_relaxed),
+      .allocBytes = atomic_load_explicit(&s->allocBytes, memory_order_relaxed),
+    };
+  }
+  return n;
+}
+
+void bl_statsReset(void) {
+  for (bl__statSite* s = atomic_load_explicit(&sites, memory_order_acquire); s != NULL; s = s->next) {
+    atomic_store_explicit(&s->calls, 0, memory_order_relaxed);
+    atomic_store_explicit(&s->inputDigits, 0, memory_order_relaxed);
+    atomic_store_explicit(&s->ns, 0, memory_order_relaxed);
+    atomic_store_explicit(&s->allocs, 0, memory_order_relaxed);
+    atomic_store_explicit(&s->allocBytes, 0, memory_order_relaxed);
+  }
+}
+
+void bl_statsDump(FILE* out) {
+  fprintf(out, "%-28s %12s %14s %14s %12s %14s\n", "function", "calls", "inputDigits", "ns", "allocs", "allocBytes");
+  for (bl__statSite* s = atomic_load_explicit(&sites, memory_order_acquire); s != NULL; s = s->next) {
+    fprintf(out, "%-28s %12llu %14llu %14llu %12llu %14llu\n", s->name,
+      (unsigned long long)atomic_load_explicit(&s->calls, memory_order_relaxed),
+      (unsigned long long)atomic_load_explicit(&s->inputDigits, memory_order_relaxed),
+      (unsigned long long)atomic_load_explicit(&s->ns, memory_order_relaxed),
+      (unsigned long long)atomic_load_explicit(&s->allocs, memory_order_relaxed),
+      (unsigned long long)atomic_load_explicit(&s->allocBytes, memory_order_relaxed));
+  }
+}
+
+#else
+
+size_t bl_statsSnapshot(bl_stat* dst, size_t cap) {
+  (void)dst;
+  (void)cap;
+  return 0;
+}
+
+void bl_statsReset(void) {}
+
+void bl_statsDump(FILE* out) {
+  fprintf(out, "%-28s %12s %14s %14s %12s %14s\n", "function", "calls", "inputDigits", "ns", "allocs", "allocBytes");
+}
+
+#endif
@@ -0,0 +1,86 @@
+#ifndef BIGLIT_STATS
+#define BIGLIT_STATS
+
+// This header exposes counters of the work done by each entry point of the library (the `bn__*`, `bz__*`, `bn_*` and `bz_*` functions).
+// They are only kept when the whole library is built with `BL_STATS` defined (`BL_STATS=1 ./BUILD.sh`).
+// Otherwise, the instrumentation compiles to nothing, and there is never anything to report.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+typedef struct bl_stat {
+  const char* name;
+  uint64_t calls;
+  // Summed over all calls: the digits of every number passed in, and the length of every string or encoding passed in.
+  uint64_t inputDigits;
+  // Wall-clock time, including the time spent in the functions it calls.
+  // A call made while another call of the same function is still running (i.e. recursion) adds no time of its own.
+  uint64_t ns;
+  // Allocations made by the basic interface during calls, counted like the time.
+  uint64_t allocs;
+  uint64_t allocBytes;
+} bl_stat;
+
+// Copy the counters of up to `cap` entry points that have been called since the program started into `dst`.
+// Returns the number of such entry points, which may be more than `cap`.
+size_t bl_statsSnapshot(bl_stat* dst, size_t cap);
+
+// Zero every counter.
+void bl_statsReset(void);
+
+// Print every counter to `out`, one line per entry point that has been called.
+void bl_statsDump(FILE* out);
+
+////// Instrumentation //////
+
+// The remainder of this header is private to the library.
+// `BL_STAT(nDigits)` begins the body of every entry point, and `BL_STAT_ALLOC(nBytes)` precedes every allocation.
+// The timing relies on the `cleanup` attribute of GCC and Clang.
+
+#ifdef BL_STATS
+
+#ifndef __GNUC__
+#error "BL_STATS needs GCC or Clang"
+#endif
+
+#include <stdatomic.h>
+#include <stdbool.h>
+
+typedef struct bl__statSite {
+  const char* name;
+  _Atomic uint64_t calls;
+  _Atomic uint64_t inputDigits;
+  _Atomic uint64_t ns;
+  _Atomic uint64_t allocs;
+  _Atomic uint64_t allocBytes;
+  atomic_bool registered;
+  struct bl__statSite* next;
+} bl__statSite;
+
+typedef struct bl__statFrame {
+  bl__statSite* site;
+  struct bl__statFrame* prev;
+  bool outermost;
+  uint64_t start;
+} bl__statFrame;
+
+void bl__stat_enter(bl__statFrame* frame, bl__statSite* site, uint64_t nDigits);
+void bl__stat_exit(bl__statFrame* frame);
+void bl__stat_alloc(size_t nBytes);
+
+#define BL_STAT(nDigits) \
+  static bl__statSite bl__site = { .name = __func__ }; \
+  __attribute__((cleanup(bl__stat_exit))) bl__statFrame bl__frame; \
+  bl__stat_enter(&bl__frame, &bl__site, (nDigits))
+
+#define BL_STAT_ALLOC(nBytes) bl__stat_alloc(nBytes)
+
+#else
+
+#define BL_STAT(nDigits) ((void)0)
+#define BL_STAT_ALLOC(nBytes) ((void)0)
+
+#endif
+
+#endif
@@ -0,0 +1,100 @@
+#include <assert.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "basic/batch.h"
+
+void printbn(const bn_* src) {
+  if (src->len == 0) {
+    printf("0\n");
+  }
+  else {
+    for (size_t i = src->len; i > 0; --i) {
+      printf("%02X", src->base256le[i-1]);
+    }
+    printf("\n");
+  }
+}
+
+#define N 40
+
+int main() {
+  // lanes 0–15 are a block of one-word operands, 16–31 a block with one long operand, and 32–39 a short final block
+  bn* xs[N];
+  bn* ys[N];
+  for (size_t i = 0; i < N; ++i) {
+    xs[i] = bn_umax(i == 0 ? 0 : UINTMAX_MAX - i);
+    ys[i] = bn_umax(i * 0x01010101);
+  }
+  bn_free(xs[20]);
+  xs[20] = bn_shl(ys[3], 100);
+  bn_free(ys[35]);
+  ys[35] = bn_copy(xs[35]);
+  const bn* const* a = (const bn* const*)xs;
+  const bn* const* b = (const bn* const*)ys;
+
+  printf("=== bn_batchAdd ===\n"); {
+    bn* dst[N];
+    bn_batchAdd(dst, a, b, N);
+    for (size_t i = 0; i < N; ++i) {
+      bn* expect = bn_add(a[i], b[i]);
+      assert(bn_eq(dst[i], expect));
+      bn_free(expect);
+    }
+    printbn(dst[0]); printbn(dst[1]); printbn(dst[20]);
+    bn_batchFree(dst, N);
+  }
+
+  printf("=== bn_batchMul ===\n"); {
+    bn* dst[N];
+    bn_batchMul(dst, a, b, N);
+    for (size_t i = 0; i < N; ++i) {
+      bn* expect = bn_mul(a[i], b[i]);
+      assert(bn_eq(dst[i], expect));
+      bn_free(expect);
+    }
+    printbn(dst[0]); printbn(dst[1]); printbn(dst[20]);
+    bn_batchFree(dst, N);
+    bn_batchMul(dst, a, b, 0);
+    bn_batchFree(dst, 0);
+  }
+
+  printf("=== bn_batchCmp ===\n"); {
+    bl_ord dst[N];
+    bn_batchCmp(dst, a, b, N);
+    for (size_t i = 0; i < N; ++i) {
+      assert(dst[i] == bn_cmp(a[i], b[i]));
+      printf("%c", "<=>"[dst[i] + 1]);
+    }
+    printf("\n");
+  }
+
+  printf("=== bn_batchFits ===\n"); {
+    bool dst[N];
+    size_t widths[] = { 0, 8, 32, 64, 200 };
+    for (size_t w = 0; w < sizeof(widths) / sizeof(widths[0]); ++w) {
+      bn_batchFits(dst, b, N, widths[w]);
+      for (size_t i = 0; i < N; ++i) { printf("%d", dst[i]); }
+      printf("\n");
+    }
+  }
+
+  printf("=== bz_batchFits ===\n"); {
+    intmax_t vals[] = { 0, 127, 128, -128, -129, INTMAX_MAX, INTMAX_MIN };
+    size_t n = sizeof(vals) / sizeof(vals[0]);
+    bz zs[sizeof(vals) / sizeof(vals[0])];
+    for (size_t i = 0; i < n; ++i) { zs[i] = bz_imax(vals[i]); }
+    bool dst[sizeof(vals) / sizeof(vals[0])];
+    size_t widths[] = { 0, 8, 9, 64, 65 };
+    for (size_t w = 0; w < sizeof(widths) / sizeof(widths[0]); ++w) {
+      bz_batchFits(dst, zs, n, widths[w]);
+      for (size_t i = 0; i < n; ++i) { printf("%d", dst[i]); }
+      printf("\n");
+    }
+    for (size_t i = 0; i < n; ++i) { bz_free(zs[i]); }
+  }
+
+  for (size_t i = 0; i < N; ++i) { bn_free(xs[i]); bn_free(ys[i]); }
+  return 0;
+}
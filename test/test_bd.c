@@ -0,0 +1,120 @@
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "basic/bd.h"
+
+void printbn(const bn_* src) {
+  if (src->len == 0) { printf("0"); }
+  for (size_t i = src->len; i > 0; --i) {
+    printf("%02X", src->base256le[i-1]);
+  }
+  printf("\n");
+}
+
+void printbd(const bd* src) {
+  char buf[256];
+  size_t n = bd_print(buf, sizeof(buf), src);
+  assert(n != 0);
+  printf("%.*s\n", (int)n, buf);
+}
+
+bd* parse(const char* str) {
+  bd* out = bd_parse(str, strlen(str));
+  assert(out != NULL);
+  return out;
+}
+
+int main() {
+  printf("=== bd_parse ===\n"); {
+    const char* lits[] = { "0", "7", "42", "0000000000000000000123", "12345678", "123456789", "98765432109876543210987654321" };
+    for (size_t i = 0; i < sizeof(lits) / sizeof(lits[0]); ++i) {
+      bd* x = parse(lits[i]);
+      printf("%zu ", bd_nDigits(x)); printbd(x);
+      bd_free(x);
+    }
+    const char* bad[] = { "", "-1", "12a", "1234567:", "12345678/", "1 2" };
+    for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); ++i) {
+      assert(bd_parse(bad[i], strlen(bad[i])) == NULL);
+    }
+    bd* x = parse("1234");
+    char buf[4];
+    assert(bd_print(buf, 3, x) == 0);
+    assert(bd_print(buf, 4, x) == 4);
+    bd_free(x);
+  }
+
+  printf("=== bd_add ===\n"); {
+    const char* pairs[][2] = {
+      { "0", "0" },
+      { "5", "5" },
+      { "99999999999999999999999999999999", "1" }, // carries across words
+      { "9999999999999999", "9999999999999999" }, // carries out of the top of a word
+      { "1", "99999999999999999" },
+      { "12345678901234567890", "98765432109876543210" },
+    };
+    for (size_t i = 0; i < sizeof(pairs) / sizeof(pairs[0]); ++i) {
+      bd* a = parse(pairs[i][0]);
+      bd* b = parse(pairs[i][1]);
+      bd* c = bd_add(a, b); printbd(c);
+      bd_free(a); bd_free(b); bd_free(c);
+    }
+  }
+
+  printf("=== bd_sub ===\n"); {
+    const char* pairs[][2] = {
+      { "0", "0" },
+      { "10", "1" },
+      { "100000000000000000000000000000000", "1" }, // borrows across words
+      { "10000000000000000", "9999999999999999" },
+      { "98765432109876543210", "12345678901234567890" },
+      { "5", "6" }, // negative results are zero
+    };
+    for (size_t i = 0; i < sizeof(pairs) / sizeof(pairs[0]); ++i) {
+      bd* a = parse(pairs[i][0]);
+      bd* b = parse(pairs[i][1]);
+      bd* c = bd_sub(a, b); printbd(c);
+      bd_free(a); bd_free(b); bd_free(c);
+    }
+  }
+
+  printf("=== bd_cmp ===\n"); {
+    const char* lits[] = { "0", "9", "10", "99", "100", "1000000000000000000" };
+    size_t n = sizeof(lits) / sizeof(lits[0]);
+    for (size_t i = 0; i < n; ++i) {
+      bd* x = parse(lits[i]);
+      for (size_t j = 0; j < n; ++j) {
+        bd* y = parse(lits[j]);
+        printf("%c", "<=>"[bd_cmp(x, y) + 1]);
+        bd_free(y);
+      }
+      printf("\n");
+      bd_free(x);
+    }
+  }
+
+  printf("=== bd_toBn ===\n"); {
+    const char* lits[] = { "0", "255", "256", "18446744073709551615", "18446744073709551616", "340282366920938463463374607431768211455" };
+    for (size_t i = 0; i < sizeof(lits) / sizeof(lits[0]); ++i) {
+      bd* x = parse(lits[i]);
+      bn* y = bd_toBn(x); printbn(y);
+      bd* z = bd_fromBn(y); printbd(z);
+      bn_free(y); bd_free(x); bd_free(z);
+    }
+  }
+
+  printf("=== bd__add ===\n"); {
+    // the destination is too small for the carry, leaving it undefined
+    struct { size_t len; uint8_t bcdle[8]; } a = { 8, {0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99} };
+    struct { size_t len; uint8_t bcdle[1]; } b = { 1, {0x01} };
+    bl_result err = bd__add((bd_*)&a, (bd_*)&a, (bd_*)&b);
+    printf("%d\n", err);
+    // a negative difference
+    memset(a.bcdle, 0x99, 8);
+    err = bd__sub((bd_*)&a, (bd_*)&b, (bd_*)&a);
+    printf("%d\n", err);
+  }
+
+  return 0;
+}
@@ -4,6 +4,7 @@
 #include <stdlib.h>
 
 #include "core/bn.h"
+#include "core/bz_type.h"
 
 void printbn(bn_* src) {
   if (src->len == 0) {
@@ -17,6 +18,13 @@ void printbn(bn_* src) {
   }
 }
 
+void printbuf(const uint8_t* buf, size_t len) {
+  for (size_t i = 0; i < len; ++i) {
+    printf("%02X", buf[i]);
+  }
+  printf("\n");
+}
+
 int main() {
   bl_result err;
 
@@ -74,6 +82,16 @@ int main() {
     a->len = 128; bn__blank(a);
   }
 
+  printf("=== bn__ctz ===\n"); {
+    bn__umax(a, 0xf0);
+    printf("%zu", bn__ctz(a));
+    a->len = 128; bn__umax(a, 0x1000000);
+    printf(" %zu", bn__ctz(a));
+    a->len = 128; bn__umax(a, 0);
+    printf(" %zu\n", bn__ctz(a));
+    a->len = 128; bn__blank(a);
+  }
+
   printf("=== bn__wrbit ===\n"); {
     a->len = 32;
     err = bn__wrbit(a, 42, 1); printbn(a); assert(err == BL_OK);
@@ -128,6 +146,17 @@ int main() {
     bn__umax(b, 0xFFF0);
     c->len = bn__sizeof_add(a, b); bn__blank(c);
     err = bn__add(c, a, b); printbn(c); assert(err == BL_OK);
+    // the leading digits sum to 0xFF, so the digits below decide whether the sum carries out
+    a->len = b->len = 128;
+    bn__umax(a, 0x80FF);
+    bn__umax(b, 0x7F00);
+    c->len = bn__sizeof_add(a, b); bn__blank(c);
+    err = bn__add(c, a, b); printbn(c); assert(err == BL_OK);
+    a->len = b->len = 128;
+    bn__umax(a, 0x80FF);
+    bn__umax(b, 0x7F01);
+    c->len = bn__sizeof_add(a, b); bn__blank(c);
+    err = bn__add(c, a, b); printbn(c); assert(err == BL_OK);
     a->len = b->len = c->len = 128; bn__blank(a); bn__blank(b); bn__blank(c);
   }
 
@@ -171,6 +200,56 @@ int main() {
     a->len = b->len = c->len = 128; bn__blank(a); bn__blank(b); bn__blank(c);
   }
 
+  printf("=== bn__addmul_1 ===\n"); {
+    // a whole word and a tail, with a carry out of both
+    bn__umax(a, UINT64_MAX); a->base256le[8] = 0xFF; a->len = 9;
+    bn__umax(c, 1); c->len = bn__sizeof_addmul_1(c, a, UINT64_MAX);
+    err = bn__addmul_1(c, a, UINT64_MAX); printbn(c); assert(err == BL_OK);
+    // and back again, in place
+    err = bn__submul_1(c, a, UINT64_MAX); printbn(c); assert(err == BL_OK);
+    err = bn__submul_1(c, a, 1); assert(err == BL_OVERFLOW);
+    // a step of Horner's rule, `acc = acc * k + d`, accumulating in place
+    a->len = b->len = c->len = 128; bn__blank(a); bn__blank(c);
+    bn__umax(c, 0x123456789A); c->len = 16;
+    bn__umax(b, 7); b->len = 16;
+    err = bn__addmul_1(b, c, 1000); printbn(b); assert(err == BL_OK);
+    err = bn__addmul_1(c, c, 1); printbn(c); assert(err == BL_OK);
+    // the destination keeps its length, so a carry out of it overflows
+    bn__umax(c, 0xFF); c->len = 1;
+    bn__umax(a, 1);
+    err = bn__addmul_1(c, a, 1); assert(err == BL_OVERFLOW);
+    a->len = b->len = c->len = 128; bn__blank(a); bn__blank(b); bn__blank(c);
+  }
+
+  printf("=== bn__fma ===\n"); {
+    bn__umax(a, 0x123456789ABCDEF0); a->base256le[8] = 0x11; a->len = 9;
+    bn__umax(b, 0xFEDCBA9876543210); b->base256le[8] = 0x22; b->base256le[9] = 0x33; b->len = 10;
+    bn__umax(d, 0xFFFFFFFF);
+    c->len = bn__sizeof_fma(a, b, d);
+    err = bn__fma(c, a, b, d); printbn(c); assert(err == BL_OK);
+    // the same as a product and a sum
+    bn_* e = malloc(bn__sizeof(8 * 128)); e->len = bn__sizeof_mul(a, b); bn__blank(e);
+    err = bn__mul(e, a, b); assert(err == BL_OK);
+    err = bn__add(e, e, d); assert(err == BL_OK);
+    printf("%d\n", bn__cmp(c, e) == BL_EQ);
+    free(e);
+    // accumulating into `c` itself
+    c->len = 128;
+    err = bn__fma(c, a, b, c); bn__normalize(c); printbn(c); assert(err == BL_OK);
+    c->len = 128;
+    bn__umax(d, 5);
+    bn__umax(b, 0); c->len = bn__sizeof_fma(a, b, d);
+    err = bn__fma(c, a, b, d); printbn(c); assert(err == BL_OK);
+    // a zero addend cannot carry, so a bare product needs no more room than `bn__mul`
+    bn__umax(d, 0);
+    c->len = bn__sizeof_fma(a, a, d); printf("%d ", c->len == bn__sizeof_mul(a, a));
+    err = bn__fma(c, a, a, d); printbn(c); assert(err == BL_OK);
+    bn__umax(d, 5);
+    c->len = 1;
+    err = bn__fma(c, a, a, d); assert(err == BL_OVERFLOW);
+    a->len = b->len = c->len = d->len = 128; bn__blank(a); bn__blank(b); bn__blank(c); bn__blank(d);
+  }
+
   printf("=== bn__divmod ===\n"); {
     bn__umax(a, 0x137);
     bn__umax(b, 0x42);
@@ -184,6 +263,140 @@ int main() {
     d->len = bn__sizeof_mod(a, b); bn__blank(d);
     err = bn__divmod(c, d, a, b); printbn(c); printbn(d); assert(err == BL_OK);
     a->len = b->len = c->len = d->len = 128; bn__blank(a); bn__blank(b); bn__blank(c); bn__blank(d);
+    bn__umax(a, 0xFEFE);
+    bn__umax(b, 0xFF);
+    c->len = bn__sizeof_div(a, b); bn__blank(c);
+    d->len = bn__sizeof_mod(a, b); bn__blank(d);
+    err = bn__divmod(c, d, a, b); printbn(c); printbn(d); assert(err == BL_OK);
+    a->len = b->len = c->len = d->len = 128; bn__blank(a); bn__blank(b); bn__blank(c); bn__blank(d);
+  }
+
+  printf("=== bn__gcd ===\n"); {
+    bn_* scratch = malloc(bn__sizeof(8 * 1024));
+    bn__umax(a, 0x137 * 0x42);
+    bn__umax(b, 0x99 * 0x42);
+    c->len = bn__sizeof_gcd(a, b); bn__blank(c);
+    scratch->len = bn__sizeof_gcd_scratch(a, b);
+    err = bn__gcd(c, a, b, scratch); printbn(c); assert(err == BL_OK);
+    a->len = b->len = c->len = 128; bn__blank(a); bn__blank(b); bn__blank(c);
+    // gcd(2^120 - 1, 2^84 - 1) = 2^gcd(120, 84) - 1
+    a->len = 15; for (size_t i = 0; i < 15; ++i) { a->base256le[i] = 0xFF; }
+    b->len = 11; for (size_t i = 0; i < 11; ++i) { b->base256le[i] = 0xFF; }
+    b->base256le[10] = 0x0F;
+    c->len = bn__sizeof_gcd(a, b); bn__blank(c);
+    scratch->len = bn__sizeof_gcd_scratch(a, b);
+    err = bn__gcd(c, a, b, scratch); printbn(c); assert(err == BL_OK);
+    b->len = 0;
+    c->len = bn__sizeof_gcd(a, b); bn__blank(c);
+    scratch->len = bn__sizeof_gcd_scratch(a, b);
+    err = bn__gcd(c, a, b, scratch); printbn(c); assert(err == BL_OK);
+    scratch->len = 0;
+    err = bn__gcd(c, a, b, scratch); assert(err == BL_OVERFLOW);
+    a->len = b->len = c->len = 128; bn__blank(a); bn__blank(b); bn__blank(c);
+    free(scratch);
+  }
+
+  printf("=== bn__gcdext ===\n"); {
+    bn_* scratch = malloc(bn__sizeof(8 * 1024));
+    bz_ s = { false, malloc(bn__sizeof(8 * 128)) };
+    bz_ t = { false, malloc(bn__sizeof(8 * 128)) };
+    // 240·(-9) + 46·47 = 2
+    bn__umax(a, 240);
+    bn__umax(b, 46);
+    c->len = bn__sizeof_gcd(a, b);
+    s.magnitude->len = bn__sizeof_gcdext_s(a, b);
+    t.magnitude->len = bn__sizeof_gcdext_t(a, b);
+    scratch->len = bn__sizeof_gcdext_scratch(a, b);
+    err = bn__gcdext(c, &s, &t, a, b, scratch); assert(err == BL_OK);
+    printbn(c); printf("%s", s.isNeg ? "-" : "+"); printbn(s.magnitude); printf("%s", t.isNeg ? "-" : "+"); printbn(t.magnitude);
+    // consecutive Fibonacci numbers make the cofactors as large as they can be
+    a->len = b->len = 128;
+    bn__umax(a, UINT64_C(12200160415121876738)); // F(93)
+    bn__umax(b, UINT64_C(7540113804746346429)); // F(92)
+    c->len = bn__sizeof_gcd(a, b);
+    s.magnitude->len = bn__sizeof_gcdext_s(a, b);
+    t.magnitude->len = bn__sizeof_gcdext_t(a, b);
+    scratch->len = bn__sizeof_gcdext_scratch(a, b);
+    err = bn__gcdext(c, &s, &t, a, b, scratch); assert(err == BL_OK);
+    printbn(c); printf("%s", s.isNeg ? "-" : "+"); printbn(s.magnitude); printf("%s", t.isNeg ? "-" : "+"); printbn(t.magnitude);
+    // gcd(2^120 - 1, 2^84 - 1) = 2^12 - 1
+    a->len = 15; for (size_t i = 0; i < 15; ++i) { a->base256le[i] = 0xFF; }
+    b->len = 11; for (size_t i = 0; i < 11; ++i) { b->base256le[i] = 0xFF; }
+    b->base256le[10] = 0x0F;
+    c->len = bn__sizeof_gcd(a, b);
+    s.magnitude->len = bn__sizeof_gcdext_s(a, b);
+    t.magnitude->len = bn__sizeof_gcdext_t(a, b);
+    scratch->len = bn__sizeof_gcdext_scratch(a, b);
+    err = bn__gcdext(c, &s, &t, a, b, scratch); assert(err == BL_OK);
+    printbn(c); printf("%s", s.isNeg ? "-" : "+"); printbn(s.magnitude); printf("%s", t.isNeg ? "-" : "+"); printbn(t.magnitude);
+    // one operand divides the other, or is zero
+    bn__umax(a, 0);
+    err = bn__gcdext(c, &s, &t, a, b, scratch); assert(err == BL_OK);
+    printbn(c); printf("%s", s.isNeg ? "-" : "+"); printbn(s.magnitude); printf("%s", t.isNeg ? "-" : "+"); printbn(t.magnitude);
+    err = bn__gcdext(c, &s, &t, b, a, scratch); assert(err == BL_OK);
+    printbn(c); printf("%s", s.isNeg ? "-" : "+"); printbn(s.magnitude); printf("%s", t.isNeg ? "-" : "+"); printbn(t.magnitude);
+    scratch->len = 0;
+    err = bn__gcdext(c, &s, &t, b, a, scratch); assert(err == BL_OVERFLOW);
+    a->len = b->len = c->len = 128; bn__blank(a); bn__blank(b); bn__blank(c);
+    free(s.magnitude);
+    free(t.magnitude);
+    free(scratch);
+  }
+
+  printf("=== bn__divexact ===\n"); {
+    a->len = 15; for (size_t i = 0; i < 15; ++i) { a->base256le[i] = 0xFF; }
+    bn__umax(b, 0xFFF);
+    c->len = 15;
+    err = bn__divexact(c, a, b); printbn(c); assert(err == BL_OK);
+    bn__umax(b, 0xFFF0);
+    a->len = 16; a->base256le[15] = 0x00; bn__shl(a, 4);
+    err = bn__divexact(a, a, b); printbn(a); assert(err == BL_OK);
+    a->len = b->len = c->len = 128; bn__blank(a); bn__blank(b); bn__blank(c);
+  }
+
+  printf("=== bn__iroot ===\n"); {
+    bn_* scratch = malloc(bn__sizeof(8 * 1024));
+    // 10^20 = (10^10)^2, and one less than it is not a square
+    bn__umax(a, UINT64_C(10000000000));
+    b->len = 16; bn__blank(b);
+    bn__mul(b, a, a);
+    c->len = bn__sizeof_isqrt(b); d->len = bn__sizeof_isqrt_rem(b);
+    scratch->len = bn__sizeof_isqrt_scratch(b);
+    err = bn__isqrt(c, d, b, scratch); printbn(c); printbn(d); assert(err == BL_OK);
+    bn__dec(b, b);
+    c->len = bn__sizeof_isqrt(b); d->len = bn__sizeof_isqrt_rem(b);
+    err = bn__isqrt(c, d, b, scratch); printbn(c); printbn(d); assert(err == BL_OK);
+    // 2^120 - 1 under several roots
+    a->len = 15; for (size_t i = 0; i < 15; ++i) { a->base256le[i] = 0xFF; }
+    for (unsigned k = 1; k <= 7; k += 2) {
+      c->len = bn__sizeof_iroot(a, k); d->len = bn__sizeof_iroot_rem(a, k);
+      scratch->len = bn__sizeof_iroot_scratch(a, k);
+      err = bn__iroot(c, d, a, k, scratch); printbn(c); printbn(d); assert(err == BL_OK);
+    }
+    // roots larger than the number of bits are one
+    c->len = bn__sizeof_iroot(a, 200);
+    scratch->len = bn__sizeof_iroot_scratch(a, 200);
+    err = bn__iroot(c, NULL, a, 200, scratch); printbn(c); assert(err == BL_OK);
+    // even when the root is far larger than the number, as neither is the power computed one factor at a time
+    a->len = 8; bn__umax(a, 10);
+    c->len = bn__sizeof_iroot(a, 10000000); d->len = bn__sizeof_iroot_rem(a, 10000000);
+    scratch->len = bn__sizeof_iroot_scratch(a, 10000000);
+    err = bn__iroot(c, d, a, 10000000, scratch); printbn(c); printbn(d); assert(err == BL_OK);
+    // 3^40, and one less, either side of a root of 3
+    a->len = 8; bn__umax(a, UINT64_C(12157665459056928801));
+    c->len = bn__sizeof_iroot(a, 40); d->len = bn__sizeof_iroot_rem(a, 40);
+    scratch->len = bn__sizeof_iroot_scratch(a, 40);
+    err = bn__iroot(c, d, a, 40, scratch); printbn(c); printbn(d); assert(err == BL_OK);
+    bn__dec(a, a);
+    err = bn__iroot(c, d, a, 40, scratch); printbn(c); printbn(d); assert(err == BL_OK);
+    bn__umax(a, 0);
+    c->len = 4;
+    err = bn__iroot(c, NULL, a, 3, scratch); printbn(c); assert(err == BL_OK);
+    err = bn__iroot(c, NULL, a, 0, scratch); assert(err == BL_DIVZERO);
+    scratch->len = 0;
+    err = bn__iroot(c, NULL, a, 3, scratch); assert(err == BL_OVERFLOW);
+    a->len = b->len = c->len = d->len = 128; bn__blank(a); bn__blank(b); bn__blank(c); bn__blank(d);
+    free(scratch);
   }
 
   printf("=== bn__and ===\n"); {
@@ -224,6 +437,138 @@ int main() {
     a->len = b->len = 128; bn__blank(a); bn__blank(b);
   }
 
+  printf("=== bn__leb128 ===\n"); {
+    uint8_t buf[160];
+    size_t n, nRead;
+    bn__umax(a, 0); n = bn__sizeof_leb128(a);
+    err = bn__leb128_encode(buf, sizeof(buf), a); printbuf(buf, n); assert(err == BL_OK);
+    a->len = 128; bn__umax(a, 624485); n = bn__sizeof_leb128(a);
+    err = bn__leb128_encode(buf, sizeof(buf), a); printbuf(buf, n); assert(err == BL_OK);
+    err = bn__leb128_encode(buf, n - 1, a); assert(err == BL_OVERFLOW);
+    b->len = bn__sizeof_leb128_decode(buf, n); printf("%zu ", b->len);
+    err = bn__leb128_decode(b, &nRead, buf, n); assert(err == BL_OK); printf("%zu ", nRead); printbn(b);
+    a->len = 128; bn__umax(a, UINT64_MAX); n = bn__sizeof_leb128(a);
+    err = bn__leb128_encode(buf, sizeof(buf), a); printbuf(buf, n); assert(err == BL_OK);
+    b->len = bn__sizeof_leb128_decode(buf, n); printf("%zu ", b->len);
+    err = bn__leb128_decode(b, &nRead, buf, n); assert(err == BL_OK); printf("%zu ", nRead); printbn(b);
+    // a number spanning several 56-bit chunks round-trips
+    a->len = 20;
+    for (size_t i = 0; i < a->len; ++i) { a->base256le[i] = 0x11 * (i % 15 + 1); }
+    n = bn__sizeof_leb128(a); printf("%zu ", n);
+    err = bn__leb128_encode(buf, sizeof(buf), a); assert(err == BL_OK);
+    b->len = bn__sizeof_leb128_decode(buf, sizeof(buf));
+    err = bn__leb128_decode(b, &nRead, buf, sizeof(buf)); assert(err == BL_OK);
+    printf("%zu %d\n", nRead, bn__cmp(a, b));
+    // redundant zero groups, truncation and overflow
+    buf[0] = 0x85; buf[1] = 0x80; buf[2] = 0x00;
+    b->len = bn__sizeof_leb128_decode(buf, 3); printf("%zu ", b->len);
+    err = bn__leb128_decode(b, &nRead, buf, 3); assert(err == BL_OK); printf("%zu ", nRead); printbn(b);
+    err = bn__leb128_decode(b, &nRead, buf, 2); assert(err == BL_SYNTAX);
+    printf("%zu\n", bn__sizeof_leb128_decode(buf, 2));
+    buf[0] = 0x80; buf[1] = 0x80; buf[2] = 0x04; b->len = 2;
+    err = bn__leb128_decode(b, &nRead, buf, 3); assert(err == BL_OVERFLOW);
+    a->len = b->len = 128; bn__blank(a); bn__blank(b);
+  }
+
+  printf("=== bn__vlq ===\n"); {
+    uint8_t buf[160];
+    size_t n, nRead;
+    bn__umax(a, 0x7F); n = bn__sizeof_leb128(a);
+    err = bn__vlq_encode(buf, sizeof(buf), a); printbuf(buf, n); assert(err == BL_OK);
+    a->len = 128; bn__umax(a, 0x4000); n = bn__sizeof_leb128(a);
+    err = bn__vlq_encode(buf, sizeof(buf), a); printbuf(buf, n); assert(err == BL_OK);
+    a->len = 128; bn__umax(a, 0x0FFFFFFF); n = bn__sizeof_leb128(a);
+    err = bn__vlq_encode(buf, sizeof(buf), a); printbuf(buf, n); assert(err == BL_OK);
+    b->len = bn__sizeof_vlq_decode(buf, n); printf("%zu ", b->len);
+    err = bn__vlq_decode(b, &nRead, buf, n); assert(err == BL_OK); printf("%zu ", nRead); printbn(b);
+    a->len = 20;
+    for (size_t i = 0; i < a->len; ++i) { a->base256le[i] = 0x11 * (i % 15 + 1); }
+    err = bn__vlq_encode(buf, sizeof(buf), a); assert(err == BL_OK);
+    b->len = bn__sizeof_vlq_decode(buf, sizeof(buf));
+    err = bn__vlq_decode(b, &nRead, buf, sizeof(buf)); assert(err == BL_OK);
+    printf("%zu %d\n", nRead, bn__cmp(a, b));
+    a->len = b->len = 128; bn__blank(a); bn__blank(b);
+  }
+
+  printf("=== bn__parser ===\n"); {
+    bn__parser p;
+    bn__parser_init(&p, 10);
+    err = bn__parser_feed(&p, a, "6244", 4); assert(err == BL_OK);
+    err = bn__parser_feed(&p, a, "85", 2); assert(err == BL_OK);
+    err = bn__parser_finish(&p, a); assert(err == BL_OK); printbn(a);
+    a->len = 128;
+    bn__parser_init(&p, 16);
+    err = bn__parser_feed(&p, a, "00DEADbeef", 10); assert(err == BL_OK);
+    err = bn__parser_finish(&p, a); assert(err == BL_OK); printbn(a);
+    a->len = 128;
+    // 2^128 spans several chunks
+    bn__parser_init(&p, 10);
+    printf("%zu ", bn__sizeof_parser(&p, 39));
+    err = bn__parser_feed(&p, a, "340282366920938463463374607431768211456", 39); assert(err == BL_OK);
+    err = bn__parser_finish(&p, a); assert(err == BL_OK); printbn(a);
+    a->len = 128;
+    bn__parser_init(&p, 2);
+    err = bn__parser_feed(&p, a, "0", 1); assert(err == BL_OK);
+    err = bn__parser_finish(&p, a); assert(err == BL_OK); printbn(a);
+    a->len = 128;
+    bn__parser_init(&p, 8);
+    err = bn__parser_feed(&p, a, "178", 3); assert(err == BL_SYNTAX);
+    bn__parser_init(&p, 8);
+    err = bn__parser_finish(&p, a); assert(err == BL_SYNTAX);
+    bn__parser_init(&p, 10);
+    a->len = 1;
+    err = bn__parser_feed(&p, a, "1000", 4); assert(err == BL_OVERFLOW);
+    a->len = 128; bn__blank(a);
+  }
+
+  printf("=== bn__kernels ===\n"); {
+    printf("%s %d\n", bn__kernels_name(0), bn__set_kernels("bogus"));
+    const char* chosen = bn__get_kernels();
+    // every implementation the CPU supports must agree with the portable one, whatever the lengths and carries
+    size_t nBad = 0;
+    uint64_t seed = 1;
+    bn_* want = malloc(bn__sizeof(8 * 300));
+    bn_* got = malloc(bn__sizeof(8 * 300));
+    assert(want != NULL && got != NULL);
+    for (size_t k = 1; bn__kernels_name(k) != NULL; ++k) {
+      if (!bn__set_kernels(bn__kernels_name(k))) { continue; }
+      for (size_t trial = 0; trial < 2000; ++trial) {
+        a->len = trial % 128; b->len = (trial / 7) % 128;
+        for (size_t i = 0; i < 128; ++i) {
+          seed = seed * UINT64_C(6364136223846793005) + UINT64_C(1442695040888963407);
+          // mostly all-ones digits, so carries and borrows run a long way
+          a->base256le[i] = (seed >> 60) < 12 ? 0xFF : seed >> 40;
+          b->base256le[i] = (seed >> 56 & 0xF) < 12 ? 0xFF : seed >> 32;
+        }
+        for (int op = 0; op < 6; ++op) {
+          bl_result wantErr = BL_OK, gotErr = BL_OK;
+          size_t count[2] = { 0, 0 };
+          for (int pass = 0; pass < 2; ++pass) {
+            bn__set_kernels(pass == 0 ? "portable" : bn__kernels_name(k));
+            bn_* dst = pass == 0 ? want : got;
+            bl_result* err = pass == 0 ? &wantErr : &gotErr;
+            dst->len = 130; bn__blank(dst);
+            switch (op) {
+              case 0: *err = bn__add(dst, a, b); break;
+              case 1: *err = bn__sub(dst, a, b); break;
+              case 2: bn__and(dst, a, b); break;
+              case 3: bn__or(dst, a, b); break;
+              case 4: bn__xor(dst, a, b); break;
+              case 5: count[pass] = bn__popcount(a); break;
+            }
+          }
+          if (wantErr != gotErr || count[0] != count[1] || bn__cmp(want, got) != BL_EQ) { ++nBad; }
+        }
+      }
+    }
+    printf("%zu mismatches\n", nBad);
+    bn__set_kernels(chosen);
+    free(want); free(got);
+    a->len = b->len = 128; bn__blank(a); bn__blank(b);
+    bn__umax(a, 0xF0F0); printf("%zu\n", bn__popcount(a));
+    a->len = 128; bn__blank(a);
+  }
+
   // done
   free(a); free(b); free(c); free(d);
   return 0;
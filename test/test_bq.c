@@ -0,0 +1,121 @@
+#include <assert.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "basic/bq.h"
+
+void printbn(const bn_* src) {
+  if (src->len == 0) {
+    printf("0");
+  }
+  else {
+    for (size_t i = src->len; i > 0; --i) {
+      printf("%02X", src->base256le[i-1]);
+    }
+  }
+}
+
+void printbz(bz src) {
+  if (src.isNeg) { printf("-"); }
+  printbn(src.magnitude);
+}
+
+// Print the fraction as it is stored, which need not be in lowest terms.
+void printbq(bq src) {
+  printbz(src.num);
+  printf("/");
+  printbn(src.den);
+  printf("\n");
+}
+
+bq mk(intmax_t num, uintmax_t den) {
+  bz n = bz_imax(num);
+  bn* d = bn_umax(den);
+  bq out = bq_ratio(n, d);
+  bz_free(n);
+  bn_free(d);
+  return out;
+}
+
+int main() {
+  bq a, b, c;
+
+  printf("=== bq_ratio ===\n"); {
+    a = mk(6, 4); printbq(a); bq_free(a);
+    a = mk(-0x137, 1); printbq(a); bq_free(a);
+    a = mk(0, 5); printbq(a); bq_free(a);
+  }
+
+  printf("=== bq_reduce ===\n"); {
+    a = mk(6, 4);
+    b = bq_reduce(a); printbq(b); bq_free(b);
+    bq_free(a);
+    a = mk(-0x1000, 0x30);
+    b = bq_reduce(a); printbq(b); bq_free(b);
+    bq_free(a);
+    a = mk(0, 5);
+    b = bq_reduce(a); printbq(b); bq_free(b);
+    bq_free(a);
+    a = mk(INTMAX_MAX, INTMAX_MAX);
+    b = bq_reduce(a); printbq(b); bq_free(b);
+    bq_free(a);
+  }
+
+  printf("=== bq_num, bq_den ===\n"); {
+    a = mk(-10, 4);
+    bz n = bq_num(a); printbz(n); printf("\n"); bz_free(n);
+    bn* d = bq_den(a); printbn(d); printf("\n"); bn_free(d);
+    bq_free(a);
+  }
+
+  printf("=== bq_cmp ===\n"); {
+    bq xs[6];
+    xs[0] = mk(-3, 2);
+    xs[1] = mk(-2, 4);
+    xs[2] = mk(0, 7);
+    xs[3] = mk(1, 3);
+    xs[4] = mk(2, 6);
+    xs[5] = mk(5, 2);
+    for (int i = 0; i < 6; ++i) {
+      for (int j = 0; j < 6; ++j) {
+        printf("%c", "<=>"[bq_cmp(xs[i], xs[j]) + 1]);
+      }
+      printf("\n");
+    }
+    for (int i = 0; i < 6; ++i) { bq_free(xs[i]); }
+  }
+
+  printf("=== bq_add ===\n"); {
+    a = mk(1, 6); b = mk(1, 3);
+    c = bq_add(a, b); printbq(c); bq_free(c);
+    c = bq_sub(a, b); printbq(c); bq_free(c);
+    c = bq_sub(a, a); printbq(c); bq_free(c);
+    bq_free(a); bq_free(b);
+  }
+
+  printf("=== bq_mul ===\n"); {
+    a = mk(-2, 3); b = mk(9, 4);
+    c = bq_mul(a, b); printbq(c); bq_free(c);
+    c = bq_div(a, b); printbq(c); bq_free(c);
+    c = bq_div(b, a); printbq(c); bq_free(c);
+    c = bq_neg(a); printbq(c); bq_free(c);
+    bq_free(a); bq_free(b);
+  }
+
+  printf("=== lazy reduction ===\n"); {
+    // the sum of 1/(k(k+1)) telescopes to n/(n+1), but stays unreduced until it grows large
+    a = mk(0, 1);
+    for (uintmax_t k = 1; k <= 200; ++k) {
+      b = mk(1, k * (k + 1));
+      c = bq_add(a, b);
+      bq_free(a); bq_free(b);
+      a = c;
+      if (k == 4 || k == 40 || k == 200) { printbq(a); }
+    }
+    b = bq_reduce(a); printbq(b); bq_free(b);
+    bq_free(a);
+  }
+
+  return 0;
+}
@@ -0,0 +1,191 @@
+#include <assert.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "basic/br.h"
+#include "core/br.h"
+
+void printbn(const bn_* src) {
+  if (src->len == 0) { printf("0"); }
+  for (size_t i = src->len; i > 0; --i) {
+    printf("%02X", src->base256le[i-1]);
+  }
+}
+
+void printbz(bz src) {
+  if (src.isNeg) { printf("-"); }
+  printbn(src.magnitude);
+}
+
+void printbr(br src) {
+  if (src.significand == NULL) { printf("invalid\n"); return; }
+  printf("%s", src.isNeg ? "-" : "+");
+  switch (src.kind) {
+    case BR_FINITE: {
+      printbn(src.significand);
+      printf(" × 2^"); printbz(src.exp2);
+      printf(" × 5^"); printbz(src.exp5);
+    } break;
+    case BR_INFINITE: printf("inf"); break;
+    case BR_NAN: printf("nan"); break;
+  }
+  printf("\n");
+}
+
+void printbuf(const uint8_t* buf, size_t len) {
+  for (size_t i = len; i > 0; --i) {
+    printf("%02X", buf[i - 1]);
+  }
+}
+
+// Print the encodings of `str` rounded to `fmt` under each rounding mode, most-significant byte first.
+void printRounded(const char* str, br_format fmt) {
+  br x = br_parseDecimal(str, strlen(str));
+  br_rounding modes[] = { BR_NEAREST_EVEN, BR_NEAREST_AWAY, BR_TOWARD_ZERO, BR_TOWARD_POSITIVE, BR_TOWARD_NEGATIVE };
+  for (size_t i = 0; i < sizeof(modes) / sizeof(modes[0]); ++i) {
+    uint8_t buf[16];
+    br_round(buf, x, fmt, modes[i]);
+    printf(i == 0 ? "" : " ");
+    printbuf(buf, br__sizeof_format(fmt));
+  }
+  printf("\n");
+  br_free(x);
+}
+
+// Print the encodings of the double and float nearest to `digits × 10^q`.
+void printDecimal(const char* digits, intmax_t q) {
+  bn* w = bn_parse(digits, strlen(digits), 10);
+  assert(w != NULL);
+  double d = br_decimalToDouble(w, q);
+  float f = br_decimalToFloat(w, q);
+  uint64_t dBits; memcpy(&dBits, &d, sizeof(d));
+  uint32_t fBits; memcpy(&fBits, &f, sizeof(f));
+  printf("%016" PRIX64 " %08" PRIX32 "\n", dBits, fBits);
+  bn_free(w);
+}
+
+int main() {
+  printf("=== br_decimalToDouble ===\n"); {
+    printDecimal("0", 0);
+    printDecimal("0", 400);
+    printDecimal("1", 0);
+    printDecimal("1", -1); // 0.1
+    printDecimal("15", -1); // 1.5
+    printDecimal("1", 23); // 1e23, a hard case for naive conversion
+    printDecimal("9007199254740993", 0); // 2^53 + 1: ties to even
+    printDecimal("9007199254740995", 0); // 2^53 + 3: ties to even
+    printDecimal("17976931348623157", 292); // DBL_MAX
+    printDecimal("17976931348623159", 292); // rounds to infinity
+    printDecimal("1", 309);
+    printDecimal("22250738585072014", -324); // DBL_MIN
+    printDecimal("49406564584124654", -340); // smallest subnormal
+    printDecimal("24703282292062327", -340); // half the smallest subnormal: ties to zero
+    printDecimal("24703282292062328", -340); // just over half: rounds up
+    printDecimal("1", -400);
+    printDecimal("340282356779733661637539395458142568448", 0); // FLT_MAX + half an ulp: ties away from the odd FLT_MAX, to infinity
+    printDecimal("14012984643248171", -61); // smallest float subnormal
+  }
+
+  printf("=== long significands ===\n"); {
+    // 2^53 + 1 with extra digits: exactly halfway, then just above it
+    printDecimal("90071992547409930000000000", -10);
+    printDecimal("90071992547409930000000001", -10);
+    // the binary64 halfway point between 1 and its successor, to many digits
+    printDecimal("10000000000000001110223024625156540423631668090820312500", -55);
+    printDecimal("10000000000000001110223024625156540423631668090820312501", -55);
+    // an exact tie far below the table
+    printDecimal("24703282292062327208828439643411068618252990130716238221279284125033775363510437593264991818081799618989828234772285886546332835517796989819938739800539093906315035659515570226392290858392449105184435931802849936536152500319370457678249219365623669863658480757001585769269903706311928279558551332927834338409351978015531246597263579574622766465272827220056374006485499977096599470454020828166226237857393450736339007967761930577506740176324673600968951340535537458516661134223766678604162159680461914467291840300530057530849048765391711386591646239524912623653881879636239373280423891018672348497668235089863388587925628302755995657524455507255189313690836254779186948667994968324049705821028513185451396213837722826145437693412532098591327667236328125", -1075);
+  }
+
+  printf("=== br__sizeof_decimal_scratch ===\n"); {
+    struct { size_t len; uint8_t base256le[13]; } w = { 13, {0x00, 0x00, 0x00, 0x40, 0xEA, 0xED, 0x74, 0x46, 0xD0, 0x9C, 0x2C, 0x9F, 0x0C} }; // 10^30
+    uint64_t bits;
+    printf("%zu\n", br__sizeof_decimal_scratch((bn_*)&w, -20));
+    printf("%zu\n", br__sizeof_decimal_scratch((bn_*)&w, -400));
+    printf("%zu\n", br__sizeof_decimal_scratch((bn_*)&w, -345));
+    bl_result err = br__decimal_binary64(&bits, (bn_*)&w, -345, NULL);
+    printf("%d\n", err);
+    bn_* scratch = malloc(sizeof(bn_) + br__sizeof_decimal_scratch((bn_*)&w, -345));
+    scratch->len = br__sizeof_decimal_scratch((bn_*)&w, -345);
+    err = br__decimal_binary64(&bits, (bn_*)&w, -345, scratch);
+    printf("%d %016" PRIX64 "\n", err, bits);
+    free(scratch);
+  }
+
+  printf("=== br_parseDecimal ===\n"); {
+    const char* lits[] = { "0", "-0.0", "1", "12.5", "-0.1", ".5e1", "1e300", "8E-3", "+InF", "-nan", "1.", "", "-", ".", "1e", "1x", "e5", "infinite" };
+    for (size_t i = 0; i < sizeof(lits) / sizeof(lits[0]); ++i) {
+      br x = br_parseDecimal(lits[i], strlen(lits[i]));
+      printbr(x);
+      if (x.significand != NULL) { br_free(x); }
+    }
+  }
+
+  printf("=== br_binary ===\n"); {
+    bn* w = bn_umax(0x180);
+    bz e = bz_imax(-12);
+    br x = br_binary(true, w, e); printbr(x); br_free(x);
+    bz_free(e);
+    bn_free(w);
+  }
+
+  printf("=== br_cmp ===\n"); {
+    const char* lits[] = { "-inf", "-1e400", "-0.1", "-0", "0", "1e-400", "0.1", "0.10000000000000000001", "0.125", "1.25e-1", "1e400", "inf" };
+    size_t n = sizeof(lits) / sizeof(lits[0]);
+    for (size_t i = 0; i < n; ++i) {
+      br x = br_parseDecimal(lits[i], strlen(lits[i]));
+      for (size_t j = 0; j < n; ++j) {
+        br y = br_parseDecimal(lits[j], strlen(lits[j]));
+        printf("%c", "<=>"[br_cmp(x, y) + 1]);
+        br_free(y);
+      }
+      printf("\n");
+      br_free(x);
+    }
+    // exponents too large to scale by, which must be settled by their sizes or their difference alone
+    const char* pairs[][2] = { { "1e2199023255553", "1e2199023255554" }, { "1e100000000", "0.5" }, { "-1e-100000000", "-0.5" }, { "3e1099511627776", "2e1099511627776" } };
+    for (size_t i = 0; i < sizeof(pairs) / sizeof(pairs[0]); ++i) {
+      br x = br_parseDecimal(pairs[i][0], strlen(pairs[i][0]));
+      br y = br_parseDecimal(pairs[i][1], strlen(pairs[i][1]));
+      printf("%s %c %s\n", pairs[i][0], "<=>"[br_cmp(x, y) + 1], pairs[i][1]);
+      br_free(y);
+      br_free(x);
+    }
+  }
+
+  printf("=== br_round ===\n"); {
+    // nearest-even, nearest-away, toward zero, toward +∞, toward -∞
+    printRounded("0.1", BR_BINARY16);
+    printRounded("-0.1", BR_BINARY16);
+    printRounded("2049", BR_BINARY16); // a tie
+    printRounded("2051", BR_BINARY16); // a tie
+    printRounded("65520", BR_BINARY16); // a tie with infinity
+    printRounded("-1e6", BR_BINARY16);
+    printRounded("6e-8", BR_BINARY16); // near the smallest subnormal
+    printRounded("1e-400", BR_BINARY16);
+    printRounded("-0", BR_BINARY16);
+    printRounded("nan", BR_BINARY16);
+    printRounded("-inf", BR_BINARY16);
+    printRounded("0.1", BR_BINARY32);
+    printRounded("0.1", BR_BINARY64);
+    printRounded("0.1", BR_BINARY128);
+    printRounded("-1e4933", BR_BINARY128);
+    printRounded("1e-4966", BR_BINARY128);
+    printRounded("1e2199023255553", BR_BINARY64);
+    printRounded("-1e-2199023255553", BR_BINARY64);
+  }
+
+  printf("=== br_toDouble ===\n"); {
+    br x = br_parseDecimal("1e23", 4);
+    double d = br_toDouble(x, BR_NEAREST_EVEN);
+    float f = br_toFloat(x, BR_TOWARD_ZERO);
+    uint64_t dBits; memcpy(&dBits, &d, sizeof(d));
+    uint32_t fBits; memcpy(&fBits, &f, sizeof(f));
+    printf("%016" PRIX64 " %08" PRIX32 "\n", dBits, fBits);
+    br_free(x);
+  }
+
+  return 0;
+}
@@ -2,6 +2,7 @@
 #include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "basic/bz.h"
 
@@ -22,6 +23,77 @@ void printbz(bz src) {
   printbn(src.magnitude);
 }
 
+// Assert that `x` equals `expect`, then free it.
+void checkbz(bz x, intmax_t expect) {
+  bz e = bz_imax(expect);
+  assert(bz_eq(x, e));
+  bz_free(e); bz_free(x);
+}
+
+void printbuf(const uint8_t* buf, size_t len) {
+  for (size_t i = 0; i < len; ++i) {
+    printf("%02X", buf[i]);
+  }
+  printf("\n");
+}
+
+// An allocator which prefixes every block with its size, and counts what it hands out.
+typedef struct counting {
+  size_t live;
+  size_t allocs;
+  size_t reallocs;
+  size_t frees;
+  size_t unclassed;
+} counting;
+
+#define HEADER 16
+
+void* countingAlloc(void* ctx, size_t nBytes) {
+  counting* c = ctx;
+  c->live += 1;
+  c->allocs += 1;
+  if (nBytes % 16 != 0) { c->unclassed += 1; }
+  uint8_t* block = malloc(HEADER + nBytes);
+  memcpy(block, &nBytes, sizeof(nBytes));
+  return block + HEADER;
+}
+
+void* countingRealloc(void* ctx, void* ptr, size_t nBytes) {
+  counting* c = ctx;
+  c->reallocs += 1;
+  if (nBytes % 16 != 0) { c->unclassed += 1; }
+  uint8_t* block = realloc((uint8_t*)ptr - HEADER, HEADER + nBytes);
+  memcpy(block, &nBytes, sizeof(nBytes));
+  return block + HEADER;
+}
+
+void countingFree(void* ctx, void* ptr) {
+  counting* c = ctx;
+  c->live -= 1;
+  c->frees += 1;
+  free((uint8_t*)ptr - HEADER);
+}
+
+// Exercise most kinds of allocation the basic interfaces make.
+void allocateSome(void) {
+  bn* x = bn_parse("123456789012345678901234567890", 30, 10);
+  bn_parser* p = bn_parser_init(10);
+  for (int i = 0; i < 20; ++i) { bn_parser_feed(p, "9876543210", 10); }
+  bn* y = bn_parser_finish(p);
+  bn* z = bn_mul(x, y);
+  struct bn_divmod qr = bn_divmod(z, x);
+  struct bn_gcdext g = bn_gcdext(x, y);
+  bz a = bz_negative(x);
+  bz b = bz_mulWrap(a, g.s, 100);
+  bz d = bz_positive(y);
+  struct bz_divmod e = bz_divmod(a, d);
+  char buf[128];
+  bn_format(buf, sizeof(buf), z, 7);
+  bn_free(x); bn_free(y); bn_free(z); bn_free(qr.div); bn_free(qr.mod);
+  bn_free(g.gcd); bz_free(g.s); bz_free(g.t);
+  bz_free(a); bz_free(b); bz_free(d); bz_free(e.div); bz_free(e.mod);
+}
+
 int main() {
   bz a, b, c;
 
@@ -135,6 +207,17 @@ int main() {
     b = bz_imax(-2);
     r = bz_divmod(a, b); printbz(r.div); printbz(r.mod); bz_free(r.div); bz_free(r.mod);
     bz_free(a); bz_free(b);
+
+    // a negative dividend smaller than the divisor still rounds the quotient down to a negative number
+    intmax_t ns[] = { -1, -3, -4 }, ds[] = { 2, 4, 2 };
+    for (size_t i = 0; i < 3; ++i) {
+      a = bz_imax(ns[i]);
+      b = bz_imax(ds[i]);
+      r = bz_divmod(a, b); printbz(r.div); printbz(r.mod); bz_free(r.div); bz_free(r.mod);
+      bz q = bz_div(a, b), m = bz_mod(a, b);
+      printbz(q); printbz(m); bz_free(q); bz_free(m);
+      bz_free(a); bz_free(b);
+    }
   }
 
   printf("=== bz_inc ===\n"); {
@@ -161,5 +244,329 @@ int main() {
     bz_free(a);
   }
 
+  printf("=== bz_bitwise ===\n"); {
+    intmax_t xs[] = { 0, 12, -12, -256, INTMAX_MIN };
+    size_t n = sizeof(xs) / sizeof(xs[0]);
+    for (size_t i = 0; i < n; ++i) {
+      a = bz_imax(xs[i]);
+      for (size_t j = 0; j < n; ++j) {
+        b = bz_imax(xs[j]);
+        checkbz(bz_and(a, b), xs[i] & xs[j]);
+        checkbz(bz_or(a, b), xs[i] | xs[j]);
+        checkbz(bz_xor(a, b), xs[i] ^ xs[j]);
+        bz_free(b);
+      }
+      c = bz_not(a); printbz(c); bz_free(c);
+      bz_free(a);
+    }
+    a = bz_imax(-1); b = bz_shl(a, 70);
+    c = bz_xor(b, a); printbz(c); bz_free(c);
+    bz_free(a); a = bz_imax(0x1234);
+    c = bz_and(b, a); printbz(c); bz_free(c);
+    printf("%d%d%d\n", bz_bit(b, 69), bz_bit(b, 70), bz_bit(b, 1000));
+    bz_free(a); bz_free(b);
+  }
+
+  printf("=== bz_shr ===\n"); {
+    intmax_t xs[] = { 0, 7, -7, -8, -9, INTMAX_MIN };
+    for (size_t i = 0; i < sizeof(xs) / sizeof(xs[0]); ++i) {
+      a = bz_imax(xs[i]);
+      c = bz_shr(a, 3); printbz(c); bz_free(c);
+      c = bz_shr(a, 200); printbz(c); bz_free(c);
+      bz_free(a);
+    }
+    a = bz_imax(-5); c = bz_shl(a, 9); printbz(c); bz_free(c); bz_free(a);
+  }
+
+  printf("=== bz_twosComplement ===\n"); {
+    uint8_t buf[16];
+    intmax_t xs[] = { 0, 127, 128, -128, -129, -32768, INTMAX_MIN };
+    for (size_t i = 0; i < sizeof(xs) / sizeof(xs[0]); ++i) {
+      a = bz_imax(xs[i]);
+      size_t n = bz_sizeofTwosComplement(a);
+      bool ok = bz_toTwosComplement(buf, 3, a);
+      printf("%zu %d ", n, ok); printbuf(buf, 3);
+      b = bz_fromTwosComplement(buf, 3);
+      assert(!ok || bz_eq(a, b));
+      bz_free(a); bz_free(b);
+    }
+    a = bz_imax(-129);
+    assert(!bz_toTwosComplement(buf, 1, a));
+    b = bz_fromTwosComplement(buf, 1); printbz(b); bz_free(b);
+    bz_free(a);
+  }
+
+  printf("=== bn_wrap ===\n"); {
+    bn* x = bn_umax(UINT64_C(0xFFFFFFFF));
+    bn* y = bn_umax(UINT64_C(0x12345678));
+    bn* z = bn_addWrap(x, y, 32); printbn(z); bn_free(z);
+    z = bn_subWrap(y, x, 32); printbn(z); bn_free(z);
+    z = bn_mulWrap(x, y, 32); printbn(z); bn_free(z);
+    z = bn_mulWrap(x, y, 12); printbn(z); bn_free(z);
+    z = bn_mulWrap(x, y, 128); printbn(z); bn_free(z);
+    z = bn_wrap(y, 0); printbn(z); bn_free(z);
+    bn_free(x); bn_free(y);
+  }
+
+  printf("=== bn_fma ===\n"); {
+    // Horner's rule over the digits of a literal agrees with the parser
+    const char* digits = "3141592653589793238462643383279502884197169399375105820974944592";
+    bn* acc = bn_umax(0);
+    for (const char* p = digits; *p != '\0'; ++p) {
+      bn* d = bn_umax(*p - '0');
+      bn* next = bn_addMul1(d, acc, 10);
+      bn_free(d); bn_free(acc);
+      acc = next;
+    }
+    bn* parsed = bn_parse(digits, strlen(digits), 10);
+    printf("%d ", bn_eq(acc, parsed)); printbn(acc);
+    // subtracting too much gives zero
+    bn* back = bn_subMul1(acc, parsed, 1);
+    bn* under = bn_subMul1(parsed, acc, 2);
+    printf("%d ", bn_eq(under, back)); printbn(back);
+    bn_free(back); bn_free(under); bn_free(parsed);
+    // short operands by rows, long ones (past the Karatsuba threshold) by a product and a sum
+    bn* three = bn_umax(3);
+    bn* big = bn_umax(1);
+    for (int i = 0; i < 2000; ++i) { bn* y = bn_mul(big, three); bn_free(big); big = y; }
+    bn* xs[] = { acc, three, big };
+    for (size_t i = 0; i < 3; ++i) {
+      for (size_t j = 0; j < 3; ++j) {
+        bn* f = bn_fma(xs[i], xs[j], acc);
+        bn* prod = bn_mul(xs[i], xs[j]);
+        bn* sum = bn_add(prod, acc);
+        printf("%d", bn_eq(f, sum));
+        bn_free(f); bn_free(prod); bn_free(sum);
+      }
+    }
+    bn* zero = bn_umax(0);
+    bn* f = bn_fma(zero, big, three); printf(" "); printbn(f);
+    bn_free(f); bn_free(zero); bn_free(three); bn_free(big); bn_free(acc);
+  }
+
+  printf("=== bz_wrap ===\n"); {
+    a = bz_imax(INT64_MAX); b = bz_imax(1);
+    c = bz_addWrap(a, b, 64); printbz(c); bz_free(c);
+    c = bz_mulWrap(a, a, 64); printbz(c); bz_free(c);
+    c = bz_subWrap(b, a, 8); printbz(c); bz_free(c);
+    bz_free(a); bz_free(b);
+    a = bz_imax(-200);
+    c = bz_wrap(a, 8); printbz(c); bz_free(c);
+    bn* z = bz_wrapUnsigned(a, 16); printbn(z); bn_free(z);
+    bz_free(a);
+  }
+
+  printf("=== bz_sleb128 ===\n"); {
+    uint8_t buf[32];
+    size_t n, nRead;
+    intmax_t xs[] = { 0, 2, -2, 63, 64, -64, -65, 127, -128, -123456, INTMAX_MAX, INTMAX_MIN };
+    for (size_t i = 0; i < sizeof(xs) / sizeof(xs[0]); ++i) {
+      a = bz_imax(xs[i]);
+      n = bz_toSleb128(buf, sizeof(buf), a); assert(n == bz_sizeofSleb128(a));
+      printbuf(buf, n);
+      b = bz_fromSleb128(buf, n, &nRead); assert(nRead == n);
+      assert(bz_eq(a, b));
+      bz_free(a); bz_free(b);
+    }
+    a = bz_imax(-0x80);
+    assert(bz_toSleb128(buf, 1, a) == 0);
+    bz_free(a);
+    buf[0] = 0xFF; buf[1] = 0xFF;
+    b = bz_fromSleb128(buf, 2, NULL); assert(b.magnitude == NULL);
+    buf[2] = 0x7F;
+    b = bz_fromSleb128(buf, 3, &nRead); printf("%zu ", nRead); printbz(b); bz_free(b);
+  }
+
+  printf("=== bn_leb128 ===\n"); {
+    uint8_t buf[32];
+    size_t n, nRead;
+    bn* x = bn_umax(0xdeadbeef);
+    n = bn_toLeb128(buf, sizeof(buf), x); printbuf(buf, n);
+    bn* y = bn_fromLeb128(buf, n, &nRead); printf("%zu ", nRead); printbn(y); bn_free(y);
+    n = bn_toVlq(buf, sizeof(buf), x); printbuf(buf, n);
+    y = bn_fromVlq(buf, n, &nRead); printf("%zu ", nRead); printbn(y); bn_free(y);
+    assert(bn_toVlq(buf, 2, x) == 0);
+    assert(bn_fromVlq(buf, 2, NULL) == NULL);
+    bn_free(x);
+  }
+
+  printf("=== bn_parse ===\n"); {
+    const char* text = "123456789012345678901234567890123456789012345678901234567890";
+    bn* x = bn_parse(text, 60, 10); printbn(x);
+    // feeding in uneven pieces gives the same result
+    bn_parser* p = bn_parser_init(10);
+    for (size_t at = 0, step = 1; at < 60; at += step, ++step) {
+      bool ok = bn_parser_feed(p, &text[at], step < 60 - at ? step : 60 - at); assert(ok);
+    }
+    bn* y = bn_parser_finish(p);
+    printf("%d\n", bn_cmp(x, y));
+    bn_free(x); bn_free(y);
+    x = bn_parse("zz", 2, 36); printbn(x); bn_free(x);
+    assert(bn_parse("", 0, 10) == NULL);
+    assert(bn_parse("12a", 3, 10) == NULL);
+    p = bn_parser_init(16);
+    assert(bn_parser_feed(p, "ff", 2));
+    assert(!bn_parser_feed(p, "fg", 2));
+    assert(!bn_parser_feed(p, "ff", 2));
+    assert(bn_parser_finish(p) == NULL);
+  }
+
+  printf("=== bn_format ===\n"); {
+    char buf[8192];
+    bn* x = bn_umax(0);
+    size_t n = bn_format(buf, sizeof(buf), x, 10); printf("%.*s\n", (int)n, buf); bn_free(x);
+    x = bn_umax(UINTMAX_MAX);
+    unsigned radices[] = {2, 3, 10, 16, 36};
+    for (size_t i = 0; i < 5; ++i) {
+      n = bn_format(buf, sizeof(buf), x, radices[i]); printf("%.*s\n", (int)n, buf);
+    }
+    assert(bn_format(buf, bn_sizeofFormat(x, 10) - 1, x, 10) == 0);
+    bn_free(x);
+    // long enough to be split at powers of the radix
+    x = bn_umax(1);
+    bn* three = bn_umax(3);
+    for (int i = 0; i < 5000; ++i) { bn* y = bn_mul(x, three); bn_free(x); x = y; }
+    n = bn_format(buf, sizeof(buf), x, 10);
+    printf("3^5000 = %.20s…%.20s (%zu digits)\n", buf, &buf[n - 20], n);
+    bn* y = bn_parse(buf, n, 10);
+    printf("%d\n", bn_eq(x, y)); bn_free(y);
+    n = bn_format(buf, sizeof(buf), x, 7);
+    printf("3^5000 = %.20s…%.20s (%zu digits, radix 7)\n", buf, &buf[n - 20], n);
+    y = bn_parse(buf, n, 7);
+    printf("%d\n", bn_eq(x, y)); bn_free(y);
+    n = bn_format(buf, sizeof(buf), x, 16);
+    // letters of either case are accepted
+    for (size_t i = 0; i < n; i += 3) {
+      if ('a' <= buf[i] && buf[i] <= 'f') { buf[i] += 'A' - 'a'; }
+    }
+    y = bn_parse(buf, n, 16);
+    printf("%d\n", bn_eq(x, y)); bn_free(y);
+    buf[n / 2] = 'g';
+    assert(bn_parse(buf, n, 16) == NULL);
+    bn_free(x); bn_free(three);
+    memset(buf, '9', 2000);
+    x = bn_parse(buf, 2000, 10);
+    n = bn_format(buf, sizeof(buf), x, 10);
+    buf[n] = '\0';
+    printf("%zu nines: %d\n", n, strspn(buf, "9") == 2000);
+    bn_free(x);
+  }
+
+  printf("=== bn_setThresholds ===\n"); {
+    printf("%d %d %d\n", bn_setThresholds(NULL), bn_setThresholds(""), bn_setThresholds("radix=32"));
+    printf("%d %d %d %d\n", bn_setThresholds("bogus=3"), bn_setThresholds("radix"), bn_setThresholds("radix=x"), bn_setThresholds("recip=3;"));
+    // results do not depend on the thresholds, even the smallest
+    static char buf[8192], tiny[8192];
+    bn* x = bn_umax(1);
+    bn* three = bn_umax(3);
+    for (int i = 0; i < 3000; ++i) { bn* y = bn_mul(x, three); bn_free(x); x = y; }
+    bn* sq = bn_mul(x, x);
+    size_t n = bn_format(buf, sizeof(buf), x, 10);
+    printf("%d\n", bn_setThresholds("karatsuba=1,radix=1,recip=1"));
+    bn* sqTiny = bn_mul(x, x);
+    size_t nTiny = bn_format(tiny, sizeof(tiny), x, 10);
+    bn* y = bn_parse(tiny, nTiny, 10);
+    printf("%d %d %d\n", bn_eq(sq, sqTiny), n == nTiny && memcmp(buf, tiny, n) == 0, bn_eq(x, y));
+    printf("%d\n", bn_setThresholds("karatsuba=0,radix=0,recip=0"));
+    // nor even the largest, which take no more room for small numbers; a value out of range is malformed
+    printf("%d %d\n", bn_setThresholds("radix=99999999999999999999999"), bn_setThresholds("karatsuba=100000000000,radix=100000000000,recip=100000000000"));
+    char digits[8];
+    bn* small = bn_umax(12345);
+    size_t nSmall = bn_format(digits, sizeof(digits), small, 10);
+    printf("%.*s\n", (int)nSmall, digits);
+    bn* sqHuge = bn_mul(x, x);
+    nTiny = bn_format(tiny, sizeof(tiny), x, 10);
+    bn* z = bn_parse(tiny, nTiny, 10);
+    printf("%d %d %d\n", bn_eq(sq, sqHuge), n == nTiny && memcmp(buf, tiny, n) == 0, bn_eq(x, z));
+    printf("%d\n", bn_setThresholds("karatsuba=0,radix=0,recip=0"));
+    bn_free(x); bn_free(y); bn_free(z); bn_free(three); bn_free(sq); bn_free(sqTiny); bn_free(sqHuge); bn_free(small);
+  }
+
+  printf("=== bn_setAllocator ===\n"); {
+    counting c = { 0 };
+    bn_setAllocator(countingAlloc, countingRealloc, countingFree, &c);
+    allocateSome();
+    printf("live %zu, unclassed %zu, every allocation freed %d, resized %d\n", c.live, c.unclassed, c.allocs == c.frees, c.reallocs > 0);
+    // without `realloc`, resizing allocates, copies and frees
+    c = (counting){ 0 };
+    bn_setAllocator(countingAlloc, NULL, countingFree, &c);
+    allocateSome();
+    printf("live %zu, unclassed %zu, every allocation freed %d, resized %d\n", c.live, c.unclassed, c.allocs == c.frees, c.reallocs > 0);
+    bn_setAllocator(NULL, NULL, NULL, NULL);
+    c = (counting){ 0 };
+    allocateSome();
+    printf("system allocator restored %d\n", c.allocs == 0);
+  }
+
+  printf("=== bn_releaseFreelists ===\n"); {
+    bn* x = bn_umax(1000);
+    bn* y = bn_umax(2000);
+    // small blocks are reused, most recently released first
+    uintptr_t was = (uintptr_t)x;
+    bn_free(x);
+    bn* z = bn_add(y, y);
+    printf("reused %d\n", (uintptr_t)z == was);
+    // every zero result with no spare room is the same object, and freeing it does nothing
+    bn* zero = bn_umax(0);
+    bn* a = bn_mul(y, zero);
+    bn* b = bn_lcm(zero, y);
+    printf("shared zero %d %d, ", a == zero, b == zero);
+    bn_free(a); bn_free(b); bn_free(zero);
+    printbn(zero);
+    bn_free(y); bn_free(z);
+    bn_releaseFreelists();
+    y = bn_umax(3000);
+    printf("after release %s\n", bn_nBytes(y) == 2 ? "ok" : "broken");
+    bn_free(y);
+  }
+
+  printf("=== bn_gcd ===\n"); {
+    bn* x = bn_umax(0x137 * 0x42);
+    bn* y = bn_umax(0x99 * 0x42);
+    bn* z = bn_gcd(x, y); printbn(z); bn_free(z);
+    z = bn_lcm(x, y); printbn(z); bn_free(z);
+    bn* zero = bn_umax(0);
+    z = bn_gcd(zero, zero); printbn(z); bn_free(z);
+    z = bn_lcm(x, zero); printbn(z); bn_free(z);
+    bn_free(zero); bn_free(x); bn_free(y);
+  }
+
+  printf("=== bn_gcdext ===\n"); {
+    bn* x = bn_umax(240);
+    bn* y = bn_umax(46);
+    struct bn_gcdext r = bn_gcdext(x, y);
+    printbn(r.gcd); printbz(r.s); printbz(r.t);
+    bn_free(r.gcd); bz_free(r.s); bz_free(r.t);
+    r = bn_gcdext(y, x);
+    printbn(r.gcd); printbz(r.s); printbz(r.t);
+    bn_free(r.gcd); bz_free(r.s); bz_free(r.t);
+    bn_free(x); bn_free(y);
+  }
+
+  printf("=== bn_modinv ===\n"); {
+    bn* m = bn_umax(1000000007);
+    bn* x = bn_umax(2);
+    bn* z = bn_modinv(x, m); printbn(z); bn_free(z);
+    bn_free(x);
+    // reduced modulo `m` first
+    x = bn_umax(UINT64_C(1000000007) * 3 + 10);
+    z = bn_modinv(x, m); printbn(z); bn_free(z);
+    bn_free(x); bn_free(m);
+    m = bn_umax(12);
+    x = bn_umax(8);
+    assert(bn_modinv(x, m) == NULL);
+    bn_free(x); bn_free(m);
+  }
+
+  printf("=== bn_isqrt ===\n"); {
+    bn* x = bn_umax(UINT64_C(99999999999999999));
+    bn* z = bn_isqrt(x); printbn(z); bn_free(z);
+    z = bn_iroot(x, 3); printbn(z); bn_free(z);
+    struct bn_rootrem r = bn_rootrem(x, 2);
+    printbn(r.root); printbn(r.rem);
+    bn_free(r.root); bn_free(r.rem);
+    bn_free(x);
+  }
+
   return 0;
 }
\ No newline at end of file
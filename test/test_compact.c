@@ -0,0 +1,103 @@
+#include <assert.h>
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "basic/compact.h"
+
+void printbn(const bn_* src) {
+  if (src->len == 0) {
+    printf("0\n");
+  }
+  else {
+    for (size_t i = src->len; i > 0; --i) {
+      printf("%02X", src->base256le[i-1]);
+    }
+    printf("\n");
+  }
+}
+
+void printbz(bz src) {
+  if (src.isNeg) { printf("-"); }
+  printbn(src.magnitude);
+}
+
+int main() {
+  printf("=== bl_compact ===\n"); {
+    printf("%zu\n", sizeof(bl_compact));
+    bl_compact zero;
+    memset(&zero, 0, sizeof(zero));
+    bl_compactView buf;
+    printf("%d ", bl_compactIsOutOfLine(zero)); printbz(bl_compactBz(zero, &buf));
+  }
+
+  printf("=== bl_compactFromBz ===\n"); {
+    intmax_t values[] = { 0, 1, -1, 0x137, -(intmax_t)0xdeadbeef, INTMAX_MIN };
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); ++i) {
+      bz x = bz_imax(values[i]);
+      bl_compact c = bl_compactFromBz(x);
+      bl_compactView buf;
+      bz y = bl_compactBz(c, &buf);
+      printf("%d %zu ", bl_compactIsOutOfLine(c), y.magnitude->len); printbz(y);
+      assert(bz_eq(x, y));
+      bz_free(x);
+      bl_compactFree(c);
+    }
+  }
+
+  printf("=== bl_compactFromBz (out-of-line) ===\n"); {
+    // 2^119 is the largest power of two held inline, and 2^120 the smallest held out-of-line
+    bn* one = bn_umax(1);
+    for (size_t shift = 119; shift <= 121; ++shift) {
+      bn* power = bn_shl(one, shift);
+      bz x = bz_negative(power);
+      bn_free(power);
+      bl_compact c = bl_compactFromBz(x);
+      bl_compactView buf;
+      bz y = bl_compactBz(c, &buf);
+      printf("%d %d %zu ", bl_compactIsOutOfLine(c), bl_compactIsNeg(c), y.magnitude->len); printbz(y);
+      assert(bz_eq(x, y));
+      bz_free(x);
+      bl_compactFree(c);
+    }
+    bn_free(one);
+  }
+
+  printf("=== bl_compactFromBn ===\n"); {
+    // an unnormalized magnitude is stored normalized, so equal handles have equal bytes
+    bn_buffer* wide = bn_new(32, NULL);
+    bn_writeByte(wide, 0, 0x42);
+    bn* narrow = bn_umax(0x42);
+    bl_compact a = bl_compactFromBn(wide);
+    bl_compact b = bl_compactFromBn(narrow);
+    printf("%d %d\n", bl_compactIsOutOfLine(a), memcmp(&a, &b, sizeof(bl_compact)) == 0);
+    bn_free(wide);
+    bn_free(narrow);
+    // a negative zero is stored as zero
+    bz negZero = { .isNeg = true, .magnitude = bn_umax(0) };
+    bl_compact c = bl_compactFromBz(negZero);
+    printf("%d\n", bl_compactIsNeg(c));
+    bz_free(negZero);
+  }
+
+  printf("=== arithmetic through views ===\n"); {
+    bz x = bz_imax(INTMAX_MAX), y = bz_imax(-3);
+    bl_compact a = bl_compactFromBz(x);
+    bl_compact b = bl_compactFromBz(y);
+    bz_free(x); bz_free(y);
+    bl_compactView bufA, bufB;
+    bz product = bz_mul(bl_compactBz(a, &bufA), bl_compactBz(b, &bufB));
+    bl_compact c = bl_compactFromBz(product);
+    bz_free(product);
+    bl_compactView bufC;
+    printf("%d ", bl_compactIsOutOfLine(c)); printbz(bl_compactBz(c, &bufC));
+    bn* square = bn_mul(bl_compactBn(c, &bufC), bl_compactBn(c, &bufC));
+    bl_compact d = bl_compactFromBn(square);
+    bn_free(square);
+    bl_compactView bufD;
+    printf("%d ", bl_compactIsOutOfLine(d)); printbn(bl_compactBn(d, &bufD));
+    bl_compactFree(a); bl_compactFree(b); bl_compactFree(c); bl_compactFree(d);
+  }
+
+  return 0;
+}
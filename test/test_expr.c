@@ -0,0 +1,296 @@
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "basic/expr.h"
+#include "core/expr.h"
+
+void printbn(const bn_* src) {
+  if (src->len == 0) {
+    printf("0\n");
+  }
+  else {
+    for (size_t i = src->len; i > 0; --i) {
+      printf("%02X", src->base256le[i-1]);
+    }
+    printf("\n");
+  }
+}
+
+void printbz(bz src) {
+  if (src.isNeg) { printf("-"); }
+  printbn(src.magnitude);
+}
+
+bz parse(const char* str) {
+  bool isNeg = str[0] == '-';
+  bn* magnitude = bn_parse(str + isNeg, strlen(str + isNeg), 10);
+  bz out = isNeg ? bz_negative(magnitude) : bz_positive(magnitude);
+  bn_free(magnitude);
+  return out;
+}
+
+// Evaluate `a op b` both as an expression and with the `bz_` function, and print the result if they agree.
+void check(bz (*op)(bz, bz), size_t (*node)(bl_expr*, size_t, size_t), bz a, bz b) {
+  bl_expr* e = bl_exprNew();
+  size_t root = node(e, bl_exprLeaf(e, a), bl_exprLeaf(e, b));
+  bz got = bl_exprEval(e, root);
+  bz want = op(a, b);
+  printf("%s ", bz_eq(got, want) ? "ok" : "MISMATCH"); printbz(got);
+  bz_free(got);
+  bz_free(want);
+  bl_exprFree(e);
+}
+
+// A small deterministic generator, so that the random expressions are the same on every run.
+static uint64_t state = 0x2545F4914F6CDD1D;
+uint64_t next(void) {
+  state ^= state << 13;
+  state ^= state >> 7;
+  state ^= state << 17;
+  return state;
+}
+
+int main() {
+  printf("=== bl_exprEval ===\n"); {
+    // (a*b + c) % d << 3, as it might appear in source
+    bz a = parse("123456789012345678901234567890");
+    bz b = parse("-98765432109876543210");
+    bz c = parse("55555555555555555555555555555555555");
+    bz d = parse("1000000007");
+    bl_expr* e = bl_exprNew();
+    size_t la = bl_exprLeaf(e, a), lb = bl_exprLeaf(e, b), lc = bl_exprLeaf(e, c), ld = bl_exprLeaf(e, d);
+    size_t prod = bl_exprMul(e, la, lb);
+    size_t sum = bl_exprAdd(e, prod, lc);
+    size_t root = bl_exprShl(e, bl_exprMod(e, sum, ld), 3);
+    bz got = bl_exprEval(e, root);
+    printbz(got);
+    bz p = bz_mul(a, b), s = bz_add(p, c), m = bz_mod(s, d), want = bz_shl(m, 3);
+    printf("%d\n", bz_eq(got, want));
+    // intermediate nodes may be evaluated as roots as well
+    bz atSum = bl_exprEval(e, sum);
+    printf("%d ", bz_eq(atSum, s)); printbz(atSum);
+    bz leaf = bl_exprEval(e, lb);
+    printf("%d %d\n", bz_eq(leaf, b), leaf.magnitude != b.magnitude);
+    bz_free(got); bz_free(want); bz_free(p); bz_free(s); bz_free(m); bz_free(atSum); bz_free(leaf);
+    bl_exprFree(e);
+    bz_free(a); bz_free(b); bz_free(c); bz_free(d);
+  }
+
+  printf("=== bl_exprDiv/bl_exprMod ===\n"); {
+    // Euclidean for every combination of signs, with and without a remainder
+    intmax_t ns[] = { 7, -7, 6, -6, 0 };
+    intmax_t ds[] = { 2, -2, 1, -1 };
+    for (size_t i = 0; i < sizeof(ns) / sizeof(ns[0]); ++i) {
+      for (size_t j = 0; j < sizeof(ds) / sizeof(ds[0]); ++j) {
+        bz n = bz_imax(ns[i]), d = bz_imax(ds[j]);
+        printf("%jd %jd: ", ns[i], ds[j]);
+        check(bz_div, bl_exprDiv, n, d);
+        printf("  ");
+        check(bz_mod, bl_exprMod, n, d);
+        bz_free(n); bz_free(d);
+      }
+    }
+    // a quotient that carries into a new digit when rounded away from zero
+    bz n = parse("-18446744073709551615"), d = bz_imax(-1), d2 = parse("18446744073709551616");
+    check(bz_div, bl_exprDiv, n, d);
+    check(bz_mod, bl_exprMod, n, d2);
+    check(bz_div, bl_exprDiv, n, d2);
+    bz_free(n); bz_free(d); bz_free(d2);
+  }
+
+  printf("=== fused products ===\n"); {
+    // `x*y ± c` and `c ± x*y`, over signs that agree and differ, and zero
+    intmax_t xs[] = { 300, -300, 0 };
+    intmax_t cs[] = { 90000, -90000, 89999, 0 };
+    size_t nOk = 0, nAll = 0;
+    for (size_t i = 0; i < 3; ++i) {
+      for (size_t j = 0; j < 3; ++j) {
+        for (size_t k = 0; k < 4; ++k) {
+          for (int shape = 0; shape < 4; ++shape) {
+            bz x = bz_imax(xs[i]), y = bz_imax(xs[j]), c = bz_imax(cs[k]);
+            bl_expr* e = bl_exprNew();
+            size_t lx = bl_exprLeaf(e, x), ly = bl_exprLeaf(e, y), lc = bl_exprLeaf(e, c);
+            size_t prod = bl_exprMul(e, lx, ly);
+            bool isSub = shape & 1, prodFirst = shape & 2;
+            size_t root = isSub ? (prodFirst ? bl_exprSub(e, prod, lc) : bl_exprSub(e, lc, prod))
+                                : (prodFirst ? bl_exprAdd(e, prod, lc) : bl_exprAdd(e, lc, prod));
+            bz got = bl_exprEval(e, root);
+            bz p = bz_mul(x, y);
+            bz want = isSub ? (prodFirst ? bz_sub(p, c) : bz_sub(c, p)) : (prodFirst ? bz_add(p, c) : bz_add(c, p));
+            nOk += bz_eq(got, want) && !(got.isNeg && got.magnitude->len == 0);
+            nAll += 1;
+            bz_free(got); bz_free(want); bz_free(p);
+            bl_exprFree(e);
+            bz_free(x); bz_free(y); bz_free(c);
+          }
+        }
+      }
+    }
+    printf("%zu/%zu\n", nOk, nAll);
+  }
+
+  printf("=== bl_exprNot/bl_exprShr/bitwise ===\n"); {
+    bz a = parse("-1234567890123456789012345"), b = parse("987654321987654321");
+    check(bz_and, bl_exprAnd, a, b);
+    check(bz_or, bl_exprOr, a, b);
+    check(bz_xor, bl_exprXor, a, b);
+    bl_expr* e = bl_exprNew();
+    size_t la = bl_exprLeaf(e, a);
+    size_t shr = bl_exprShr(e, la, 70), not = bl_exprNot(e, la), neg = bl_exprNeg(e, la);
+    bz got = bl_exprEval(e, shr), want = bz_shr(a, 70);
+    printf("%d ", bz_eq(got, want)); printbz(got);
+    bz_free(got); bz_free(want);
+    got = bl_exprEval(e, not); want = bz_not(a);
+    printf("%d ", bz_eq(got, want)); printbz(got);
+    bz_free(got); bz_free(want);
+    got = bl_exprEval(e, neg);
+    printbz(got);
+    bz_free(got);
+    bl_exprFree(e);
+    bz_free(a); bz_free(b);
+  }
+
+  printf("=== bl__expr_plan ===\n"); {
+    bz a = parse("340282366920938463463374607431768211455"), b = parse("-18446744073709551617");
+    // (a + b) * (a + b) shares the sum; the square is not fused, since it is the result
+    bl__exprNode shared[] = {
+      { .op = BL__EXPR_LEAF, .leaf = a },
+      { .op = BL__EXPR_LEAF, .leaf = b },
+      { .op = BL__EXPR_ADD, .a = 0, .b = 1 },
+      { .op = BL__EXPR_MUL, .a = 2, .b = 2 },
+    };
+    bl__exprStep steps[64];
+    size_t arenaLen;
+    bl_result err = bl__expr_plan(steps, &arenaLen, shared, 4);
+    printf("%d %zu %zu %d\n", err, steps[2].uses, steps[2].lastUse, steps[3].fusedInto == SIZE_MAX);
+    _Alignas(bn_) uint8_t arena[4096];
+    bz_ got;
+    err = bl__expr_eval(&got, steps, shared, 4, arena, arenaLen);
+    bz s = bz_add(a, b), want = bz_mul(s, s);
+    printf("%d %d\n", err, bz_eq(got, want));
+    bz_free(s); bz_free(want);
+    // a dead node is neither planned nor evaluated, even if it would divide by zero
+    bz zero = bz_imax(0);
+    bl__exprNode dead[] = {
+      { .op = BL__EXPR_LEAF, .leaf = a },
+      { .op = BL__EXPR_LEAF, .leaf = zero },
+      { .op = BL__EXPR_DIV, .a = 0, .b = 1 },
+      { .op = BL__EXPR_NEG, .a = 0 },
+    };
+    err = bl__expr_plan(steps, &arenaLen, dead, 4);
+    printf("%d %d %zu\n", err, steps[2].live, arenaLen);
+    err = bl__expr_eval(&got, steps, dead, 4, arena, arenaLen);
+    printf("%d ", err); printbz(got);
+    err = bl__expr_plan(steps, &arenaLen, dead, 3);
+    printf("%d ", err);
+    got.magnitude = NULL;
+    err = bl__expr_eval(&got, steps, dead, 3, arena, arenaLen);
+    printf("%d %d\n", err, got.magnitude == NULL);
+    // a chain of sums reuses the buffers of the sums before it, so the arena does not grow with the chain
+    bl__exprNode chain[64] = { { .op = BL__EXPR_LEAF, .leaf = a }, { .op = BL__EXPR_LEAF, .leaf = b } };
+    size_t lens[3];
+    size_t ns[] = { 4, 16, 64 };
+    for (size_t i = 0; i < 3; ++i) {
+      for (size_t j = 2; j < ns[i]; ++j) {
+        chain[j] = (bl__exprNode){ .op = j % 3 == 0 ? BL__EXPR_SUB : BL__EXPR_ADD, .a = j - 1, .b = j % 2 };
+      }
+      err = bl__expr_plan(steps, &arenaLen, chain, ns[i]);
+      assert(err == BL_OK);
+      lens[i] = arenaLen;
+    }
+    printf("%zu %zu %zu\n", lens[0], lens[1], lens[2]);
+    err = bl__expr_eval(&got, steps, chain, 64, arena, arenaLen);
+    bz acc = bz_copy(b);
+    for (size_t j = 2; j < 64; ++j) {
+      bz x = j % 2 ? b : a;
+      bz next = j % 3 == 0 ? bz_sub(acc, x) : bz_add(acc, x);
+      bz_free(acc);
+      acc = next;
+    }
+    printf("%d %d ", err, bz_eq(got, acc)); printbz(got);
+    bz_free(acc);
+    // the plan may be reused for leaves no longer than those it was made for, and refuses longer ones
+    bz c = bz_imax(-5), d = parse("-1");
+    chain[0].leaf = c;
+    chain[1].leaf = d;
+    err = bl__expr_eval(&got, steps, chain, 4, arena, arenaLen);
+    printf("%d ", err); printbz(got);
+    err = bl__expr_plan(steps, &arenaLen, chain, 4);
+    chain[0].leaf = a;
+    printf("%d ", bl__expr_eval(&got, steps, chain, 4, arena, arenaLen));
+    chain[0].leaf = c;
+    printf("%d\n", bl__expr_eval(&got, steps, chain, 4, arena, arenaLen - 1));
+    bz_free(c); bz_free(d);
+    // malformed expressions
+    bl__exprNode forward[] = { { .op = BL__EXPR_LEAF, .leaf = a }, { .op = BL__EXPR_ADD, .a = 0, .b = 1 } };
+    bl__exprNode badOp[] = { { .op = (bl__exprOp)99 } };
+    bl__exprNode huge[] = { { .op = BL__EXPR_LEAF, .leaf = a }, { .op = BL__EXPR_SHL, .a = 0, .amt = SIZE_MAX } };
+    printf("%d %d %d %d\n",
+      bl__expr_plan(steps, &arenaLen, forward, 0),
+      bl__expr_plan(steps, &arenaLen, forward, 2),
+      bl__expr_plan(steps, &arenaLen, badOp, 1),
+      bl__expr_plan(steps, &arenaLen, huge, 2));
+    // division by zero
+    bl__exprNode divZero[] = { { .op = BL__EXPR_LEAF, .leaf = a }, { .op = BL__EXPR_LEAF, .leaf = zero }, { .op = BL__EXPR_MOD, .a = 0, .b = 1 } };
+    err = bl__expr_plan(steps, &arenaLen, divZero, 3);
+    printf("%d %d\n", err, bl__expr_eval(&got, steps, divZero, 3, arena, arenaLen));
+    bz_free(zero);
+    bz_free(a); bz_free(b);
+  }
+
+  printf("=== random expressions ===\n"); {
+    // random DAGs over small leaves, checked against the `bz_` functions node by node
+    size_t nOk = 0, nAll = 0;
+    for (int round = 0; round < 300; ++round) {
+      bl_expr* e = bl_exprNew();
+      bz want[24];
+      size_t n = 0;
+      for (; n < 4; ++n) {
+        uint64_t r = next();
+        bz leaf = bz_imax((intmax_t)(r >> 2) >> (r % 48));
+        if (r & 1) {
+          bz wide = bz_mul(leaf, leaf);
+          bz_free(leaf);
+          leaf = wide;
+        }
+        want[n] = leaf;
+        bl_exprLeaf(e, leaf);
+      }
+      for (; n < 24; ++n) {
+        uint64_t r = next();
+        size_t a = (r >> 8) % n, b = (r >> 24) % n;
+        switch (r % 11) {
+          case 0: bl_exprNeg(e, a); want[n] = bz_neg(want[a]); break;
+          case 1: bl_exprNot(e, a); want[n] = bz_not(want[a]); break;
+          case 2: bl_exprAdd(e, a, b); want[n] = bz_add(want[a], want[b]); break;
+          case 3: bl_exprSub(e, a, b); want[n] = bz_sub(want[a], want[b]); break;
+          case 4:
+          case 5: bl_exprMul(e, a, b); want[n] = bz_mul(want[a], want[b]); break;
+          case 6: {
+            if (want[b].magnitude->len == 0) { bl_exprShr(e, a, 3); want[n] = bz_shr(want[a], 3); break; }
+            if (r & (1 << 16)) { bl_exprDiv(e, a, b); want[n] = bz_div(want[a], want[b]); }
+            else { bl_exprMod(e, a, b); want[n] = bz_mod(want[a], want[b]); }
+          } break;
+          case 7: bl_exprShl(e, a, (r >> 40) % 70); want[n] = bz_shl(want[a], (r >> 40) % 70); break;
+          case 8: bl_exprShr(e, a, (r >> 40) % 70); want[n] = bz_shr(want[a], (r >> 40) % 70); break;
+          case 9: bl_exprAnd(e, a, b); want[n] = bz_and(want[a], want[b]); break;
+          default: bl_exprXor(e, a, b); want[n] = bz_xor(want[a], want[b]); break;
+        }
+        // `bz_neg` leaves the sign of zero as it finds it, where the evaluator clears it
+        if (want[n].magnitude->len == 0) { want[n].isNeg = false; }
+      }
+      for (size_t root = 0; root < n; ++root) {
+        bz got = bl_exprEval(e, root);
+        nOk += bz_eq(got, want[root]) && !(got.isNeg && got.magnitude->len == 0);
+        nAll += 1;
+        bz_free(got);
+      }
+      for (size_t i = 0; i < n; ++i) { bz_free(want[i]); }
+      bl_exprFree(e);
+    }
+    printf("%zu/%zu\n", nOk, nAll);
+  }
+
+  return 0;
+}
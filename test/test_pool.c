@@ -0,0 +1,84 @@
+#include <assert.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "basic/pool.h"
+
+void printbn(const bn_* src) {
+  if (src->len == 0) {
+    printf("0\n");
+  }
+  else {
+    for (size_t i = src->len; i > 0; --i) {
+      printf("%02X", src->base256le[i-1]);
+    }
+    printf("\n");
+  }
+}
+
+void printbz(bz src) {
+  if (src.isNeg) { printf("-"); }
+  printbn(src.magnitude);
+}
+
+int main() {
+  const char* path = "test/actual_pool.bin";
+
+  printf("=== bl_poolWrite ===\n"); {
+    bz entries[5];
+    entries[0] = bz_imax(0);
+    entries[1] = bz_imax(0xdeadbeef);
+    entries[2] = bz_imax(-0x137);
+    entries[3] = bz_imax(INTMAX_MIN);
+    // an unnormalized magnitude is stored normalized
+    bn_buffer* buf = bn_new(16, NULL);
+    bn_writeByte(buf, 0, 0x42);
+    entries[4].isNeg = false; entries[4].magnitude = buf;
+    bool ok = bl_poolWrite(path, entries, 5);
+    printf("%d\n", ok);
+    for (size_t i = 0; i < 4; ++i) { bz_free(entries[i]); }
+    free(buf);
+  }
+
+  printf("=== bl_poolOpen ===\n"); {
+    bl_pool* pool = bl_poolOpen(path);
+    assert(pool != NULL);
+    printf("%zu\n", bl_poolCount(pool));
+    for (size_t i = 0; i < bl_poolCount(pool); ++i) {
+      bz x = bl_poolBz(pool, i);
+      printf("%zu ", x.magnitude->len); printbz(x);
+    }
+    assert(bl_poolBn(pool, 5) == NULL);
+    assert(bl_poolBz(pool, 5).magnitude == NULL);
+    bz sum = bz_add(bl_poolBz(pool, 1), bl_poolBz(pool, 2)); printbz(sum); bz_free(sum);
+    bl_poolClose(pool);
+  }
+
+  printf("=== bl_poolWrite (over an open pool) ===\n"); {
+    // the open pool keeps reading the file it opened, and a later open sees the new one
+    bl_pool* pool = bl_poolOpen(path);
+    assert(pool != NULL);
+    bz entry = bz_imax(7);
+    printf("%d\n", bl_poolWrite(path, &entry, 1));
+    bz_free(entry);
+    printf("%zu ", bl_poolCount(pool)); printbz(bl_poolBz(pool, 3));
+    bl_poolClose(pool);
+    pool = bl_poolOpen(path);
+    assert(pool != NULL);
+    printf("%zu ", bl_poolCount(pool)); printbz(bl_poolBz(pool, 0));
+    bl_poolClose(pool);
+  }
+
+  printf("=== bl_poolOpen (rejects) ===\n"); {
+    printf("%d ", bl_poolOpen("test/does-not-exist.bin") == NULL);
+    FILE* fp = fopen(path, "wb");
+    assert(fp != NULL);
+    fputs("not a pool, but long enough to have a header", fp);
+    fclose(fp);
+    printf("%d\n", bl_poolOpen(path) == NULL);
+  }
+
+  remove(path);
+  return 0;
+}
@@ -0,0 +1,94 @@
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "basic/batch.h"
+#include "basic/bz.h"
+#include "stats.h"
+
+// This test only runs in the instrumentation build (`BL_STATS=1 ./BUILD.sh`).
+
+static bl_stat stats[256];
+static size_t nStats;
+
+static void snapshot(void) {
+  nStats = bl_statsSnapshot(stats, sizeof(stats) / sizeof(stats[0]));
+  assert(nStats <= sizeof(stats) / sizeof(stats[0]));
+}
+
+// Print the counters of `name` that do not depend on the clock.
+static void printStat(const char* name) {
+  for (size_t i = 0; i < nStats; ++i) {
+    if (strcmp(stats[i].name, name) != 0) { continue; }
+    printf("%s: %llu calls, %llu digits, %llu allocs, %llu bytes\n", name,
+      (unsigned long long)stats[i].calls, (unsigned long long)stats[i].inputDigits,
+      (unsigned long long)stats[i].allocs, (unsigned long long)stats[i].allocBytes);
+    return;
+  }
+  printf("%s: never called\n", name);
+}
+
+int main() {
+  printf("=== counters ===\n"); {
+    bn* a = bn_umax(1000);
+    bn* b = bn_umax(70000);
+    bl_statsReset();
+    bn* c = bn_add(a, b);
+    bn* d = bn_mul(c, c);
+    bn_free(c); bn_free(d);
+    snapshot();
+    printStat("bn_add");
+    printStat("bn__add");
+    printStat("bn_mul");
+    printStat("bn__karatsuba");
+    printStat("bn_free");
+    printStat("bn_sub");
+    bn_free(a); bn_free(b);
+  }
+
+  printf("=== allocations count towards every caller ===\n"); {
+    bz x = bz_imax(-5);
+    bz y = bz_imax(300);
+    bl_statsReset();
+    bz z = bz_and(x, y);
+    snapshot();
+    printStat("bz_and");
+    printStat("bn_new");
+    printStat("bz__and");
+    bz_free(x); bz_free(y); bz_free(z);
+  }
+
+  printf("=== parsing counts characters ===\n"); {
+    bl_statsReset();
+    bn* x = bn_parse("123456789012345678901234567890", 30, 10);
+    snapshot();
+    printStat("bn_parse");
+    printStat("bn__parse");
+    bn_free(x);
+  }
+
+  printf("=== batches count every lane ===\n"); {
+    bn* a = bn_umax(1000);
+    bn* b = bn_umax(70000);
+    const bn* xs[] = { a, b, a };
+    const bn* ys[] = { b, b, a };
+    bn* sums[3];
+    bl_statsReset();
+    bn_batchAdd(sums, xs, ys, 3);
+    snapshot();
+    printStat("bn_batchAdd");
+    printStat("bn__batch_add");
+    printStat("bn__sizeof_batch_add");
+    bn_batchFree(sums, 3);
+    bn_free(a); bn_free(b);
+  }
+
+  printf("=== bl_statsReset ===\n"); {
+    bl_statsReset();
+    snapshot();
+    printStat("bn_parse");
+    for (size_t i = 0; i < nStats; ++i) { assert(stats[i].calls == 0 && stats[i].ns == 0 && stats[i].allocs == 0); }
+  }
+
+  return 0;
+}
@@ -0,0 +1,120 @@
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <pthread.h>
+
+#include "basic/workers.h"
+
+// Return a pseudo-random number of exactly `nBytes` bytes, built from its LEB128 encoding.
+bn* randomBn(size_t nBytes, uint64_t* seed) {
+  if (nBytes == 0) { return bn_umax(0); }
+  size_t nBits = 8 * nBytes;
+  size_t len = (nBits + 6) / 7;
+  uint8_t* buf = malloc(len);
+  for (size_t i = 0; i < len; ++i) {
+    *seed = *seed * UINT64_C(6364136223846793005) + UINT64_C(1442695040888963407);
+    buf[i] = (*seed >> 57) | 0x80;
+  }
+  // keep the top bit set, so the length is exact
+  size_t topBits = nBits - 7 * (len - 1);
+  buf[len - 1] = (buf[len - 1] & ((1 << topBits) - 1)) | (1 << (topBits - 1));
+  bn* out = bn_fromLeb128(buf, len, NULL);
+  free(buf);
+  return out;
+}
+
+// Print the number of bytes and the first and last bytes of `src`.
+void summarize(const bn* src) {
+  size_t n = bn_nBytes(src);
+  printf("%zu bytes", n);
+  if (n != 0) { printf(", %02X…%02X", bn_byte(src, n - 1), bn_byte(src, 0)); }
+  printf("\n");
+}
+
+// Leave small blocks on the thread's freelists, which are released when it exits (as a leak checker confirms).
+void* useFreelists(void* arg) {
+  bn* x = bn_umax(1000);
+  bn* sum = NULL;
+  for (int i = 0; i < 100; ++i) {
+    bn* y = bn_add(x, x);
+    bn_free(sum);
+    sum = y;
+  }
+  bn_free(sum);
+  bn_free(x);
+  return arg;
+}
+
+int main() {
+  uint64_t seed = 1;
+  bl_workers* workers = bl_workersNew(4);
+  bl_workers* none = bl_workersNew(0);
+
+  // schoolbook, both sides of the Karatsuba threshold, unbalanced, and big enough to be forked
+  size_t sizes[][2] = {
+    {0, 100}, {8, 8}, {248, 248}, {256, 256}, {264, 264}, {800, 800},
+    {8000, 296}, {5000, 12345}, {16384, 16384},
+  };
+  for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+    printf("=== mul %zu×%zu bytes ===\n", sizes[i][0], sizes[i][1]);
+    bn* a = randomBn(sizes[i][0], &seed);
+    bn* b = randomBn(sizes[i][1], &seed);
+    bn* serial = bn_mul(a, b);
+    // truncated multiplication keeps its own schoolbook loop, so it serves as a reference
+    bn* reference = bn_mulWrap(a, b, 8 * (sizes[i][0] + sizes[i][1]));
+    bn* parallel = bn_mulParallel(a, b, workers);
+    bn* inline_ = bn_mulParallel(b, a, none);
+    printf("serial = reference: %d\n", bn_eq(serial, reference));
+    printf("parallel = serial: %d\n", bn_eq(parallel, serial));
+    printf("no workers = serial: %d\n", bn_eq(inline_, serial));
+    summarize(serial);
+    bn_free(a); bn_free(b); bn_free(serial); bn_free(reference); bn_free(parallel); bn_free(inline_);
+  }
+
+  printf("=== squaring ===\n");
+  {
+    bn* x = randomBn(40000, &seed);
+    bn* serial = bn_mul(x, x);
+    bn* parallel = bn_mulParallel(x, x, workers);
+    printf("parallel = serial: %d\n", bn_eq(parallel, serial));
+    summarize(serial);
+    bn_free(x); bn_free(serial); bn_free(parallel);
+  }
+
+  printf("=== radix conversion ===\n");
+  {
+    bn* x = randomBn(40000, &seed);
+    size_t len = bn_sizeofFormat(x, 10);
+    char* serial = malloc(len);
+    char* parallel = malloc(len);
+    size_t n = bn_format(serial, len, x, 10);
+    size_t m = bn_formatParallel(parallel, len, x, 10, workers);
+    printf("%zu digits: %.20s…%.20s\n", n, serial, &serial[n - 20]);
+    printf("parallel = serial: %d\n", m == n && memcmp(serial, parallel, n) == 0);
+    bn* y = bn_parseParallel(serial, n, 10, workers);
+    printf("parsed = original: %d\n", bn_eq(x, y));
+    serial[n / 3] = '/';
+    assert(bn_parseParallel(serial, n, 10, workers) == NULL);
+    // zero results are the shared zero rather than blocks of their own
+    bn* zero = bn_umax(0);
+    bn* parsedZero = bn_parseParallel("0000000000", 10, 10, workers);
+    bn* product = bn_mulParallel(x, zero, workers);
+    printf("shared zero %d %d\n", parsedZero == zero, product == zero);
+    bn_free(zero); bn_free(parsedZero); bn_free(product);
+    bn_free(x); bn_free(y); free(serial); free(parallel);
+  }
+
+  printf("=== freelists at thread exit ===\n");
+  {
+    pthread_t threads[4];
+    for (int i = 0; i < 4; ++i) { assert(pthread_create(&threads[i], NULL, useFreelists, NULL) == 0); }
+    for (int i = 0; i < 4; ++i) { assert(pthread_join(threads[i], NULL) == 0); }
+    printf("joined\n");
+  }
+
+  bl_workersFree(none);
+  bl_workersFree(workers);
+  return 0;
+}